@@ -165,6 +165,48 @@ void Buffer::addProperty (const Property &property)
     addProperty (property.name(), property.dataType());
 }
 
+ColumnHandle Buffer::column (const Property &property)
+{
+    const std::string& id = property.name();
+
+    switch (property.dataType())
+    {
+    case PropertyDataType::BOOL:
+        return ColumnHandle (property.dataType(), getArrayListMap<bool>().at(id).get());
+    case PropertyDataType::CHAR:
+        return ColumnHandle (property.dataType(), getArrayListMap<char>().at(id).get());
+    case PropertyDataType::UCHAR:
+        return ColumnHandle (property.dataType(), getArrayListMap<unsigned char>().at(id).get());
+    case PropertyDataType::INT:
+        return ColumnHandle (property.dataType(), getArrayListMap<int>().at(id).get());
+    case PropertyDataType::UINT:
+        return ColumnHandle (property.dataType(), getArrayListMap<unsigned int>().at(id).get());
+    case PropertyDataType::LONGINT:
+        return ColumnHandle (property.dataType(), getArrayListMap<long int>().at(id).get());
+    case PropertyDataType::ULONGINT:
+        return ColumnHandle (property.dataType(), getArrayListMap<unsigned long int>().at(id).get());
+    case PropertyDataType::FLOAT:
+        return ColumnHandle (property.dataType(), getArrayListMap<float>().at(id).get());
+    case PropertyDataType::DOUBLE:
+        return ColumnHandle (property.dataType(), getArrayListMap<double>().at(id).get());
+    case PropertyDataType::STRING:
+        return ColumnHandle (property.dataType(), getArrayListMap<std::string>().at(id).get());
+    default:
+        logerr  <<  "Buffer: column: unknown property type " << Property::asString(property.dataType());
+        throw std::runtime_error ("Buffer: column: unknown property type "+Property::asString(property.dataType()));
+    }
+}
+
+std::vector<ColumnHandle> Buffer::columns ()
+{
+    std::vector<ColumnHandle> handles;
+
+    for (unsigned int cnt=0; cnt < properties_.size(); ++cnt)
+        handles.push_back(column(properties_.at(cnt)));
+
+    return handles;
+}
+
 void Buffer::seizeBuffer (Buffer &org_buffer)
 {
     logdbg  << "Buffer: seizeBuffer: start";
@@ -192,6 +234,32 @@ void Buffer::seizeBuffer (Buffer &org_buffer)
     logdbg  << "Buffer: seizeBuffer: end size " << size();
 }
 
+std::shared_ptr<Buffer> Buffer::select (const ValidityBitmap& selection)
+{
+    logdbg  << "Buffer: select: size " << size() << " selected " << selection.size() - selection.nullCount();
+
+    assert (selection.size() == data_size_);
+
+    std::shared_ptr<Buffer> selected_buffer {new Buffer (properties_, dbo_name_)};
+
+    selectArrayListMap<bool>(*selected_buffer, selection);
+    selectArrayListMap<char>(*selected_buffer, selection);
+    selectArrayListMap<unsigned char>(*selected_buffer, selection);
+    selectArrayListMap<int>(*selected_buffer, selection);
+    selectArrayListMap<unsigned int>(*selected_buffer, selection);
+    selectArrayListMap<long int>(*selected_buffer, selection);
+    selectArrayListMap<unsigned long int>(*selected_buffer, selection);
+    selectArrayListMap<float>(*selected_buffer, selection);
+    selectArrayListMap<double>(*selected_buffer, selection);
+    selectArrayListMap<std::string>(*selected_buffer, selection);
+
+    // selected rows beyond the end of all columns are null
+    selected_buffer->data_size_ = selection.size() - selection.nullCount();
+    selected_buffer->last_one_ = last_one_;
+
+    return selected_buffer;
+}
+
 const size_t Buffer::size ()
 {
     return data_size_;
@@ -223,6 +291,32 @@ void Buffer::cutToSize (size_t size)
     data_size_ = size;
 }
 
+void Buffer::reserve (size_t size)
+{
+    logdbg << "Buffer: reserve: size " << size;
+
+    for (auto& it : getArrayListMap<bool>())
+        it.second->reserve(size);
+    for (auto& it : getArrayListMap<char>())
+        it.second->reserve(size);
+    for (auto& it : getArrayListMap<unsigned char>())
+        it.second->reserve(size);
+    for (auto& it : getArrayListMap<int>())
+        it.second->reserve(size);
+    for (auto& it : getArrayListMap<unsigned int>())
+        it.second->reserve(size);
+    for (auto& it : getArrayListMap<long int>())
+        it.second->reserve(size);
+    for (auto& it : getArrayListMap<unsigned long int>())
+        it.second->reserve(size);
+    for (auto& it : getArrayListMap<float>())
+        it.second->reserve(size);
+    for (auto& it : getArrayListMap<double>())
+        it.second->reserve(size);
+    for (auto& it : getArrayListMap<std::string>())
+        it.second->reserve(size);
+}
+
 const PropertyList& Buffer::properties ()
 {
     return properties_;
@@ -560,60 +654,90 @@ void Buffer::transformVariables (DBOVariableSet& list, bool tc2dbovar)
     }
 }
 
-std::shared_ptr<Buffer> Buffer::getPartialCopy (const PropertyList& partial_properties)
+bool ColumnHandle::isNull (size_t index) const
 {
-    std::shared_ptr<Buffer> tmp_buffer {new Buffer()};
-
-    for (unsigned int cnt=0; cnt < partial_properties.size(); ++cnt)
+    switch (data_type_)
     {
-        Property prop = partial_properties.at(cnt);
-
-        logdbg << "Buffer: getPartialCopy: adding property " << prop.name();
-        tmp_buffer->addProperty(prop);
-
-        switch (prop.dataType())
-        {
-        case PropertyDataType::BOOL:
-            tmp_buffer->get<bool>(prop.name()).copyData(get<bool>(prop.name()));
-            break;
-        case PropertyDataType::CHAR:
-            tmp_buffer->get<char>(prop.name()).copyData(get<char>(prop.name()));
-            break;
-        case PropertyDataType::UCHAR:
-            tmp_buffer->get<unsigned char>(prop.name()).copyData(get<unsigned char>(prop.name()));
-            break;
-        case PropertyDataType::INT:
-            tmp_buffer->get<int>(prop.name()).copyData(get<int>(prop.name()));
-            break;
-        case PropertyDataType::UINT:
-            tmp_buffer->get<unsigned int>(prop.name()).copyData(get<unsigned int>(prop.name()));
-            break;
-        case PropertyDataType::LONGINT:
-            tmp_buffer->get<long int>(prop.name()).copyData(get<long int>(prop.name()));
-            break;
-        case PropertyDataType::ULONGINT:
-            tmp_buffer->get<unsigned long int>(prop.name()).copyData(get<unsigned long int>(prop.name()));
-            break;
-        case PropertyDataType::FLOAT:
-            tmp_buffer->get<float>(prop.name()).copyData(get<float>(prop.name()));
-            break;
-        case PropertyDataType::DOUBLE:
-            tmp_buffer->get<double>(prop.name()).copyData(get<double>(prop.name()));
-            break;
-        case PropertyDataType::STRING:
-            tmp_buffer->get<std::string>(prop.name()).copyData(get<std::string>(prop.name()));
-            break;
-        default:
-            logerr  <<  "Buffer: getPartialCopy: unknown property type "
-                     << Property::asString(prop.dataType());
-            throw std::runtime_error ("Buffer: getPartialCopy: unknown property type "
-                                      + Property::asString(prop.dataType()));
-        }
+    case PropertyDataType::BOOL:
+        return get<bool>().isNull(index);
+    case PropertyDataType::CHAR:
+        return get<char>().isNull(index);
+    case PropertyDataType::UCHAR:
+        return get<unsigned char>().isNull(index);
+    case PropertyDataType::INT:
+        return get<int>().isNull(index);
+    case PropertyDataType::UINT:
+        return get<unsigned int>().isNull(index);
+    case PropertyDataType::LONGINT:
+        return get<long int>().isNull(index);
+    case PropertyDataType::ULONGINT:
+        return get<unsigned long int>().isNull(index);
+    case PropertyDataType::FLOAT:
+        return get<float>().isNull(index);
+    case PropertyDataType::DOUBLE:
+        return get<double>().isNull(index);
+    case PropertyDataType::STRING:
+        return get<std::string>().isNull(index);
+    default:
+        throw std::runtime_error ("ColumnHandle: isNull: unknown property type "+Property::asString(data_type_));
     }
-
-    return tmp_buffer;
 }
 
+const std::string ColumnHandle::getAsString (size_t index) const
+{
+    switch (data_type_)
+    {
+    case PropertyDataType::BOOL:
+        return get<bool>().getAsString(index);
+    case PropertyDataType::CHAR:
+        return get<char>().getAsString(index);
+    case PropertyDataType::UCHAR:
+        return get<unsigned char>().getAsString(index);
+    case PropertyDataType::INT:
+        return get<int>().getAsString(index);
+    case PropertyDataType::UINT:
+        return get<unsigned int>().getAsString(index);
+    case PropertyDataType::LONGINT:
+        return get<long int>().getAsString(index);
+    case PropertyDataType::ULONGINT:
+        return get<unsigned long int>().getAsString(index);
+    case PropertyDataType::FLOAT:
+        return get<float>().getAsString(index);
+    case PropertyDataType::DOUBLE:
+        return get<double>().getAsString(index);
+    case PropertyDataType::STRING:
+        return get<std::string>().getAsString(index);
+    default:
+        throw std::runtime_error ("ColumnHandle: getAsString: unknown property type "
+                                  +Property::asString(data_type_));
+    }
+}
 
-
-
+size_t ColumnHandle::size () const
+{
+    switch (data_type_)
+    {
+    case PropertyDataType::BOOL:
+        return get<bool>().size();
+    case PropertyDataType::CHAR:
+        return get<char>().size();
+    case PropertyDataType::UCHAR:
+        return get<unsigned char>().size();
+    case PropertyDataType::INT:
+        return get<int>().size();
+    case PropertyDataType::UINT:
+        return get<unsigned int>().size();
+    case PropertyDataType::LONGINT:
+        return get<long int>().size();
+    case PropertyDataType::ULONGINT:
+        return get<unsigned long int>().size();
+    case PropertyDataType::FLOAT:
+        return get<float>().size();
+    case PropertyDataType::DOUBLE:
+        return get<double>().size();
+    case PropertyDataType::STRING:
+        return get<std::string>().size();
+    default:
+        throw std::runtime_error ("ColumnHandle: size: unknown property type "+Property::asString(data_type_));
+    }
+}
@@ -26,6 +26,8 @@
 #include "propertylist.h"
 
 class DBOVariableSet;
+class ColumnHandle;
+class ValidityBitmap;
 
 template <class T> class NullableVector;
 
@@ -74,6 +76,8 @@ public:
 
     /// @brief Adds all containers of org_buffer and removes them from org_buffer.
     void seizeBuffer (Buffer &org_buffer);
+    /// @brief Returns new buffer with same properties holding the rows set in selection, of size of this buffer.
+    std::shared_ptr<Buffer> select (const ValidityBitmap& selection);
 
     /// @brief Adds an additional property.
     void addProperty (std::string id, PropertyDataType type);
@@ -93,12 +97,20 @@ public:
     template<typename T> bool has (const std::string &id);
 
     template<typename T> NullableVector<T>& get (const std::string &id);
+    template<typename T> NullableVector<T>& get (const Property &property);
+
+    /// @brief Returns handle to column of property, to be resolved once outside of row loops
+    ColumnHandle column (const Property &property);
+    /// @brief Returns handles to all columns, in order of properties()
+    std::vector<ColumnHandle> columns ();
 
     template<typename T> void rename (const std::string &id, const std::string &id_new);
 
     /// @brief  Returns current size
     const size_t size ();
     void cutToSize (size_t size);
+    /// @brief Reserves container space for the given number of rows, as hint for subsequent appends
+    void reserve (size_t size);
 
     /// @brief Returns PropertyList
     const PropertyList& properties ();
@@ -113,8 +125,6 @@ public:
 
     void transformVariables (DBOVariableSet& list, bool tc2dbovar); // tc2dbovar true for db->dbo, false dbo->db
 
-    std::shared_ptr<Buffer> getPartialCopy (const PropertyList& partial_properties);
-
 protected:
     /// Unique buffer id, copied when getting shallow copies
     unsigned int id_;
@@ -135,10 +145,50 @@ private:
     template<typename T> inline std::map <std::string, std::shared_ptr<NullableVector<T>>>& getArrayListMap ();
     template<typename T> void renameArrayListMapEntry (const std::string &id, const std::string &id_new);
     template<typename T> void seizeArrayListMap (Buffer &org_buffer);
+    template<typename T> void selectArrayListMap (Buffer &selected_buffer, const ValidityBitmap& selection);
 };
 
 #include "nullablevector.h"
 
+/**
+ * @brief Handle to a Buffer column of any data type, resolved once from a Property.
+ *
+ * Avoids the lookup by name for every row. Typed access is given by get<T>, which has to match the data type.
+ * Stays valid as long as the column exists in the Buffer, i.e. until it is seized into another Buffer.
+ */
+class ColumnHandle
+{
+    friend class Buffer;
+
+public:
+    /// @brief Default constructor, creates invalid handle
+    ColumnHandle () {}
+
+    /// @brief Returns flag indicating if handle references a column
+    bool valid () const { return column_ != nullptr; }
+    PropertyDataType dataType () const { return data_type_; }
+
+    /// @brief Returns typed column, T has to match the data type
+    template<typename T> NullableVector<T>& get () const
+    {
+        assert (column_);
+        assert (PropertyDataTypeOf<T>::value == data_type_);
+        return *static_cast<NullableVector<T>*> (column_);
+    }
+
+    bool isNull (size_t index) const;
+    const std::string getAsString (size_t index) const;
+    /// @brief Returns size of the column, which can be smaller than the Buffer size
+    size_t size () const;
+
+protected:
+    PropertyDataType data_type_ {PropertyDataType::BOOL};
+    void* column_ {nullptr};
+
+    /// @brief Constructor, only for friend Buffer
+    ColumnHandle (PropertyDataType data_type, void* column) : data_type_(data_type), column_(column) {}
+};
+
 template<typename T> inline bool Buffer::has (const std::string &id)
 {
     return getArrayListMap<T>().count(id) != 0;
@@ -150,6 +200,11 @@ template<typename T> NullableVector<T>& Buffer::get (const std::string &id)
             ArrayListMapTupel>::value > (array_list_tuple_)).at(id);
 }
 
+template<typename T> NullableVector<T>& Buffer::get (const Property &property)
+{
+    return get<T>(property.name());
+}
+
 template<typename T> void Buffer::rename (const std::string &id, const std::string &id_new)
 {
     renameArrayListMapEntry<T>(id, id_new);
@@ -167,6 +222,7 @@ template<typename T> std::map <std::string, std::shared_ptr<NullableVector<T>>>&
     return std::get< Index<std::map <std::string, std::shared_ptr<NullableVector<T>>>,
             ArrayListMapTupel>::value > (array_list_tuple_);
 }
+
 template<typename T> void Buffer::renameArrayListMapEntry (const std::string &id, const std::string &id_new)
 {
     assert (getArrayListMap<T>().count(id) == 1);
@@ -186,4 +242,10 @@ template<typename T> void Buffer::seizeArrayListMap (Buffer &org_buffer)
     org_buffer.getArrayListMap<T>().clear();
 }
 
+template<typename T> void Buffer::selectArrayListMap (Buffer &selected_buffer, const ValidityBitmap& selection)
+{
+    for (auto& it : getArrayListMap<T>())
+        selected_buffer.getArrayListMap<T>().at(it.first)->addSelectedData(*it.second, selection);
+}
+
 #endif /* BUFFER_H_ */
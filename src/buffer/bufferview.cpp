@@ -0,0 +1,77 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "bufferview.h"
+#include "logger.h"
+
+const size_t BufferView::NO_SIZE;
+
+BufferView::BufferView (std::shared_ptr<Buffer> buffer)
+    : buffer_(buffer), properties_(buffer->properties()), columns_(buffer->columns()), size_(buffer->size())
+{
+}
+
+BufferView::BufferView (std::shared_ptr<Buffer> buffer, const PropertyList& properties, size_t from_index,
+                        size_t size)
+    : buffer_(buffer), properties_(properties), from_index_(from_index)
+{
+    assert (buffer_);
+    assert (from_index_ <= buffer_->size());
+
+    size_t max_size = 0;
+
+    for (unsigned int cnt=0; cnt < properties_.size(); ++cnt)
+    {
+        const Property& prop = properties_.at(cnt);
+
+        if (!buffer_->properties().hasProperty(prop.name()))
+            throw std::runtime_error ("BufferView: constructor: property "+prop.name()+" not in buffer");
+
+        columns_.push_back(buffer_->column(prop));
+        max_size = std::max (max_size, columns_.back().size());
+    }
+
+    if (size == NO_SIZE)
+        size_ = max_size > from_index_ ? max_size-from_index_ : 0;
+    else
+    {
+        assert (from_index_+size <= buffer_->size());
+        size_ = size;
+    }
+
+    logdbg << "BufferView: constructor: " << properties_.size() << " properties, from " << from_index_
+           << " size " << size_;
+}
+
+BufferView BufferView::partial (const PropertyList& properties) const
+{
+    return BufferView (buffer_, properties, from_index_, size_);
+}
+
+BufferView BufferView::rows (size_t from_index, size_t size) const
+{
+    assert (from_index >= from_index_);
+    assert (from_index+size <= endIndex());
+
+    BufferView view {*this};
+    view.from_index_ = from_index;
+    view.size_ = size;
+
+    return view;
+}
@@ -0,0 +1,79 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BUFFERVIEW_H_
+#define BUFFERVIEW_H_
+
+#include <memory>
+#include <vector>
+
+#include "buffer.h"
+
+/**
+ * @brief Zero-copy view on a subset of columns and a row range of a Buffer
+ *
+ * Shares ownership of the referenced Buffer, so it stays valid as long as the view exists. Row indexes used with
+ * the column handles are indexes of the referenced Buffer, i.e. from fromIndex() to endIndex() exclusive.
+ * Not to be used while the Buffer is seized into another one.
+ */
+class BufferView
+{
+public:
+    /// @brief Default constructor, creates empty view
+    BufferView () {}
+    /// @brief Constructor, view on all columns and rows of buffer
+    BufferView (std::shared_ptr<Buffer> buffer);
+    /**
+     * @brief Constructor, view on subset of columns and rows of buffer
+     *
+     * If size is not given, it is set to the maximum size of the selected columns, starting from from_index.
+     */
+    BufferView (std::shared_ptr<Buffer> buffer, const PropertyList& properties, size_t from_index=0,
+                size_t size=NO_SIZE);
+
+    static const size_t NO_SIZE = static_cast<size_t>(-1);
+
+    /// @brief Returns view on a subset of the columns of this view, with the same rows
+    BufferView partial (const PropertyList& properties) const;
+    /// @brief Returns view on a row range within this view, from_index in the referenced Buffer
+    BufferView rows (size_t from_index, size_t size) const;
+
+    std::shared_ptr<Buffer> buffer () const { return buffer_; }
+    const PropertyList& properties () const { return properties_; }
+    /// @brief Returns column handles, in order of properties()
+    const std::vector<ColumnHandle>& columns () const { return columns_; }
+    bool hasProperty (const std::string& id) const { return properties_.hasProperty(id); }
+    /// @brief Returns column handle of property
+    const ColumnHandle& column (const std::string& id) const { return columns_.at(properties_.getPropertyIndex(id)); }
+
+    /// @brief Returns first row index in referenced Buffer
+    size_t fromIndex () const { return from_index_; }
+    /// @brief Returns row index after last row in referenced Buffer
+    size_t endIndex () const { return from_index_+size_; }
+    /// @brief Returns number of rows
+    size_t size () const { return size_; }
+
+protected:
+    std::shared_ptr<Buffer> buffer_;
+    PropertyList properties_;
+    std::vector<ColumnHandle> columns_;
+
+    size_t from_index_ {0};
+    size_t size_ {0};
+};
+
+#endif /* BUFFERVIEW_H_ */
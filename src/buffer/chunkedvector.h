@@ -0,0 +1,284 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHUNKEDVECTOR_H_
+#define CHUNKEDVECTOR_H_
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+#include <cassert>
+
+/// Number of elements per segment as power of 2
+const size_t CHUNKED_VECTOR_SEGMENT_SHIFT=14;
+const size_t CHUNKED_VECTOR_SEGMENT_SIZE=size_t(1) << CHUNKED_VECTOR_SEGMENT_SHIFT;
+/// Maximum number of unused segments kept per data type
+const size_t CHUNKED_VECTOR_MAX_POOLED_SEGMENTS=64;
+
+/**
+ * @brief Thread-safe pool of unused segments for ChunkedVector
+ *
+ * Segments are kept with their capacity, so re-use does not require allocation. One pool exists per data type,
+ * which is never deleted to allow segment release during static destruction.
+ */
+template <class T>
+class SegmentPool
+{
+public:
+    typedef std::vector<T> Segment;
+
+    /// @brief Returns static instance
+    static SegmentPool<T>& instance()
+    {
+        static SegmentPool<T>* instance = new SegmentPool<T>();
+        return *instance;
+    }
+
+    /// @brief Returns empty segment, a pooled one with its capacity or a new one with the given capacity
+    std::unique_ptr<Segment> get (size_t capacity=CHUNKED_VECTOR_SEGMENT_SIZE)
+    {
+        {
+            std::lock_guard<std::mutex> lock (mutex_);
+
+            if (free_segments_.size())
+            {
+                std::unique_ptr<Segment> segment = std::move(free_segments_.back());
+                free_segments_.pop_back();
+                return segment;
+            }
+        }
+
+        assert (capacity <= CHUNKED_VECTOR_SEGMENT_SIZE);
+
+        std::unique_ptr<Segment> segment {new Segment()};
+        segment->reserve(capacity);
+        return segment;
+    }
+
+    /// @brief Clears segment and keeps it for re-use if pool is not full
+    void release (std::unique_ptr<Segment> segment)
+    {
+        segment->clear();
+
+        std::lock_guard<std::mutex> lock (mutex_);
+
+        if (free_segments_.size() < CHUNKED_VECTOR_MAX_POOLED_SEGMENTS)
+            free_segments_.push_back(std::move(segment));
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<Segment>> free_segments_;
+
+    SegmentPool() {}
+    SegmentPool(const SegmentPool&) = delete;
+    void operator=(const SegmentPool&) = delete;
+};
+
+/**
+ * @brief Container of fixed-size segments with constant-time random access
+ *
+ * Growing never moves stored elements, so appends are amortized over one segment instead of the whole container.
+ * All segments except the last one are full. The first segment grows geometrically up to the segment size, so small
+ * containers do not hold a full segment. Appending another ChunkedVector moves its segments if the size is a multiple
+ * of the segment size, otherwise its elements are moved.
+ */
+template <class T>
+class ChunkedVector
+{
+public:
+    typedef std::vector<T> Segment;
+    typedef typename Segment::reference reference;
+    typedef typename Segment::const_reference const_reference;
+
+    /// @brief Constructor
+    ChunkedVector () {}
+    /// @brief Move constructor
+    ChunkedVector (ChunkedVector<T>&& other) : segments_(std::move(other.segments_)), size_(other.size_)
+    {
+        other.size_ = 0;
+    }
+    /// @brief Destructor, releases segments to pool
+    ~ChunkedVector () { clear(); }
+
+    /// @brief Move operator, releases own segments to pool
+    ChunkedVector<T>& operator= (ChunkedVector<T>&& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            segments_ = std::move(other.segments_);
+            size_ = other.size_;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    size_t size () const { return size_; }
+    bool empty () const { return size_ == 0; }
+
+    reference operator[] (size_t index)
+    {
+        assert (index < size_);
+        return (*segments_[index >> CHUNKED_VECTOR_SEGMENT_SHIFT])[index & (CHUNKED_VECTOR_SEGMENT_SIZE-1)];
+    }
+    const_reference operator[] (size_t index) const
+    {
+        assert (index < size_);
+        return (*segments_[index >> CHUNKED_VECTOR_SEGMENT_SHIFT])[index & (CHUNKED_VECTOR_SEGMENT_SIZE-1)];
+    }
+
+    void set (size_t index, const T& value) { (*this)[index] = value; }
+
+    /// @brief Returns number of segments
+    size_t numSegments () const { return segments_.size(); }
+    /// @brief Returns segment, for contiguous access to elements from index*CHUNKED_VECTOR_SEGMENT_SIZE
+    Segment& segment (size_t index) { return *segments_.at(index); }
+    const Segment& segment (size_t index) const { return *segments_.at(index); }
+
+    void push_back (const T& value)
+    {
+        lastSegmentWithSpace().push_back(value);
+        ++size_;
+    }
+
+    void push_back (T&& value)
+    {
+        lastSegmentWithSpace().push_back(std::move(value));
+        ++size_;
+    }
+
+    /// @brief Appends count values
+    void append (const T* values, size_t count)
+    {
+        while (count)
+        {
+            Segment& segment = lastSegmentWithSpace(count);
+            size_t num = std::min (count, CHUNKED_VECTOR_SEGMENT_SIZE-segment.size());
+
+            segment.insert(segment.end(), values, values+num);
+            size_ += num;
+            values += num;
+            count -= num;
+        }
+    }
+
+    /// @brief Appends all elements of other and clears it
+    void append (ChunkedVector<T>&& other)
+    {
+        if (size_ % CHUNKED_VECTOR_SEGMENT_SIZE == 0) // all full, splice segments
+        {
+            segments_.insert(segments_.end(), std::make_move_iterator(other.segments_.begin()),
+                             std::make_move_iterator(other.segments_.end()));
+            size_ += other.size_;
+
+            other.segments_.clear();
+            other.size_ = 0;
+            return;
+        }
+
+        for (auto& segment_it : other.segments_)
+        {
+            for (auto&& value_it : *segment_it)
+                push_back(std::move(value_it));
+        }
+
+        other.clear();
+    }
+
+    /// @brief Resizes to size, new elements are set to value
+    void resize (size_t size, const T& value=T())
+    {
+        while (size_ < size)
+        {
+            Segment& segment = lastSegmentWithSpace(size-size_);
+            size_t num = std::min (size-size_, CHUNKED_VECTOR_SEGMENT_SIZE-segment.size());
+
+            segment.resize(segment.size()+num, value);
+            size_ += num;
+        }
+
+        if (size_ > size)
+        {
+            size_t num_segments = (size + CHUNKED_VECTOR_SEGMENT_SIZE - 1) >> CHUNKED_VECTOR_SEGMENT_SHIFT;
+
+            while (segments_.size() > num_segments)
+            {
+                SegmentPool<T>::instance().release(std::move(segments_.back()));
+                segments_.pop_back();
+            }
+
+            if (num_segments)
+                segments_.back()->resize(size - ((num_segments-1) << CHUNKED_VECTOR_SEGMENT_SHIFT));
+
+            size_ = size;
+        }
+    }
+
+    /// @brief Reserves space in the segment list for size elements
+    void reserve (size_t size)
+    {
+        segments_.reserve((size + CHUNKED_VECTOR_SEGMENT_SIZE - 1) >> CHUNKED_VECTOR_SEGMENT_SHIFT);
+    }
+
+    /// @brief Sets all elements to value
+    void fill (const T& value)
+    {
+        for (auto& segment_it : segments_)
+            std::fill (segment_it->begin(), segment_it->end(), value);
+    }
+
+    /// @brief Removes all elements and releases segments to pool
+    void clear ()
+    {
+        for (auto& segment_it : segments_)
+            SegmentPool<T>::instance().release(std::move(segment_it));
+
+        segments_.clear();
+        size_ = 0;
+    }
+
+private:
+    std::vector<std::unique_ptr<Segment>> segments_;
+    size_t size_ {0};
+
+    ChunkedVector (const ChunkedVector<T>&) = delete;
+    void operator= (const ChunkedVector<T>&) = delete;
+
+    /// @brief Returns last segment, with capacity for count elements or up to the segment size
+    Segment& lastSegmentWithSpace (size_t count=1)
+    {
+        if (!segments_.size()) // first segment only as large as needed
+            segments_.push_back(SegmentPool<T>::instance().get(std::min(count, CHUNKED_VECTOR_SEGMENT_SIZE)));
+        else if (segments_.back()->size() == CHUNKED_VECTOR_SEGMENT_SIZE)
+            segments_.push_back(SegmentPool<T>::instance().get());
+
+        Segment& segment = *segments_.back();
+
+        if (segment.size() + count > segment.capacity() && segment.capacity() < CHUNKED_VECTOR_SEGMENT_SIZE)
+        {
+            // grow geometrically, but not beyond the segment size
+            segment.reserve(std::min(std::max(2*segment.capacity(), segment.size()+count),
+                                     CHUNKED_VECTOR_SEGMENT_SIZE));
+        }
+
+        return segment;
+    }
+};
+
+#endif /* CHUNKEDVECTOR_H_ */
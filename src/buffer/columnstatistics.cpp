@@ -0,0 +1,198 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#include "columnstatistics.h"
+#include "buffer.h"
+#include "nullablevector.h"
+#include "logger.h"
+
+namespace
+{
+/// @brief Returns value as text, floating point numbers with enough digits to be read back exactly
+template <class T> std::string valueString (const T& value)
+{
+    std::ostringstream out;
+    out << std::setprecision(std::numeric_limits<T>::max_digits10) << value; // no effect for integers
+    return out.str();
+}
+
+template <> std::string valueString<bool> (const bool& value)
+{
+    return value ? "1" : "0";
+}
+
+template <> std::string valueString<char> (const char& value)
+{
+    return std::to_string(static_cast<int> (value));
+}
+
+template <> std::string valueString<unsigned char> (const unsigned char& value)
+{
+    return std::to_string(static_cast<unsigned int> (value));
+}
+
+template <> std::string valueString<std::string> (const std::string& value)
+{
+    return value;
+}
+
+/// @brief Returns value parsed from text as written by valueString
+template <class T> T stringValue (const std::string& text)
+{
+    std::istringstream in (text);
+    T value;
+    in >> value;
+
+    if (in.fail())
+        throw std::runtime_error ("ColumnStatistics: stringValue: unable to parse '"+text+"'");
+
+    return value;
+}
+
+template <> bool stringValue<bool> (const std::string& text)
+{
+    return stringValue<int> (text) != 0;
+}
+
+template <> char stringValue<char> (const std::string& text)
+{
+    return static_cast<char> (stringValue<int> (text));
+}
+
+template <> unsigned char stringValue<unsigned char> (const std::string& text)
+{
+    return static_cast<unsigned char> (stringValue<unsigned int> (text));
+}
+
+template <> std::string stringValue<std::string> (const std::string& text)
+{
+    return text;
+}
+}
+
+std::unique_ptr<ColumnStatistics> ColumnStatistics::create (PropertyDataType data_type)
+{
+    switch (data_type)
+    {
+    case PropertyDataType::BOOL:
+        return std::unique_ptr<ColumnStatistics> (new TypedColumnStatistics<bool> ());
+    case PropertyDataType::CHAR:
+        return std::unique_ptr<ColumnStatistics> (new TypedColumnStatistics<char> ());
+    case PropertyDataType::UCHAR:
+        return std::unique_ptr<ColumnStatistics> (new TypedColumnStatistics<unsigned char> ());
+    case PropertyDataType::INT:
+        return std::unique_ptr<ColumnStatistics> (new TypedColumnStatistics<int> ());
+    case PropertyDataType::UINT:
+        return std::unique_ptr<ColumnStatistics> (new TypedColumnStatistics<unsigned int> ());
+    case PropertyDataType::LONGINT:
+        return std::unique_ptr<ColumnStatistics> (new TypedColumnStatistics<long int> ());
+    case PropertyDataType::ULONGINT:
+        return std::unique_ptr<ColumnStatistics> (new TypedColumnStatistics<unsigned long int> ());
+    case PropertyDataType::FLOAT:
+        return std::unique_ptr<ColumnStatistics> (new TypedColumnStatistics<float> ());
+    case PropertyDataType::DOUBLE:
+        return std::unique_ptr<ColumnStatistics> (new TypedColumnStatistics<double> ());
+    case PropertyDataType::STRING:
+        return std::unique_ptr<ColumnStatistics> (new TypedColumnStatistics<std::string> ());
+    default:
+        logerr << "ColumnStatistics: create: unknown property type " << Property::asString(data_type);
+        throw std::runtime_error ("ColumnStatistics: create: unknown property type "
+                                  + Property::asString(data_type));
+    }
+}
+
+std::map<std::string, std::unique_ptr<ColumnStatistics>> ColumnStatistics::create (Buffer& buffer)
+{
+    std::map<std::string, std::unique_ptr<ColumnStatistics>> statistics;
+
+    const PropertyList& properties = buffer.properties();
+
+    for (unsigned int cnt=0; cnt < properties.size(); ++cnt)
+    {
+        const Property& property = properties.at(cnt);
+
+        std::unique_ptr<ColumnStatistics> column_statistics = create (property.dataType());
+        column_statistics->update(buffer.column(property), 0, buffer.size());
+        statistics[property.name()] = std::move(column_statistics);
+    }
+
+    return statistics;
+}
+
+void ColumnStatistics::distinctValues (const ColumnHandle& column, size_t from_index, size_t to_index,
+                                       std::set<int>& values)
+{
+    assert (column.dataType() == PropertyDataType::INT);
+
+    const NullableVector<int>& column_values = column.get<int>();
+    const ChunkedVector<int>& data = column_values.data();
+    const ValidityBitmap& validity = column_values.validity();
+
+    to_index = std::min (data.size(), to_index);
+
+    for (size_t cnt=from_index; cnt < to_index; ++cnt)
+        if (validity.isValid(cnt))
+            values.insert(data[cnt]);
+}
+
+template <class T> void TypedColumnStatistics<T>::update (const ColumnHandle& column, size_t from_index,
+                                                          size_t to_index)
+{
+    assert (from_index <= to_index);
+
+    const NullableVector<T>& values = column.get<T>();
+    const typename NullableVectorStorage<T>::type& data = values.data();
+    const ValidityBitmap& validity = values.validity();
+
+    size_t values_end = std::max (std::min (data.size(), to_index), from_index);
+    null_count_ += to_index - values_end; // rows after the end of the column are null
+
+    bool all_valid = validity.allValid();
+
+    for (size_t cnt=from_index; cnt < values_end; ++cnt)
+    {
+        if (!all_valid && validity.isNull(cnt))
+        {
+            ++null_count_;
+            continue;
+        }
+
+        add (data[cnt]);
+    }
+}
+
+template <class T> void TypedColumnStatistics<T>::merge (const std::string& min, const std::string& max)
+{
+    add (stringValue<T> (min));
+    add (stringValue<T> (max));
+}
+
+template <class T> std::string TypedColumnStatistics<T>::minString () const
+{
+    assert (has_value_);
+    return valueString<T> (min_);
+}
+
+template <class T> std::string TypedColumnStatistics<T>::maxString () const
+{
+    assert (has_value_);
+    return valueString<T> (max_);
+}
@@ -0,0 +1,105 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COLUMNSTATISTICS_H_
+#define COLUMNSTATISTICS_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "property.h"
+
+class Buffer;
+class ColumnHandle;
+
+/**
+ * @brief Minimum, maximum and number of null values of a column
+ *
+ * Computed on the typed values, converted to text only when read, as stored in the minimum/maximum table.
+ */
+class ColumnStatistics
+{
+public:
+    virtual ~ColumnStatistics () {}
+
+    /// @brief Adds rows from_index to to_index (exclusive) of column
+    virtual void update (const ColumnHandle& column, size_t from_index, size_t to_index)=0;
+    /// @brief Adds minimum and maximum given as text, e.g. from the minimum/maximum table
+    virtual void merge (const std::string& min, const std::string& max)=0;
+    void addNullCount (size_t null_count) { null_count_ += null_count; }
+
+    /// @brief Returns flag indicating if a non-null value was found
+    bool hasValue () const { return has_value_; }
+    size_t nullCount () const { return null_count_; }
+
+    /// @brief Returns minimum as text, only valid if hasValue
+    virtual std::string minString () const=0;
+    /// @brief Returns maximum as text, only valid if hasValue
+    virtual std::string maxString () const=0;
+
+    /// @brief Returns new empty statistics for values of data_type
+    static std::unique_ptr<ColumnStatistics> create (PropertyDataType data_type);
+    /// @brief Returns statistics of all columns of buffer, by property name
+    static std::map<std::string, std::unique_ptr<ColumnStatistics>> create (Buffer& buffer);
+    /// @brief Adds non-null values of rows from_index to to_index (exclusive) of integer column to values
+    static void distinctValues (const ColumnHandle& column, size_t from_index, size_t to_index,
+                                std::set<int>& values);
+
+protected:
+    bool has_value_ {false};
+    size_t null_count_ {0};
+};
+
+/**
+ * @brief Column statistics computed on the typed values of type T
+ */
+template <class T>
+class TypedColumnStatistics : public ColumnStatistics
+{
+public:
+    void update (const ColumnHandle& column, size_t from_index, size_t to_index) override;
+    void merge (const std::string& min, const std::string& max) override;
+
+    std::string minString () const override;
+    std::string maxString () const override;
+
+    const T& min () const { return min_; }
+    const T& max () const { return max_; }
+
+protected:
+    T min_ {};
+    T max_ {};
+
+    /// @brief Adds non-null value
+    void add (const T& value)
+    {
+        if (!has_value_)
+        {
+            min_ = value;
+            max_ = value;
+            has_value_ = true;
+        }
+        else if (value < min_)
+            min_ = value;
+        else if (max_ < value)
+            max_ = value;
+    }
+};
+
+#endif /* COLUMNSTATISTICS_H_ */
@@ -0,0 +1,246 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cassert>
+#include <vector>
+#include <limits>
+#include <stdexcept>
+
+#include "dictionaryvector.h"
+
+DictionaryVector::DictionaryVector ()
+{
+}
+
+DictionaryVector::DictionaryVector (DictionaryVector&& other)
+    : codes_(std::move(other.codes_)), values_(std::move(other.values_)), lookup_(std::move(other.lookup_)),
+      plain_(other.plain_), check_size_(other.check_size_)
+{
+    other.clear();
+}
+
+DictionaryVector& DictionaryVector::operator= (DictionaryVector&& other)
+{
+    if (this != &other)
+    {
+        // moving the deque keeps the addresses of its elements, so the lookup keys stay valid
+        codes_ = std::move(other.codes_);
+        values_ = std::move(other.values_);
+        lookup_ = std::move(other.lookup_);
+        plain_ = other.plain_;
+        check_size_ = other.check_size_;
+
+        other.clear();
+    }
+    return *this;
+}
+
+DictionaryVector::Code DictionaryVector::encode (const std::string& value)
+{
+    assert (!plain_);
+
+    auto it = lookup_.find(&value);
+
+    if (it != lookup_.end())
+        return it->second;
+
+    if (values_.size() >= std::numeric_limits<Code>::max())
+        throw std::runtime_error ("DictionaryVector: encode: too many distinct values");
+
+    Code code = values_.size();
+    values_.push_back(value);
+    lookup_.emplace(&values_.back(), code);
+
+    return code;
+}
+
+DictionaryVector::Code DictionaryVector::encode (const char* value, size_t length)
+{
+    lookup_key_.assign(value, length);
+    return encode (lookup_key_);
+}
+
+void DictionaryVector::set (size_t index, const std::string& value)
+{
+    if (plain_)
+    {
+        values_[index] = value;
+        return;
+    }
+
+    codes_[index] = encode(value);
+    checkCardinality();
+}
+
+void DictionaryVector::set (size_t index, const char* value, size_t length)
+{
+    if (plain_)
+    {
+        values_[index].assign(value, length);
+        return;
+    }
+
+    codes_[index] = encode(value, length);
+    checkCardinality();
+}
+
+void DictionaryVector::push_back (const std::string& value)
+{
+    if (plain_)
+    {
+        codes_.push_back(plainCode());
+        values_.push_back(value);
+        return;
+    }
+
+    codes_.push_back(encode(value));
+    checkCardinality();
+}
+
+void DictionaryVector::push_back (const char* value, size_t length)
+{
+    if (plain_)
+    {
+        codes_.push_back(plainCode());
+        values_.emplace_back(value, length);
+        return;
+    }
+
+    codes_.push_back(encode(value, length));
+    checkCardinality();
+}
+
+void DictionaryVector::append (const std::string* values, size_t count)
+{
+    for (size_t cnt=0; cnt < count; ++cnt)
+        push_back(values[cnt]);
+}
+
+void DictionaryVector::append (DictionaryVector&& other)
+{
+    if (codes_.empty() && values_.empty()) // take over
+    {
+        *this = std::move(other);
+        return;
+    }
+
+    if (plain_)
+    {
+        codes_.reserve(codes_.size()+other.codes_.size());
+
+        for (size_t cnt=0; cnt < other.size(); ++cnt)
+            push_back(other[cnt]);
+
+        other.clear();
+        return;
+    }
+
+    std::vector<Code> recodes;
+    recodes.reserve(other.values_.size());
+
+    for (const std::string& value_it : other.values_)
+        recodes.push_back(encode(value_it));
+
+    codes_.reserve(codes_.size()+other.codes_.size());
+
+    for (size_t cnt=0; cnt < other.codes_.numSegments(); ++cnt)
+    {
+        for (Code code_it : other.codes_.segment(cnt))
+            codes_.push_back(recodes[code_it]);
+    }
+
+    other.clear();
+
+    checkCardinality();
+}
+
+void DictionaryVector::resize (size_t size, const std::string& value)
+{
+    if (size <= codes_.size())
+    {
+        codes_.resize(size);
+
+        if (plain_) // entries of removed elements
+            values_.resize(size);
+    }
+    else if (plain_)
+    {
+        codes_.reserve(size);
+
+        while (codes_.size() < size)
+            push_back(value);
+    }
+    else
+    {
+        codes_.resize(size, encode(value));
+        checkCardinality();
+    }
+}
+
+void DictionaryVector::fill (const std::string& value)
+{
+    // only one value remains, so the dictionary is started anew
+    lookup_.clear();
+    values_.clear();
+    plain_ = false;
+    check_size_ = CARDINALITY_CHECK_SIZE;
+
+    codes_.fill(encode(value));
+}
+
+void DictionaryVector::clear ()
+{
+    codes_.clear();
+    lookup_.clear();
+    values_.clear();
+    plain_ = false;
+    check_size_ = CARDINALITY_CHECK_SIZE;
+}
+
+void DictionaryVector::checkCardinalityFallback ()
+{
+    assert (!plain_);
+
+    check_size_ = values_.size()+CARDINALITY_CHECK_SIZE;
+
+    if (values_.size() <= codes_.size()/2 || codes_.size() >= std::numeric_limits<Code>::max())
+        return;
+
+    // one entry per element in order of elements, which also drops unreferenced entries
+    std::deque<std::string> values;
+    size_t size = codes_.size();
+
+    for (size_t index=0; index < size; ++index)
+    {
+        values.push_back(values_[codes_[index]]);
+        codes_[index] = static_cast<Code> (index);
+    }
+
+    lookup_.clear();
+    values_ = std::move(values);
+    plain_ = true;
+}
+
+DictionaryVector::Code DictionaryVector::plainCode () const
+{
+    assert (plain_);
+
+    if (codes_.size() >= std::numeric_limits<Code>::max())
+        throw std::runtime_error ("DictionaryVector: plainCode: too many values");
+
+    return static_cast<Code> (codes_.size());
+}
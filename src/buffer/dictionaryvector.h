@@ -0,0 +1,134 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DICTIONARYVECTOR_H_
+#define DICTIONARYVECTOR_H_
+
+#include <string>
+#include <deque>
+#include <unordered_map>
+
+#include "chunkedvector.h"
+
+/**
+ * @brief Dictionary-encoded string container
+ *
+ * Stores one integer code per element, and each distinct string once in a dictionary shared by all elements.
+ * Codes are assigned in order of first insertion and stay valid until clear() or fill(). Dictionary entries are not
+ * removed when elements are overwritten or cut, so the dictionary may contain values not referenced by any element.
+ *
+ * For high-cardinality columns (e.g. time stamps as text) the dictionary saves no memory and costs a hash lookup per
+ * element. Therefore, each time the dictionary grew by CARDINALITY_CHECK_SIZE entries, it is checked if it has more
+ * entries than half the number of elements. If so, the container falls back to plain storage: each element gets an
+ * own entry with its index as code, and the lookup is dropped. This also removes all unreferenced entries. Codes then
+ * no longer identify distinct values, i.e. equal values may have different codes.
+ */
+class DictionaryVector
+{
+public:
+    typedef unsigned int Code;
+
+    /// Number of new dictionary entries after which the cardinality is checked
+    static const size_t CARDINALITY_CHECK_SIZE = 4096;
+
+    /// @brief Constructor
+    DictionaryVector ();
+    /// @brief Move constructor
+    DictionaryVector (DictionaryVector&& other);
+    /// @brief Move operator
+    DictionaryVector& operator= (DictionaryVector&& other);
+
+    size_t size () const { return codes_.size(); }
+    bool empty () const { return codes_.empty(); }
+
+    const std::string& operator[] (size_t index) const { return values_[codes_[index]]; }
+
+    /// @brief Returns code of element
+    Code code (size_t index) const { return codes_[index]; }
+    /// @brief Returns code container
+    const ChunkedVector<Code>& codes () const { return codes_; }
+
+    /// @brief Returns number of dictionary entries
+    size_t dictionarySize () const { return values_.size(); }
+    /// @brief Returns dictionary value of code
+    const std::string& value (Code code) const { return values_.at(code); }
+    /// @brief Returns if fallen back to plain storage, one entry per element
+    bool plain () const { return plain_; }
+
+    void set (size_t index, const std::string& value);
+    void set (size_t index, const char* value, size_t length);
+
+    void push_back (const std::string& value);
+    void push_back (const char* value, size_t length);
+
+    /// @brief Appends count values
+    void append (const std::string* values, size_t count);
+    /// @brief Appends all elements of other and clears it, re-coding its elements
+    void append (DictionaryVector&& other);
+
+    /// @brief Resizes to size, new elements are set to value
+    void resize (size_t size, const std::string& value=std::string());
+    /// @brief Reserves space for size elements
+    void reserve (size_t size) { codes_.reserve(size); }
+    /// @brief Sets all elements to value, removing all other dictionary entries
+    void fill (const std::string& value);
+    /// @brief Removes all elements and dictionary entries
+    void clear ();
+
+private:
+    struct ValueHash
+    {
+        size_t operator() (const std::string* value) const { return std::hash<std::string>() (*value); }
+    };
+    struct ValueEqual
+    {
+        bool operator() (const std::string* first, const std::string* second) const { return *first == *second; }
+    };
+
+    ChunkedVector<Code> codes_;
+
+    /// Dictionary values by code, deque for stable addresses
+    std::deque<std::string> values_;
+    /// Codes by dictionary value, keys point into values_
+    std::unordered_map<const std::string*, Code, ValueHash, ValueEqual> lookup_;
+    /// Re-used key for lookup of character data
+    std::string lookup_key_;
+
+    /// Flag indicating fallback to plain storage, then element index == code and lookup_ is empty
+    bool plain_ {false};
+    /// Dictionary size at which the cardinality is checked next
+    size_t check_size_ {CARDINALITY_CHECK_SIZE};
+
+    /// @brief Returns code of value, adds it to the dictionary if not existing, only without fallback
+    Code encode (const std::string& value);
+    Code encode (const char* value, size_t length);
+
+    /// @brief Falls back to plain storage if the dictionary grew enough and has too many entries
+    void checkCardinality ()
+    {
+        if (!plain_ && values_.size() >= check_size_)
+            checkCardinalityFallback();
+    }
+    void checkCardinalityFallback ();
+    /// @brief Returns code for new plain entry
+    Code plainCode () const;
+
+    DictionaryVector (const DictionaryVector&) = delete;
+    void operator= (const DictionaryVector&) = delete;
+};
+
+#endif /* DICTIONARYVECTOR_H_ */
@@ -22,11 +22,84 @@ NullableVector<bool>& NullableVector<bool>::operator*=(double factor)
 {
     bool tmp_factor = static_cast<bool> (factor);
 
-    for (auto data_it : data_)
-        data_it = data_it && tmp_factor;
+    for (size_t cnt=0; cnt < data_.numSegments(); ++cnt)
+    {
+        for (auto data_it : data_.segment(cnt))
+            data_it = data_it && tmp_factor;
+    }
 
     return *this;
 }
 
 
 
+template <>
+std::set<std::string> NullableVector<std::string>::distinctValues (size_t index)
+{
+    logdbg << "ArrayListTemplate " << property_.name() << ": distinctValues";
+
+    // mark used dictionary codes, since dictionary may contain unreferenced values
+    std::vector<bool> used (data_.dictionarySize(), false);
+
+    size_t data_size = data_.size();
+    bool all_valid = validity_.allValid();
+
+    for (; index < data_size; ++index)
+    {
+        if (all_valid || validity_.isValid(index)) // not for null
+            used[data_.code(index)] = true;
+    }
+
+    std::set<std::string> values;
+
+    for (DictionaryVector::Code code=0; code < used.size(); ++code)
+    {
+        if (used[code])
+            values.insert(data_.value(code));
+    }
+
+    return values;
+}
+
+template <>
+std::map<std::string, std::vector<size_t>> NullableVector<std::string>::distinctValuesWithIndexes (
+        size_t from_index, size_t to_index)
+{
+    logdbg << "ArrayListTemplate " << property_.name() << ": distinctValuesWithIndexes";
+
+    std::map<std::string, std::vector<size_t>> values;
+
+    assert (from_index < to_index);
+
+    if (from_index+1 > data_.size()) // no data
+        return values;
+
+    if (to_index >= data_.size()) // rest is null
+        to_index = data_.size()-1;
+
+    // group by dictionary code, then convert to values, merging codes of equal values after a plain fallback
+    std::vector<std::vector<size_t>> indexes (data_.dictionarySize());
+
+    for (size_t index = from_index; index <= to_index; ++index)
+    {
+        if (validity_.isValid(index)) // not for null
+            indexes[data_.code(index)].push_back(index);
+    }
+
+    for (DictionaryVector::Code code=0; code < indexes.size(); ++code)
+    {
+        if (!indexes[code].size())
+            continue;
+
+        std::vector<size_t>& value_indexes = values[data_.value(code)];
+
+        if (value_indexes.empty())
+            value_indexes = std::move(indexes[code]);
+        else // plain, code is index, so indexes stay sorted
+            value_indexes.insert(value_indexes.end(), indexes[code].begin(), indexes[code].end());
+    }
+
+    logdbg << "ArrayListTemplate " << property_.name() << ": distinctValuesWithIndexes: done with " << values.size();
+    return values;
+}
+
@@ -26,19 +26,30 @@
 #include <array>
 #include <set>
 #include <map>
+#include <iterator>
 
 #include <QDateTime>
 
 #include "stringconv.h"
 #include "buffer.h"
 #include "property.h"
+#include "validitybitmap.h"
+#include "chunkedvector.h"
+#include "dictionaryvector.h"
 
 const bool BUFFER_PEDANTIC_CHECKING=false;
 
+/// @brief Data container type of NullableVector
+template <class T> struct NullableVectorStorage { typedef ChunkedVector<T> type; };
+/// @brief Strings are dictionary-encoded
+template <> struct NullableVectorStorage<std::string> { typedef DictionaryVector type; };
+
 /**
  * @brief Template List of fixed-size arrays to be used in Buffer classes.
  *
- * Was written for easy management of arrays of different data types.
+ * Was written for easy management of arrays of different data types. Data is kept in a ChunkedVector, so growing
+ * never copies stored elements, strings in a DictionaryVector. Null flags are kept in a ValidityBitmap of the same size as the data container,
+ * elements beyond the size are Null.
  */
 template <class T>
 class NullableVector
@@ -49,7 +60,7 @@ public:
     /// @brief Destructor
     virtual ~NullableVector () {}
 
-    /// @brief Sets all elements to false
+    /// @brief Sets all elements to null, keeping the size
     void clear();
 
     /// @brief Returns const reference to a specific value
@@ -60,12 +71,21 @@ public:
 
     /// @brief Sets specific value
     void set (size_t index, T value);
+    /// @brief Sets specific value from character data without temporary string, only for std::string
+    void set (size_t index, const char* value, size_t length);
 
     void setFromFormat (size_t index, const std::string& format, const std::string& value_str);
 
     /// @brief Sets specific element to Null value
     void setNull(size_t index);
 
+    /// @brief Appends value after the last element
+    void appendValid (const T& value);
+    /// @brief Appends count values after the last element
+    void appendValid (const T* values, size_t count);
+    /// @brief Appends count Null elements after the last element
+    void appendNull (size_t count=1);
+
     NullableVector<T>& operator*=(double factor);
 
     std::set<T> distinctValues (size_t index=0);
@@ -79,6 +99,14 @@ public:
     /// @brief Checks if specific element is Null
     bool isNull(size_t index);
 
+    /// @brief Returns number of Null elements up to size()
+    size_t nullCount ();
+
+    /// @brief Returns data container, values of Null elements are undefined
+    const typename NullableVectorStorage<T>::type& data () const { return data_; }
+    /// @brief Returns validity flags, of same size as the vector
+    const ValidityBitmap& validity () const { return validity_; }
+
     void checkNotNull ();
 
 
@@ -86,18 +114,16 @@ private:
     Property property_;
     Buffer& buffer_;
     /// Data container
-    std::vector<T> data_;
-    // Null flags container
-    std::vector <bool> null_flags_;
+    typename NullableVectorStorage<T>::type data_;
+    /// Validity flags container, same size as data_
+    ValidityBitmap validity_;
 
-    /// @brief Sets specific element to not Null value
-    void unsetNull (size_t index);
-
-    void resizeDataTo (size_t size);
-    void resizeNullTo (size_t size);
+    void updateBufferSize ();
     void addData (NullableVector<T>& other);
-    void copyData (NullableVector<T>& other);
+    /// @brief Appends the rows of other set in selection, rows beyond the size of other are left out
+    void addSelectedData (const NullableVector<T>& other, const ValidityBitmap& selection);
     void cutToSize (size_t size);
+    void reserve (size_t size);
 
     /// @brief Constructor, only for friend Buffer
     NullableVector (Property& property, Buffer& buffer);
@@ -111,8 +137,8 @@ template <class T> NullableVector<T>::NullableVector (Property& property, Buffer
 template <class T> void NullableVector<T>::clear()
 {
     logdbg << "ArrayListTemplate " << property_.name() << ": clear";
-    std::fill (data_.begin(),data_.end(), T());
-    std::fill (null_flags_.begin(), null_flags_.end(), true);
+    data_.fill(T());
+    validity_.fill(false);
 }
 
 template <class T> const T NullableVector<T>::get (size_t index)
@@ -121,8 +147,7 @@ template <class T> const T NullableVector<T>::get (size_t index)
     if (BUFFER_PEDANTIC_CHECKING)
     {
         assert (data_.size() <= buffer_.data_size_);
-        assert (null_flags_.size() <= buffer_.data_size_);
-        assert (index < data_.size());
+        assert (validity_.size() == data_.size());
         assert (index < data_.size());
     }
 
@@ -137,7 +162,7 @@ template <class T> const T NullableVector<T>::get (size_t index)
         throw std::runtime_error ("ArrayListTemplate: get of Null value "+std::to_string(index));
     }
 
-    return data_.at(index);
+    return data_[index];
 }
 
 template <class T> const std::string NullableVector<T>::getAsString (size_t index)
@@ -153,26 +178,45 @@ template <class T> void NullableVector<T>::set (size_t index, T value)
     if (BUFFER_PEDANTIC_CHECKING)
     {
         assert (data_.size() <= buffer_.data_size_);
-        assert (null_flags_.size() <= buffer_.data_size_);
+        assert (validity_.size() == data_.size());
     }
 
-    if (index >= data_.size()) // allocate new stuff, fill all new with not null
+    if (index >= data_.size()) // allocate new stuff
     {
-        if (index != data_.size()) // some where left out
-            resizeNullTo(index+1);
+        if (index != data_.size()) // some where left out, fill with null
+            appendNull (index-data_.size());
 
-        resizeDataTo (index+1);
+        appendValid (value);
+        return;
     }
 
-    if (BUFFER_PEDANTIC_CHECKING)
-        assert (index < data_.size());
-
-    data_.at(index) = value;
-    unsetNull(index);
+    data_.set(index, value);
+    validity_.setValid(index);
 
     //logdbg << "ArrayListTemplate: set: size " << size_ << " max_size " << max_size_;
 }
 
+template <class T> void NullableVector<T>::set (size_t index, const char* value, size_t length)
+{
+    logdbg << "ArrayListTemplate " << property_.name() << ": set: index " << index << " length " << length;
+
+    static_assert (std::is_same<T, std::string>::value, "only defined for strings");
+
+    if (index >= data_.size()) // allocate new stuff
+    {
+        if (index != data_.size()) // some where left out, fill with null
+            appendNull (index-data_.size());
+
+        data_.push_back(value, length);
+        validity_.appendValid(1);
+        updateBufferSize();
+        return;
+    }
+
+    data_.set(index, value, length);
+    validity_.setValid(index);
+}
+
 template <class T> void NullableVector<T>::setFromFormat (size_t index, const std::string& format,
                                                              const std::string& value_str)
 {
@@ -215,76 +259,75 @@ template <class T> void NullableVector<T>::setNull(size_t index)
     if (BUFFER_PEDANTIC_CHECKING)
     {
         assert (data_.size() <= buffer_.data_size_);
-        assert (null_flags_.size() <= buffer_.data_size_);
+        assert (validity_.size() == data_.size());
     }
 
-    if (index >= null_flags_.size()) // null flags to small
-        resizeNullTo (index+1);
+    if (index >= data_.size()) // not yet allocated, fill with null
+    {
+        appendNull (index+1-data_.size());
+        return;
+    }
 
-    if (BUFFER_PEDANTIC_CHECKING)
-        assert (index < null_flags_.size());
+    validity_.setNull(index);
+}
 
-    null_flags_.at(index) = true;
+template <class T> void NullableVector<T>::appendValid (const T& value)
+{
+    logdbg << "ArrayListTemplate " << property_.name() << ": appendValid";
+
+    data_.push_back(value);
+    validity_.appendValid(1);
+
+    updateBufferSize();
 }
 
-/// @brief Checks if specific element is Null
-template <class T> bool NullableVector<T>::isNull(size_t index)
+template <class T> void NullableVector<T>::appendValid (const T* values, size_t count)
 {
-    logdbg << "ArrayListTemplate " << property_.name() << ": isNull: index " << index;
+    logdbg << "ArrayListTemplate " << property_.name() << ": appendValid: count " << count;
 
-    if (BUFFER_PEDANTIC_CHECKING)
-    {
-        assert (data_.size() <= buffer_.data_size_);
-        assert (null_flags_.size() <= buffer_.data_size_);
-        assert (index < buffer_.data_size_);
-    }
+    data_.append(values, count);
+    validity_.appendValid(count);
 
-    if (index < null_flags_.size()) // if stored, return value
-        return null_flags_.at(index);
+    updateBufferSize();
+}
 
-    // null not stored, so all set are not null
+template <class T> void NullableVector<T>::appendNull (size_t count)
+{
+    logdbg << "ArrayListTemplate " << property_.name() << ": appendNull: count " << count;
 
-    if (index >= data_.size()) // not yet set
-        return true;
+    data_.resize(data_.size()+count, T());
+    validity_.appendNull(count);
 
-    // must be set
-    return false;
+    updateBufferSize();
 }
 
-template <class T> void NullableVector<T>::resizeDataTo (size_t size)
+/// @brief Checks if specific element is Null
+template <class T> bool NullableVector<T>::isNull(size_t index)
 {
-    logdbg << "ArrayListTemplate " << property_.name() << ": resizeDataTo: size " << size;
+    logdbg << "ArrayListTemplate " << property_.name() << ": isNull: index " << index;
 
     if (BUFFER_PEDANTIC_CHECKING)
     {
         assert (data_.size() <= buffer_.data_size_);
-        assert (data_.size() < size); // only to be called if needed
+        assert (validity_.size() == data_.size());
+        assert (index < buffer_.data_size_);
     }
 
-    data_.resize(size, T());
+    if (index >= data_.size()) // not yet set
+        return true;
 
-    if (buffer_.data_size_ < data_.size()) // set new data size
-        buffer_.data_size_ = data_.size();
+    return validity_.isNull(index);
 }
 
-template <class T> void NullableVector<T>::resizeNullTo (size_t size)
+template <class T> size_t NullableVector<T>::nullCount ()
 {
-    logdbg << "ArrayListTemplate " << property_.name() << ": resizeNullTo: size " << size;
-
-    if (BUFFER_PEDANTIC_CHECKING)
-        assert (null_flags_.size() <= buffer_.data_size_);
-
-    if (data_.size() > null_flags_.size()) // data was set w/o null, adjust & fill with set values
-        null_flags_.resize(data_.size(), false);
-
-    if (null_flags_.size() < size) // adjust to new size, fill with null values
-        null_flags_.resize(size, true);
-
-    if (buffer_.data_size_ < null_flags_.size()) // set new data size
-        buffer_.data_size_ = null_flags_.size();
+    return validity_.nullCount();
+}
 
-    if (BUFFER_PEDANTIC_CHECKING)
-        assert (size == null_flags_.size());
+template <class T> void NullableVector<T>::updateBufferSize ()
+{
+    if (buffer_.data_size_ < data_.size()) // set new data size
+        buffer_.data_size_ = data_.size();
 }
 
 template <class T> void NullableVector<T>::addData (NullableVector<T>& other)
@@ -294,51 +337,28 @@ template <class T> void NullableVector<T>::addData (NullableVector<T>& other)
     if (BUFFER_PEDANTIC_CHECKING)
     {
         assert (data_.size() <= buffer_.data_size_);
-        assert (null_flags_.size() <= buffer_.data_size_);
+        assert (validity_.size() == data_.size());
+        assert (other.validity_.size() == other.data_.size());
     }
 
-    if (!other.data_.size() && other.null_flags_.size()) // if other has null flags set, need to fill my nulls
+    if (!buffer_.data_size_) // nothing stored yet, take over containers
     {
-        logdbg << "ArrayListTemplate " << property_.name() << ": addData: 1: other no data resizing null";
-        resizeNullTo (buffer_.data_size_);
-        logdbg << "ArrayListTemplate " << property_.name() << ": addData: 1: inserting null";
-        null_flags_.insert(null_flags_.end(), other.null_flags_.begin(), other.null_flags_.end());
+        logdbg << "ArrayListTemplate " << property_.name() << ": addData: taking over";
+        data_ = std::move(other.data_);
+        validity_ = std::move(other.validity_);
         goto DONE;
     }
 
-    if (other.data_.size() && !other.null_flags_.size()) // if other has everything set
+    if (data_.size() < buffer_.data_size_) // need to size up to previous buffer size
     {
-        logdbg << "ArrayListTemplate " << property_.name() << ": addData: 2: other has everything set";
-
-        if (data_.size() < buffer_.data_size_) // need to size data up
-        {
-            logdbg << "ArrayListTemplate " << property_.name() << ": addData: 2: data not full, setting null";
-            resizeNullTo (buffer_.data_size_);
-
-            logdbg << "ArrayListTemplate " << property_.name() << ": addData: 2: resizing data";
-            resizeDataTo (buffer_.data_size_);
-        }
-
-        logdbg << "ArrayListTemplate " << property_.name() << ": addData: 2: inserting data";
-        data_.insert(data_.end(), other.data_.begin(), other.data_.end());
-        goto DONE;
-    }
-
-    logdbg << "ArrayListTemplate " << property_.name() << ": addData: 3: mixture, both have data & nulls";
-
-    logdbg << "ArrayListTemplate " << property_.name() << ": addData: 3: resizing null to " << buffer_.data_size_;
-    resizeNullTo (buffer_.data_size_);
-    logdbg << "ArrayListTemplate " << property_.name() << ": addData: 3: inserting nulls";
-    null_flags_.insert(null_flags_.end(), other.null_flags_.begin(), other.null_flags_.end());
-
-    if (data_.size() < buffer_.data_size_) // need to size data up
-    {
-        logdbg << "ArrayListTemplate " << property_.name() << ": addData: 3: resizing data";
-        resizeDataTo (buffer_.data_size_);
+        logdbg << "ArrayListTemplate " << property_.name() << ": addData: filling null";
+        data_.resize(buffer_.data_size_, T());
+        validity_.appendNull(buffer_.data_size_-validity_.size());
     }
 
-    logdbg << "ArrayListTemplate " << property_.name() << ": addData: 3: inserting data";
-    data_.insert(data_.end(), other.data_.begin(), other.data_.end());
+    logdbg << "ArrayListTemplate " << property_.name() << ": addData: inserting data";
+    data_.append(std::move(other.data_));
+    validity_.append(other.validity_);
 
 DONE:
     // size is adjusted in Buffer::seizeBuffer
@@ -346,30 +366,56 @@ DONE:
     logdbg << "ArrayListTemplate " << property_.name() << ": addData: end";
 }
 
-template <class T> void NullableVector<T>::copyData (NullableVector<T>& other)
+template <class T> void NullableVector<T>::addSelectedData (const NullableVector<T>& other,
+                                                             const ValidityBitmap& selection)
 {
-    logdbg << "ArrayListTemplate " << property_.name() << ": copyData";
+    logdbg << "ArrayListTemplate " << property_.name() << ": addSelectedData";
 
-    data_ = other.data_;
-    null_flags_ = other.null_flags_;
+    size_t other_size = other.data_.size();
+    size_t num_words = ValidityBitmap::numWords(std::min (selection.size(), other_size));
+    bool all_valid = other.validity_.allValid();
+    size_t num_added = 0;
 
-    // is only done for new buffers in Buffer::getPartialCopy, so no size-too-big isse
+    for (size_t word_cnt=0; word_cnt < num_words; ++word_cnt)
+    {
+        uint64_t word = selection.word(word_cnt);
 
-    if (buffer_.data_size_ < data_.size())
-        buffer_.data_size_ = data_.size();
+        while (word) // one iteration per set bit
+        {
+            size_t index = word_cnt * ValidityBitmap::WORD_BITS + __builtin_ctzll(word);
+            word &= word - 1;
+
+            if (index >= other_size)
+                break;
+
+            data_.push_back(other.data_[index]);
+            ++num_added;
+
+            if (!all_valid)
+            {
+                if (other.validity_.isValid(index))
+                    validity_.appendValid(1);
+                else
+                    validity_.appendNull(1);
+            }
+        }
+    }
 
-    if (buffer_.data_size_ < null_flags_.size())
-        buffer_.data_size_ = null_flags_.size();
+    if (all_valid)
+        validity_.appendValid(num_added);
 
-    logdbg << "ArrayListTemplate " << property_.name() << ": copyData: end";
+    // size is adjusted in Buffer::select
 }
 
 template <class T> NullableVector<T>& NullableVector<T>::operator*=(double factor)
 {
     logdbg << "ArrayListTemplate " << property_.name() << ": operator*=";
 
-    for (auto &data_it : data_)
-        data_it *= factor;
+    for (size_t cnt=0; cnt < data_.numSegments(); ++cnt)
+    {
+        for (auto &data_it : data_.segment(cnt))
+            data_it *= factor;
+    }
 
     return *this;
 }
@@ -380,15 +426,19 @@ template <class T> std::set<T> NullableVector<T>::distinctValues (size_t index)
 
     std::set<T> values;
 
-    T value;
+    size_t data_size = data_.size();
 
-    for (; index < data_.size(); ++index)
+    if (validity_.allValid())
     {
-        if (!isNull(index)) // not for null
+        for (; index < data_size; ++index)
+            values.insert(data_[index]);
+    }
+    else
+    {
+        for (; index < data_size; ++index)
         {
-            value = data_.at(index);
-            if (values.count(value) == 0)
-                values.insert(value);
+            if (validity_.isValid(index)) // not for null
+                values.insert(data_[index]);
         }
     }
 
@@ -410,21 +460,19 @@ template <class T> std::map<T, std::vector<size_t>> NullableVector<T>::distinctV
         assert (from_index < buffer_.data_size_);
         assert (to_index < buffer_.data_size_);
         assert (data_.size() <= buffer_.data_size_);
-        assert (null_flags_.size() <= buffer_.data_size_);
+        assert (validity_.size() == data_.size());
     }
 
     if (from_index+1 > data_.size()) // no data
         return values;
 
+    if (to_index >= data_.size()) // rest is null
+        to_index = data_.size()-1;
+
     for (size_t index = from_index; index <= to_index; ++index)
     {
-        if (!isNull(index)) // not for null
-        {
-            if (BUFFER_PEDANTIC_CHECKING)
-                assert (index < data_.size());
-
-            values[data_.at(index)].push_back(index);
-        }
+        if (validity_.isValid(index)) // not for null
+            values[data_[index]].push_back(index);
     }
 
     logdbg << "ArrayListTemplate " << property_.name() << ": distinctValuesWithIndexes: done with " << values.size();
@@ -437,26 +485,26 @@ template <class T> void NullableVector<T>::convertToStandardFormat(const std::st
 
     static_assert (std::is_integral<T>::value, "only defined for integer types");
 
+    if (validity_.nullCount() == data_.size()) // nothing to convert, format not checked
+        return;
+
+    if (from_format != "octal")
+    {
+        logerr << "ArrayListTemplate: convertToStandardFormat: unknown format '" << from_format << "'";
+        assert (false);
+    }
+
     std::string value_str;
     //T value;
 
     size_t data_size = data_.size();
     for (size_t cnt=0; cnt < data_size; cnt++)
     {
-        if (isNull(cnt))
+        if (validity_.isNull(cnt))
             continue;
 
-        value_str = std::to_string(data_.at(cnt));
-
-        if (from_format == "octal")
-        {
-            data_.at(cnt) = std::stoi(value_str, 0, 8);
-        }
-        else
-        {
-            logerr << "ArrayListTemplate: convertToStandardFormat: unknown format '" << from_format << "'";
-            assert (false);
-        }
+        value_str = std::to_string(data_[cnt]);
+        data_[cnt] = std::stoi(value_str, 0, 8);
     }
 }
 
@@ -469,25 +517,36 @@ template <class T> void NullableVector<T>::cutToSize (size_t size)
     if (BUFFER_PEDANTIC_CHECKING)
     {
         assert (data_.size() <= buffer_.data_size_);
-        assert (null_flags_.size() <= buffer_.data_size_);
+        assert (validity_.size() == data_.size());
     }
 
-    while (null_flags_.size() > size)
-        null_flags_.pop_back();
-
-    while (data_.size() > size)
-        data_.pop_back();
+    if (data_.size() > size)
+    {
+        data_.resize(size);
+        validity_.resize(size, false);
+    }
 
     // size set in Buffer::cutToSize
 }
 
+template <class T> void NullableVector<T>::reserve (size_t size)
+{
+    logdbg << "ArrayListTemplate " << property_.name() << ": reserve: size " << size;
+
+    data_.reserve(size);
+    validity_.reserve(size);
+}
+
 template <class T> void NullableVector<T>::checkNotNull ()
 {
     logdbg << "ArrayListTemplate " << property_.name() << ": checkNotNull";
 
-    for (size_t cnt=0; cnt < null_flags_.size(); cnt++)
+    if (!validity_.nullCount())
+        return;
+
+    for (size_t cnt=0; cnt < validity_.size(); cnt++)
     {
-       if (null_flags_.at(cnt))
+       if (validity_.isNull(cnt))
        {
            logerr << "cnt " << cnt << " null";
            assert (false);
@@ -495,27 +554,15 @@ template <class T> void NullableVector<T>::checkNotNull ()
     }
 }
 
-// private stuff
-
-/// @brief Sets specific element to not Null value
-template <class T> void NullableVector<T>::unsetNull (size_t index)
-{
-    logdbg << "ArrayListTemplate " << property_.name() << ": unsetNull";
-
-    if (BUFFER_PEDANTIC_CHECKING)
-    {
-        assert (data_.size() <= buffer_.data_size_);
-        assert (null_flags_.size() <= buffer_.data_size_);
-        assert (index < buffer_.data_size_);
-        assert (index < data_.size());
-    }
+template <>
+NullableVector<bool>& NullableVector<bool>::operator*=(double factor);
 
-    if (index < null_flags_.size()) // if was already set
-        null_flags_.at(index) = false;
-}
+template <>
+std::set<std::string> NullableVector<std::string>::distinctValues (size_t index);
 
 template <>
-NullableVector<bool>& NullableVector<bool>::operator*=(double factor);
+std::map<std::string, std::vector<size_t>> NullableVector<std::string>::distinctValuesWithIndexes (
+        size_t from_index, size_t to_index);
 
 
 
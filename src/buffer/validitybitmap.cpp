@@ -0,0 +1,308 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "validitybitmap.h"
+
+const size_t ValidityBitmap::WORD_BITS;
+
+namespace
+{
+    const uint64_t ALL_BITS = ~uint64_t(0);
+
+    /// returns mask with lowest num_bits set, num_bits <= 64
+    inline uint64_t lowMask (size_t num_bits)
+    {
+        return num_bits >= ValidityBitmap::WORD_BITS ? ALL_BITS : (uint64_t(1) << num_bits) - 1;
+    }
+}
+
+void ValidityBitmap::appendValid (size_t count)
+{
+    if (!count)
+        return;
+
+    if (all_valid_)
+    {
+        size_ += count;
+        return;
+    }
+
+    size_t from = size_;
+    size_ += count;
+    words_.resize(numWords(size_), 0);
+
+    // set bits [from, size_) word-wise
+    size_t word_index = from / WORD_BITS;
+    size_t bit_offset = from % WORD_BITS;
+
+    if (bit_offset)
+    {
+        size_t num_bits = std::min (count, WORD_BITS - bit_offset);
+        words_[word_index] |= lowMask(num_bits) << bit_offset;
+        count -= num_bits;
+        ++word_index;
+    }
+
+    for (; count >= WORD_BITS; count -= WORD_BITS, ++word_index)
+        words_[word_index] = ALL_BITS;
+
+    if (count)
+        words_[word_index] |= lowMask(count);
+}
+
+void ValidityBitmap::appendNull (size_t count)
+{
+    if (!count)
+        return;
+
+    if (all_valid_)
+        materialize();
+
+    // tail bits are always zero, so new words only have to be allocated
+    size_ += count;
+    words_.resize(numWords(size_), 0);
+    null_count_ += count;
+}
+
+void ValidityBitmap::append (const ValidityBitmap& other)
+{
+    append (other, 0, other.size_);
+}
+
+void ValidityBitmap::append (const ValidityBitmap& other, size_t offset, size_t count)
+{
+    assert (offset + count <= other.size_);
+
+    if (!count)
+        return;
+
+    if (other.all_valid_)
+    {
+        appendValid(count);
+        return;
+    }
+
+    if (all_valid_)
+        materialize();
+
+    size_t dest_bit = size_;
+    size_ += count;
+    words_.resize(numWords(size_), 0);
+
+    size_t valid_count = 0;
+
+    if (dest_bit % WORD_BITS == 0 && offset % WORD_BITS == 0) // aligned, plain word copy
+    {
+        size_t num_words = numWords(count);
+        std::copy (other.words_.begin() + offset / WORD_BITS, other.words_.begin() + offset / WORD_BITS + num_words,
+                   words_.begin() + dest_bit / WORD_BITS);
+        clearTail();
+
+        for (size_t cnt=0; cnt < num_words; ++cnt)
+            valid_count += __builtin_popcountll(words_[dest_bit / WORD_BITS + cnt]);
+    }
+    else
+    {
+        size_t src_bit = offset;
+        size_t remaining = count;
+
+        while (remaining)
+        {
+            // read up to one word from source
+            size_t num_bits = std::min (remaining, WORD_BITS);
+            size_t src_word = src_bit / WORD_BITS;
+            size_t src_offset = src_bit % WORD_BITS;
+
+            uint64_t bits = other.words_[src_word] >> src_offset;
+            if (src_offset && src_word + 1 < other.words_.size())
+                bits |= other.words_[src_word + 1] << (WORD_BITS - src_offset);
+            bits &= lowMask(num_bits);
+
+            valid_count += __builtin_popcountll(bits);
+
+            // write into destination, spanning at most two words
+            size_t dest_word = dest_bit / WORD_BITS;
+            size_t dest_offset = dest_bit % WORD_BITS;
+
+            words_[dest_word] |= bits << dest_offset;
+            if (dest_offset && dest_offset + num_bits > WORD_BITS)
+                words_[dest_word + 1] |= bits >> (WORD_BITS - dest_offset);
+
+            src_bit += num_bits;
+            dest_bit += num_bits;
+            remaining -= num_bits;
+        }
+    }
+
+    null_count_ += count - valid_count;
+}
+
+void ValidityBitmap::resize (size_t size, bool valid)
+{
+    if (size > size_)
+    {
+        if (valid)
+            appendValid(size - size_);
+        else
+            appendNull(size - size_);
+
+        return;
+    }
+
+    if (size == size_)
+        return;
+
+    size_ = size;
+
+    if (!all_valid_)
+    {
+        words_.resize(numWords(size_));
+        clearTail();
+        countNulls();
+    }
+}
+
+void ValidityBitmap::fill (bool valid)
+{
+    if (valid)
+    {
+        all_valid_ = true;
+        words_.clear();
+        null_count_ = 0;
+    }
+    else
+    {
+        all_valid_ = false;
+        words_.assign(numWords(size_), 0);
+        null_count_ = size_;
+    }
+}
+
+void ValidityBitmap::clear ()
+{
+    size_ = 0;
+    all_valid_ = true;
+    null_count_ = 0;
+    words_.clear();
+}
+
+void ValidityBitmap::reserve (size_t size)
+{
+    if (!all_valid_)
+        words_.reserve(numWords(size));
+}
+
+void ValidityBitmap::assign (std::vector<uint64_t>&& words, size_t size)
+{
+    assert (words.size() == numWords(size));
+
+    size_ = size;
+    words_ = std::move(words);
+    all_valid_ = false;
+
+    clearTail();
+    countNulls();
+}
+
+ValidityBitmap& ValidityBitmap::operator&= (const ValidityBitmap& other)
+{
+    assert (size_ == other.size_);
+
+    if (other.all_valid_)
+        return *this;
+
+    if (all_valid_)
+    {
+        words_ = other.words_;
+        all_valid_ = false;
+        null_count_ = other.null_count_;
+        return *this;
+    }
+
+    size_t num_words = words_.size();
+    for (size_t cnt=0; cnt < num_words; ++cnt)
+        words_[cnt] &= other.words_[cnt];
+
+    countNulls();
+
+    return *this;
+}
+
+ValidityBitmap& ValidityBitmap::operator|= (const ValidityBitmap& other)
+{
+    assert (size_ == other.size_);
+
+    if (all_valid_)
+        return *this;
+
+    if (other.all_valid_)
+    {
+        fill(true);
+        return *this;
+    }
+
+    size_t num_words = words_.size();
+    for (size_t cnt=0; cnt < num_words; ++cnt)
+        words_[cnt] |= other.words_[cnt];
+
+    countNulls();
+
+    return *this;
+}
+
+uint64_t ValidityBitmap::word (size_t word_index) const
+{
+    assert (word_index < numWords(size_));
+
+    if (!all_valid_)
+        return words_[word_index];
+
+    if (word_index + 1 < numWords(size_) || size_ % WORD_BITS == 0)
+        return ALL_BITS;
+
+    return lowMask(size_ % WORD_BITS);
+}
+
+// protected stuff
+
+void ValidityBitmap::materialize ()
+{
+    assert (all_valid_);
+
+    words_.assign(numWords(size_), ALL_BITS);
+    clearTail();
+    all_valid_ = false;
+    null_count_ = 0;
+}
+
+void ValidityBitmap::clearTail ()
+{
+    if (size_ % WORD_BITS && words_.size())
+        words_.back() &= lowMask(size_ % WORD_BITS);
+}
+
+void ValidityBitmap::countNulls ()
+{
+    size_t valid_count = 0;
+
+    for (auto word_it : words_)
+        valid_count += __builtin_popcountll(word_it);
+
+    null_count_ = size_ - valid_count;
+}
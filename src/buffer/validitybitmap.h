@@ -0,0 +1,139 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VALIDITYBITMAP_H_
+#define VALIDITYBITMAP_H_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+/**
+ * @brief Packed validity (not-null) flags, one bit per row, stored in 64-bit words.
+ *
+ * A set bit marks a valid (not null) row. As long as no null was ever stored the words are not allocated
+ * and the all-valid flag is used instead, so fully set columns cost no memory and no bit operations.
+ * Bits beyond size() in the last word are always kept zero, which allows popcount and word-wise
+ * combination without masking.
+ */
+class ValidityBitmap
+{
+public:
+    static const size_t WORD_BITS = 64;
+
+    /// @brief Constructor
+    ValidityBitmap () {}
+
+    /// @brief Returns number of rows
+    size_t size () const { return size_; }
+    /// @brief Returns true if no row is null
+    bool allValid () const { return all_valid_ || null_count_ == 0; }
+    /// @brief Returns number of null rows
+    size_t nullCount () const { return all_valid_ ? 0 : null_count_; }
+
+    /// @brief Returns true if row is valid, index must be < size()
+    bool isValid (size_t index) const
+    {
+        assert (index < size_);
+        return all_valid_ || (words_[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+    }
+    /// @brief Returns true if row is null, index must be < size()
+    bool isNull (size_t index) const { return !isValid(index); }
+
+    /// @brief Marks row as valid, index must be < size()
+    void setValid (size_t index)
+    {
+        assert (index < size_);
+
+        if (all_valid_)
+            return;
+
+        uint64_t& word = words_[index / WORD_BITS];
+        uint64_t mask = uint64_t(1) << (index % WORD_BITS);
+
+        if (!(word & mask))
+        {
+            word |= mask;
+            --null_count_;
+        }
+    }
+    /// @brief Marks row as null, index must be < size()
+    void setNull (size_t index)
+    {
+        assert (index < size_);
+
+        if (all_valid_)
+            materialize();
+
+        uint64_t& word = words_[index / WORD_BITS];
+        uint64_t mask = uint64_t(1) << (index % WORD_BITS);
+
+        if (word & mask)
+        {
+            word &= ~mask;
+            ++null_count_;
+        }
+    }
+
+    /// @brief Appends count valid rows
+    void appendValid (size_t count=1);
+    /// @brief Appends count null rows
+    void appendNull (size_t count=1);
+    /// @brief Appends all rows of other
+    void append (const ValidityBitmap& other);
+    /// @brief Appends count rows of other, starting at row offset
+    void append (const ValidityBitmap& other, size_t offset, size_t count);
+
+    /// @brief Resizes to size, new rows are valid if valid is set, null otherwise
+    void resize (size_t size, bool valid);
+    /// @brief Sets all rows to valid or null, size is kept
+    void fill (bool valid);
+    /// @brief Removes all rows
+    void clear ();
+    /// @brief Reserves storage for size rows
+    void reserve (size_t size);
+    /// @brief Replaces all rows by size rows given as packed words, bits beyond size are ignored
+    void assign (std::vector<uint64_t>&& words, size_t size);
+
+    /// @brief Row-wise AND with other, i.e. valid only where both are valid. Sizes must match.
+    ValidityBitmap& operator&= (const ValidityBitmap& other);
+    /// @brief Row-wise OR with other, i.e. valid where any is valid. Sizes must match.
+    ValidityBitmap& operator|= (const ValidityBitmap& other);
+
+    /// @brief Returns number of words required for size rows
+    static size_t numWords (size_t size) { return (size + WORD_BITS - 1) / WORD_BITS; }
+
+    /// @brief Returns word at given position, valid words are returned as set bits
+    uint64_t word (size_t word_index) const;
+
+protected:
+    size_t size_ {0};
+    /// Flag indicating that all rows are valid and words_ is not used
+    bool all_valid_ {true};
+    size_t null_count_ {0};
+    std::vector<uint64_t> words_;
+
+    /// @brief Allocates words for current size, all set valid, and clears all_valid_
+    void materialize ();
+    /// @brief Zeroes bits beyond size_ in last word
+    void clearTail ();
+    /// @brief Recalculates null_count_ using popcount
+    void countNulls ();
+};
+
+#endif /* VALIDITYBITMAP_H_ */
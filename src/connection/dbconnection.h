@@ -19,6 +19,7 @@
 #define DBCONNECTION_H_
 
 #include <memory>
+#include <vector>
 #include "configurable.h"
 
 #include <qobject.h>
@@ -28,6 +29,8 @@ class DBCommandList;
 class DBResult;
 class DBConnectionInfo;
 class Buffer;
+class ColumnHandle;
+class PropertyList;
 class DBTableInfo;
 class QWidget;
 
@@ -52,6 +55,8 @@ public:
    */
   DBConnection(const std::string &class_id, const std::string &instance_id, Configurable *parent)
       : Configurable(class_id, instance_id, parent), connection_ready_(false) {}
+  /// @brief Constructor for additional read connections, without configuration
+  DBConnection() : connection_ready_(false) {}
   /// @brief Destructor
   virtual ~DBConnection() {}
 
@@ -80,6 +85,24 @@ public:
   /// @brief Bind a variable to the NULL value
   virtual void bindVariableNull (unsigned int index)=0;
 
+  /**
+   * @brief Binds rows from_index to to_index (inclusive) of the columns to the bound statement, steps each row
+   *
+   * Column cnt is bound at index cnt+1, null values as NULL. The column types are resolved once per call, instead
+   * of per value as with bindVariable and stepAndClearBindings.
+   */
+  virtual void bindColumns (const std::vector<ColumnHandle>& columns, size_t from_index, size_t to_index)=0;
+
+  /**
+   * @brief Inserts rows from_index to to_index (inclusive) of the columns into a table using a bulk method
+   *
+   * Column cnt is inserted into the column named as property cnt. Returns false if not supported by the connection,
+   * in which case the rows have to be inserted using a bind statement.
+   */
+  virtual bool insertColumns (const std::string& table_name, const PropertyList& properties,
+                              const std::vector<ColumnHandle>& columns, size_t from_index, size_t to_index)
+  { return false; }
+
   /// @brief Executes a database query where data can be returned
   virtual std::shared_ptr <DBResult> execute (const DBCommand &command)=0;
   /// @brief Executes a number of database queries where data (of the same structure) can be returned
@@ -94,6 +117,33 @@ public:
   /// @brief Returns if all data from the prepared command was read
   virtual bool getPreparedCommandDone ()=0;
 
+  /**
+   * @brief Creates an additional connection to the same database for concurrent reading
+   *
+   * The returned connection is only to be used for reading, and has to be disconnected before deletion.
+   * Returns nullptr if not supported.
+   */
+  virtual std::unique_ptr<DBConnection> createReadConnection () { return nullptr; }
+  /// @brief Returns if read connections may read while the main connection writes
+  virtual bool concurrentReadWrite () { return false; }
+  /**
+   * @brief Creates an additional connection to the same database for writing concurrently to the main connection
+   *
+   * Used for building indexes of several tables in parallel. Has to be disconnected before deletion.
+   * Returns nullptr if concurrent writes are not supported.
+   */
+  virtual std::unique_ptr<DBConnection> createWriteConnection () { return nullptr; }
+
+  /// @brief Changes connection settings for fast bulk inserts, until endBulkImport
+  virtual void beginBulkImport () {}
+  /// @brief Restores connection settings changed by beginBulkImport
+  virtual void endBulkImport () {}
+
+  /// @brief Returns number of statements re-used from the prepared statement cache
+  virtual size_t statementCacheHits () const { return 0; }
+  /// @brief Returns number of statements which had to be prepared
+  virtual size_t statementCacheMisses () const { return 0; }
+
   virtual std::map <std::string, DBTableInfo> getTableInfo ()=0;
   virtual std::vector <std::string> getDatabases()=0;
 
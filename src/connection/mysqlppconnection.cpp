@@ -38,26 +38,42 @@
 
 #include <iostream>
 #include <fstream>
+#include <limits>
+#include <cstdlib>
 
 #include <QMessageBox>
 #include <QProgressDialog>
 #include <QMessageBox>
 #include <QCoreApplication>
+#include <QDir>
+#include <QTemporaryFile>
 
 using namespace Utils;
 
 MySQLppConnection::MySQLppConnection(const std::string &class_id, const std::string &instance_id,
                                      DBInterface *interface)
     : DBConnection (class_id, instance_id, interface), interface_(*interface), connection_(mysqlpp::Connection ()),
-      prepared_query_(connection_.query()), prepared_parameters_(mysqlpp::SQLQueryParms(&prepared_query_))
+      prepared_query_(connection_.query()), prepared_parameters_(mysqlpp::SQLQueryParms(&prepared_query_)),
+      statement_cache_(0, [] (std::shared_ptr<BindQuery>& query) { query = nullptr; })
 {
     registerParameter("used_server", &used_server_, "");
+    registerParameter("statement_cache_size", &statement_cache_size_, 64);
+    registerParameter("use_load_data_infile", &use_load_data_infile_, false);
+
+    statement_cache_.capacity(statement_cache_size_);
 
     connection_.set_option(new mysqlpp::LocalInfileOption(true));
 
     createSubConfigurables ();
 }
 
+MySQLppConnection::MySQLppConnection(DBInterface &interface)
+    : interface_(interface), connection_(mysqlpp::Connection ()), prepared_query_(connection_.query()),
+      prepared_parameters_(mysqlpp::SQLQueryParms(&prepared_query_)),
+      statement_cache_(0, [] (std::shared_ptr<BindQuery>& query) { query = nullptr; })
+{
+}
+
 MySQLppConnection::~MySQLppConnection()
 {
 }
@@ -131,8 +147,58 @@ void MySQLppConnection::openDatabase (const std::string &database_name)
     //performanceTest ();
 }
 
+std::unique_ptr<DBConnection> MySQLppConnection::createReadConnection ()
+{
+    assert (connection_ready_);
+    assert (connected_server_);
+
+    loginf << "MySQLppConnection: createReadConnection: database '" << used_database_ << "'";
+
+    std::unique_ptr<MySQLppConnection> connection {new MySQLppConnection (interface_)};
+
+    bool ret = connection->connection_.connect(used_database_.c_str(), connected_server_->host().c_str(),
+                                               connected_server_->user().c_str(),
+                                               connected_server_->password().c_str(), connected_server_->port());
+    if (!ret)
+        throw std::runtime_error("MySQLppConnection: createReadConnection: connect failed with error "
+                                 + std::to_string(connection->connection_.errnum()) + ": "
+                                 + connection->connection_.error());
+
+    connection->used_database_ = used_database_;
+    connection->statement_cache_size_ = statement_cache_size_;
+    connection->use_load_data_infile_ = use_load_data_infile_;
+    connection->statement_cache_.capacity(statement_cache_size_);
+    connection->connection_ready_ = true;
+
+    return std::move(connection);
+}
+
+void MySQLppConnection::beginBulkImport ()
+{
+    loginf << "MySQLppConnection: beginBulkImport";
+    assert (connection_ready_);
+
+    executeSQL("SET unique_checks = 0;");
+    executeSQL("SET foreign_key_checks = 0;");
+}
+
+void MySQLppConnection::endBulkImport ()
+{
+    loginf << "MySQLppConnection: endBulkImport";
+    assert (connection_ready_);
+
+    executeSQL("SET unique_checks = 1;");
+    executeSQL("SET foreign_key_checks = 1;");
+}
+
 void MySQLppConnection::disconnect()
 {
+    loginf << "MySQLppConnection: disconnect: statement cache hits " << statement_cache_.hits() << " misses "
+           << statement_cache_.misses();
+
+    bind_query_ = nullptr;
+    statement_cache_.clear(); // queries refer to the connection
+
     connection_.disconnect();
     connection_ready_ = false;
 
@@ -193,9 +259,17 @@ void MySQLppConnection::prepareBindStatement (const std::string &statement)
     logdbg  << "MySQLppConnection: prepareBindStatement: statement prepare '" <<statement << "'";
 
     assert (!query_used_);
-    prepared_query_.reset();
-    prepared_query_ << statement;
-    prepared_query_.parse();
+    assert (!bind_query_);
+
+    bind_query_sql_ = statement;
+
+    if (!statement_cache_.take(statement, bind_query_))
+    {
+        bind_query_.reset(new BindQuery (connection_.query()));
+        bind_query_->query_ << statement;
+        bind_query_->query_.parse();
+    }
+
     query_used_=true;
 
     if (info_widget_)
@@ -210,14 +284,18 @@ void MySQLppConnection::beginBindTransaction ()
 
 void MySQLppConnection::stepAndClearBindings ()
 {
-    logdbg  << "DBInterface: stepAndClearBindings: stepping statement '" << prepared_query_.str(prepared_parameters_)<< "'";
+    assert (bind_query_);
 
-    if (!prepared_query_.execute(prepared_parameters_))
+    logdbg  << "DBInterface: stepAndClearBindings: stepping statement '"
+            << bind_query_->query_.str(bind_query_->parameters_)<< "'";
+
+    if (!bind_query_->query_.execute(bind_query_->parameters_))
     {
-        logerr  << "MySQLppConnection: stepAndClearBindings: error when executing '" << prepared_query_.error() << "'";
+        logerr  << "MySQLppConnection: stepAndClearBindings: error when executing '" << bind_query_->query_.error()
+                << "'";
         throw std::runtime_error("MySQLppConnection: stepAndClearBindings: error when executing");
     }
-    prepared_parameters_.clear();
+    bind_query_->parameters_.clear();
 }
 
 void MySQLppConnection::endBindTransaction ()
@@ -230,8 +308,11 @@ void MySQLppConnection::endBindTransaction ()
 void MySQLppConnection::finalizeBindStatement ()
 {
     assert (query_used_);
+    assert (bind_query_);
 
-    prepared_query_.reset();
+    bind_query_->parameters_.clear();
+    statement_cache_.put(bind_query_sql_, bind_query_);
+    bind_query_ = nullptr;
     query_used_=false;
 
     if (info_widget_)
@@ -241,23 +322,330 @@ void MySQLppConnection::finalizeBindStatement ()
 void MySQLppConnection::bindVariable (unsigned int index, int value)
 {
     logdbg  << "MySQLppConnection: bindVariable: index " << index << " value '" << value << "'";
-    prepared_parameters_[index] = value;
+    assert (bind_query_);
+    bind_query_->parameters_[index] = value;
 }
 void MySQLppConnection::bindVariable (unsigned int index, double value)
 {
     logdbg  << "MySQLppConnection: bindVariable: index " << index << " value '" << value << "'";
-    prepared_parameters_[index] = value;
+    assert (bind_query_);
+    bind_query_->parameters_[index] = value;
 }
 void MySQLppConnection::bindVariable (unsigned int index, const std::string &value)
 {
     logdbg  << "MySQLppConnection: bindVariable: index " << index << " value '" << value << "'";
-    prepared_parameters_[index] = value.c_str();
+    assert (bind_query_);
+    bind_query_->parameters_[index] = value.c_str();
+}
+
+void MySQLppConnection::bindColumns (const std::vector<ColumnHandle>& columns, size_t from_index, size_t to_index)
+{
+    logdbg  << "MySQLppConnection: bindColumns: " << columns.size() << " columns from " << from_index << " to "
+            << to_index;
+
+    assert (bind_query_);
+
+    mysqlpp::Query& query = bind_query_->query_;
+    mysqlpp::SQLQueryParms& parameters = bind_query_->parameters_;
+    unsigned int num_columns = columns.size();
+
+    for (size_t row=from_index; row <= to_index; ++row)
+    {
+        for (unsigned int cnt=0; cnt < num_columns; ++cnt)
+        {
+            const ColumnHandle& column = columns[cnt];
+
+            if (column.isNull(row))
+            {
+                parameters[cnt+1] = mysqlpp::null;
+                continue;
+            }
+
+            switch (column.dataType())
+            {
+            case PropertyDataType::BOOL:
+                parameters[cnt+1] = static_cast<int> (column.get<bool>().data()[row]);
+                break;
+            case PropertyDataType::CHAR:
+                parameters[cnt+1] = static_cast<int> (column.get<char>().data()[row]);
+                break;
+            case PropertyDataType::UCHAR:
+                parameters[cnt+1] = static_cast<int> (column.get<unsigned char>().data()[row]);
+                break;
+            case PropertyDataType::INT:
+                parameters[cnt+1] = column.get<int>().data()[row];
+                break;
+            case PropertyDataType::UINT:
+                parameters[cnt+1] = column.get<unsigned int>().data()[row];
+                break;
+            case PropertyDataType::LONGINT:
+                parameters[cnt+1] = static_cast<mysqlpp::longlong> (column.get<long int>().data()[row]);
+                break;
+            case PropertyDataType::ULONGINT:
+                parameters[cnt+1] =
+                        static_cast<mysqlpp::ulonglong> (column.get<unsigned long int>().data()[row]);
+                break;
+            case PropertyDataType::FLOAT:
+                parameters[cnt+1] = static_cast<double> (column.get<float>().data()[row]);
+                break;
+            case PropertyDataType::DOUBLE:
+                parameters[cnt+1] = column.get<double>().data()[row];
+                break;
+            case PropertyDataType::STRING:
+                parameters[cnt+1] = "'"+column.get<std::string>().data()[row]+"'";
+                break;
+            default:
+                logerr  <<  "MySQLppConnection: bindColumns: unknown property type "
+                         << Property::asString(column.dataType());
+                throw std::runtime_error ("MySQLppConnection: bindColumns: unknown property type "
+                                          + Property::asString(column.dataType()));
+            }
+        }
+
+        if (!query.execute(parameters))
+        {
+            logerr  << "MySQLppConnection: bindColumns: error when executing '" << query.error() << "'";
+            throw std::runtime_error("MySQLppConnection: bindColumns: error when executing");
+        }
+
+        parameters.clear();
+    }
+}
+
+bool MySQLppConnection::insertColumns (const std::string& table_name, const PropertyList& properties,
+                                       const std::vector<ColumnHandle>& columns, size_t from_index,
+                                       size_t to_index)
+{
+    loginf  << "MySQLppConnection: insertColumns: table " << table_name << " " << to_index-from_index+1
+            << " rows load data " << use_load_data_infile_;
+
+    assert (!query_used_);
+    assert (properties.size() == columns.size());
+    assert (columns.size());
+
+    std::string column_names;
+
+    for (unsigned int cnt=0; cnt < properties.size(); ++cnt)
+    {
+        if (cnt)
+            column_names += ", ";
+
+        column_names += properties.at(cnt).name();
+    }
+
+    if (use_load_data_infile_)
+        insertLoadData(table_name, column_names, columns, from_index, to_index);
+    else
+        insertMultiRow(table_name, column_names, columns, from_index, to_index);
+
+    return true;
+}
+
+void MySQLppConnection::insertMultiRow (const std::string& table_name, const std::string& column_names,
+                                        const std::vector<ColumnHandle>& columns, size_t from_index,
+                                        size_t to_index)
+{
+    if (!max_allowed_packet_)
+    {
+        mysqlpp::Query query = connection_.query("SELECT @@max_allowed_packet");
+        mysqlpp::StoreQueryResult result = query.store();
+
+        if (!result || result.num_rows() != 1)
+            throw std::runtime_error ("MySQLppConnection: insertMultiRow: max_allowed_packet query failed '"
+                                      +std::string(query.error())+"'");
+
+        max_allowed_packet_ = std::stoul(std::string(result[0][0].c_str()));
+        loginf << "MySQLppConnection: insertMultiRow: max_allowed_packet " << max_allowed_packet_;
+    }
+
+    // leave room for protocol overhead and the last row appended
+    size_t max_statement_size = max_allowed_packet_ * 3 / 4;
+
+    std::string prefix = "INSERT INTO "+table_name+" ("+column_names+") VALUES ";
+    std::string statement;
+    std::string row_values;
+    unsigned int num_columns = columns.size();
+    unsigned int num_statements = 0;
+
+    mysqlpp::Transaction transaction (connection_);
+
+    for (size_t row=from_index; row <= to_index; ++row)
+    {
+        row_values = "(";
+
+        for (unsigned int cnt=0; cnt < num_columns; ++cnt)
+        {
+            if (cnt)
+                row_values += ',';
+
+            appendValue(row_values, columns[cnt], row, false);
+        }
+
+        row_values += ')';
+
+        if (statement.size() && statement.size() + row_values.size() + 1 > max_statement_size)
+        {
+            executeSQL(statement);
+            ++num_statements;
+            statement.clear();
+        }
+
+        if (statement.size())
+            statement += ',';
+        else
+            statement = prefix;
+
+        statement += row_values;
+    }
+
+    if (statement.size())
+    {
+        executeSQL(statement);
+        ++num_statements;
+    }
+
+    transaction.commit();
+
+    logdbg << "MySQLppConnection: insertMultiRow: inserted with " << num_statements << " statements";
+}
+
+void MySQLppConnection::insertLoadData (const std::string& table_name, const std::string& column_names,
+                                        const std::vector<ColumnHandle>& columns, size_t from_index,
+                                        size_t to_index)
+{
+    QTemporaryFile file (QDir::tempPath()+"/atsdb_load_XXXXXX.tsv");
+
+    if (!file.open())
+        throw std::runtime_error ("MySQLppConnection: insertLoadData: unable to create temporary file");
+
+    const size_t flush_size = 1 << 20;
+    std::string data;
+    unsigned int num_columns = columns.size();
+
+    for (size_t row=from_index; row <= to_index; ++row)
+    {
+        for (unsigned int cnt=0; cnt < num_columns; ++cnt)
+        {
+            if (cnt)
+                data += '\t';
+
+            appendValue(data, columns[cnt], row, true);
+        }
+
+        data += '\n';
+
+        if (data.size() >= flush_size || row == to_index)
+        {
+            if (file.write(data.data(), data.size()) != static_cast<qint64> (data.size()))
+                throw std::runtime_error ("MySQLppConnection: insertLoadData: unable to write temporary file");
+
+            data.clear();
+        }
+    }
+
+    file.flush();
+
+    std::string file_name = file.fileName().toStdString();
+    loginf << "MySQLppConnection: insertLoadData: loading file '" << file_name << "' size " << file.size();
+
+    executeSQL("LOAD DATA LOCAL INFILE '"+file_name+"' INTO TABLE "+table_name
+               +" FIELDS TERMINATED BY '\\t' ESCAPED BY '\\\\' LINES TERMINATED BY '\\n' ("+column_names+")");
+}
+
+void MySQLppConnection::appendValue (std::string& out, const ColumnHandle& column, size_t row, bool load_data)
+{
+    if (column.isNull(row))
+    {
+        out += load_data ? "\\N" : "NULL";
+        return;
+    }
+
+    char number[32];
+
+    switch (column.dataType())
+    {
+    case PropertyDataType::BOOL:
+        out += column.get<bool>().data()[row] ? '1' : '0';
+        break;
+    case PropertyDataType::CHAR:
+        out += std::to_string(static_cast<int> (column.get<char>().data()[row]));
+        break;
+    case PropertyDataType::UCHAR:
+        out += std::to_string(static_cast<int> (column.get<unsigned char>().data()[row]));
+        break;
+    case PropertyDataType::INT:
+        out += std::to_string(column.get<int>().data()[row]);
+        break;
+    case PropertyDataType::UINT:
+        out += std::to_string(column.get<unsigned int>().data()[row]);
+        break;
+    case PropertyDataType::LONGINT:
+        out += std::to_string(column.get<long int>().data()[row]);
+        break;
+    case PropertyDataType::ULONGINT:
+        out += std::to_string(column.get<unsigned long int>().data()[row]);
+        break;
+    case PropertyDataType::FLOAT:
+        snprintf (number, sizeof(number), "%.*g", std::numeric_limits<float>::max_digits10,
+                  static_cast<double> (column.get<float>().data()[row]));
+        out += number;
+        break;
+    case PropertyDataType::DOUBLE:
+        snprintf (number, sizeof(number), "%.*g", std::numeric_limits<double>::max_digits10,
+                  column.get<double>().data()[row]);
+        out += number;
+        break;
+    case PropertyDataType::STRING:
+    {
+        const std::string& value = column.get<std::string>().data()[row];
+
+        if (load_data)
+        {
+            for (char character : value)
+            {
+                switch (character)
+                {
+                case '\\':
+                    out += "\\\\";
+                    break;
+                case '\t':
+                    out += "\\t";
+                    break;
+                case '\n':
+                    out += "\\n";
+                    break;
+                case '\r':
+                    out += "\\r";
+                    break;
+                default:
+                    out += character;
+                }
+            }
+        }
+        else
+        {
+            std::string escaped;
+            prepared_query_.escape_string(&escaped, value.data(), value.size());
+
+            out += '\'';
+            out += escaped;
+            out += '\'';
+        }
+        break;
+    }
+    default:
+        logerr  <<  "MySQLppConnection: appendValue: unknown property type "
+                 << Property::asString(column.dataType());
+        throw std::runtime_error ("MySQLppConnection: appendValue: unknown property type "
+                                  + Property::asString(column.dataType()));
+    }
 }
 
 void MySQLppConnection::bindVariableNull (unsigned int index)
 {
     logdbg  << "MySQLppConnection: bindVariableNull: index " << index ;
-    prepared_parameters_[index] = mysqlpp::null;
+    assert (bind_query_);
+    bind_query_->parameters_[index] = mysqlpp::null;
 }
 
 
@@ -337,11 +725,25 @@ void MySQLppConnection::execute (const std::string &command, std::shared_ptr <Bu
     // Display results
     size_t cnt = buffer->size();
 
+    std::vector<ColumnHandle> columns = buffer->columns();
+    std::vector<const char*> values (num_properties);
+    std::vector<unsigned long> lengths (num_properties);
+
     mysqlpp::StoreQueryResult::const_iterator it;
     for (it = res.begin(); it != res.end(); ++it)
     {
-        mysqlpp::Row row = *it;
-        readRowIntoBuffer (row, list, num_properties, buffer, cnt);
+        const mysqlpp::Row& row = *it;
+
+        for (unsigned int col_cnt=0; col_cnt < num_properties; ++col_cnt)
+        {
+            if (row[col_cnt].is_null())
+                values[col_cnt] = nullptr;
+            else
+                values[col_cnt] = row[col_cnt].data() ? row[col_cnt].data() : ""; // empty strings may have no data
+            lengths[col_cnt] = row[col_cnt].length();
+        }
+
+        readRowIntoBuffer (values.data(), lengths.data(), columns, cnt);
         cnt++;
     }
 
@@ -350,79 +752,59 @@ void MySQLppConnection::execute (const std::string &command, std::shared_ptr <Bu
     logdbg  << "MySQLppConnection: execute done with size " << buffer->size();
 }
 
-void MySQLppConnection::readRowIntoBuffer (mysqlpp::Row &row, const PropertyList &list, unsigned int num_properties,
-                                           std::shared_ptr <Buffer> buffer, unsigned int index)
+void MySQLppConnection::readRowIntoBuffer (const char* const* values, const unsigned long* lengths,
+                                           const std::vector<ColumnHandle>& columns, unsigned int index)
 {
-    //logdbg << "MySQLppConnection::readRowIntoBuffer: start buffer size " << buffer->size() << " index " << index;
-    for (unsigned int cnt=0; cnt < num_properties; cnt++)
+    unsigned int num_columns = columns.size();
+
+    for (unsigned int cnt=0; cnt < num_columns; cnt++)
     {
-            const Property &prop=list.at(cnt);
+        const char* value = values[cnt];
 
-            switch (prop.dataType())
-            {
-            case PropertyDataType::BOOL:
-                if (row[cnt] != mysqlpp::null)
-                    buffer->get<bool>(prop.name()).set(index, static_cast<bool> (row[cnt]));
-//                else
-//                    buffer->get<bool>(prop.name()).setNone(index);
-                //loginf  << "sqlex: bool " << prop->id_ << " val " << *ptr;
-                break;
-            case PropertyDataType::UCHAR:
-                if (row[cnt] != mysqlpp::null)
-                    buffer->get<unsigned char>(prop.name()).set(index, static_cast<unsigned char> (row[cnt]));
-//                else
-//                    buffer->get<unsigned char>(prop.name()).setNone(index);
-                //loginf  << "sqlex: uchar " << prop->id_ << " val " << *ptr;
-                break;
-            case PropertyDataType::CHAR:
-                if (row[cnt] != mysqlpp::null)
-                    buffer->get<char>(prop.name()).set(index, static_cast<signed char> (row[cnt]));
-//                else
-//                    buffer->get<char>(prop.name()).setNone(index);
-                //loginf  << "sqlex: char " << prop->id_ << " val " << *ptr;
-                break;
-            case PropertyDataType::INT:
-                if (row[cnt] != mysqlpp::null)
-                    buffer->get<int>(prop.name()).set(index, static_cast<int> (row[cnt]));
-//                else
-//                    buffer->get<int>(prop.name()).setNone(index);
-                //loginf  << "sqlex: int " << prop->id_ << " val " << *ptr;
-                break;
-            case PropertyDataType::UINT:
-                if (row[cnt] != mysqlpp::null)
-                    buffer->get<unsigned int>(prop.name()).set(index, static_cast<unsigned int> (row[cnt]));
-//                else
-//                    buffer->get<unsigned int>(prop.name()).setNone(index);
-                //loginf  << "sqlex: uint " << prop->id_ << " val " << *ptr;
-                break;
-            case PropertyDataType::STRING:
-                if (row[cnt] != mysqlpp::null)
-                    buffer->get<std::string>(prop.name()).set(index, static_cast<const char *> (row[cnt]));
-//                else
-//                    buffer->get<std::string>(prop.name()).setNone(index);
-                //loginf  << "sqlex: string " << prop->id_ << " val " << *ptr;
-                break;
-            case PropertyDataType::FLOAT:
-                if (row[cnt] != mysqlpp::null)
-                    buffer->get<float>(prop.name()).set(index, static_cast<float> (row[cnt]));
-//                else
-//                    buffer->get<float>(prop.name()).setNone(index);
-                //loginf  << "sqlex: float " << prop->id_ << " val " << *ptr;
-                break;
-            case PropertyDataType::DOUBLE:
-                if (row[cnt] != mysqlpp::null)
-                    buffer->get<double>(prop.name()).set(index, static_cast<double> (row[cnt]));
-//                else
-//                    buffer->get<double>(prop.name()).setNone(index);
-                //loginf  << "sqlex: double " << prop->id_ << " val " << *ptr;
-                break;
-            default:
-                logerr  <<  "MySQLppConnection: readRowIntoBuffer: unknown property type";
-                throw std::runtime_error ("MySQLppConnection: readRowIntoBuffer: unknown property type");
-                break;
-            }
+        if (!value) // null
+            continue;
+
+        const ColumnHandle& column = columns[cnt];
+
+        // text protocol values are null-terminated, parsed directly instead of through mysqlpp::String
+        switch (column.dataType())
+        {
+        case PropertyDataType::BOOL:
+            column.get<bool>().set(index, std::strtol(value, nullptr, 10) != 0);
+            break;
+        case PropertyDataType::UCHAR:
+            column.get<unsigned char>().set(index, static_cast<unsigned char> (std::strtol(value, nullptr, 10)));
+            break;
+        case PropertyDataType::CHAR:
+            column.get<char>().set(index, static_cast<signed char> (std::strtol(value, nullptr, 10)));
+            break;
+        case PropertyDataType::INT:
+            column.get<int>().set(index, static_cast<int> (std::strtol(value, nullptr, 10)));
+            break;
+        case PropertyDataType::UINT:
+            column.get<unsigned int>().set(index, static_cast<unsigned int> (std::strtoul(value, nullptr, 10)));
+            break;
+        case PropertyDataType::LONGINT:
+            column.get<long int>().set(index, std::strtol(value, nullptr, 10));
+            break;
+        case PropertyDataType::ULONGINT:
+            column.get<unsigned long int>().set(index, std::strtoul(value, nullptr, 10));
+            break;
+        case PropertyDataType::STRING:
+            column.get<std::string>().set(index, value, lengths[cnt]);
+            break;
+        case PropertyDataType::FLOAT:
+            column.get<float>().set(index, std::strtof(value, nullptr));
+            break;
+        case PropertyDataType::DOUBLE:
+            column.get<double>().set(index, std::strtod(value, nullptr));
+            break;
+        default:
+            logerr  <<  "MySQLppConnection: readRowIntoBuffer: unknown property type";
+            throw std::runtime_error ("MySQLppConnection: readRowIntoBuffer: unknown property type");
+            break;
+        }
     }
-    //logdbg << "MySQLppConnection::readRowIntoBuffer: end buffer size " << buffer->size() << " index " << index;
 }
 
 void MySQLppConnection::execute (const std::string &command)
@@ -516,18 +898,20 @@ std::shared_ptr <DBResult> MySQLppConnection::stepPreparedCommand (unsigned int
     assert (buffer->size() == 0);
     std::shared_ptr <DBResult> dbresult (new DBResult(buffer));
 
-    unsigned int num_properties = buffer->properties().size();
-    const PropertyList &list = buffer->properties();
+    std::vector<ColumnHandle> columns = buffer->columns();
     unsigned int cnt = 0;
 
     bool done=true;
 
     max_results--;
 
-    while (mysqlpp::Row row = result_step_.fetch_row())
+    // raw rows of the unbuffered result, without creation of mysqlpp::Row objects
+    while (MYSQL_ROW row = result_step_.fetch_raw_row())
     {
-        readRowIntoBuffer (row, list, num_properties, buffer, cnt);
-        assert (buffer->size() == cnt+1);
+        readRowIntoBuffer (row, result_step_.fetch_lengths(), columns, cnt);
+
+        if (buffer->size()) // 0 == 1 otherwise
+            assert (buffer->size() == cnt+1);
 
         if (max_results != 0 && cnt >= max_results)
         {
@@ -561,7 +945,7 @@ void MySQLppConnection::finalizeCommand ()
     //assert (prepared_command_done_); true if ok, false if quit job
 
     bool first = true;
-    while (mysqlpp::Row row = result_step_.fetch_row())
+    while (result_step_.fetch_raw_row())
         if (first)
         {
             loginf << "MySQLppConnection: finalizeCommand: stepping through result set to finalize";
@@ -865,62 +1249,83 @@ void MySQLppConnection::importSQLFile (const std::string& filename)
     size_t line_cnt = 0;
     size_t byte_cnt = 0;
     size_t error_cnt = 0;
+    size_t uncommitted_bytes = 0;
+
+    interface_.startBulkImport();
 
-    while (getline (sql_file,line))
+    try
     {
-        try
+        while (getline (sql_file,line))
         {
-            byte_cnt += line.size();
-
-            if (line.find ("delimiter") != std::string::npos || line.find ("DELIMITER") != std::string::npos
-                    || line.find ("VIEW") != std::string::npos)
+            try
             {
-                loginf << "MySQLppConnection: importSQLFile: breaking at delimiter, bytes " << byte_cnt;
-                break;
-            }
+                byte_cnt += line.size();
 
-            ss << line << '\n';
+                if (line.find ("delimiter") != std::string::npos || line.find ("DELIMITER") != std::string::npos
+                        || line.find ("VIEW") != std::string::npos)
+                {
+                    loginf << "MySQLppConnection: importSQLFile: breaking at delimiter, bytes " << byte_cnt;
+                    break;
+                }
 
-            if (line.back() == ';')
-            {
-                //                loginf << "MySQLppConnection: importSQLFile: line cnt " << line_cnt << " of " << line_count
-                //                       << " strlen " << ss.str().size() << "'";
+                ss << line << '\n';
 
-                if (ss.str().size())
-                    executeSQL (ss.str());
+                if (line.back() == ';')
+                {
+                    // loginf << "MySQLppConnection: importSQLFile: line cnt " << line_cnt << " of " << line_count
+                    //        << " strlen " << ss.str().size() << "'";
 
-                ss.str("");
-            }
+                    if (ss.str().size())
+                        executeImportSQL (ss.str(), uncommitted_bytes);
 
-            if (line_cnt % 10 == 0)
-            {
-                progress_dialog->setValue(100*byte_cnt/file_byte_size);
-                QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-            }
+                    ss.str("");
+                }
 
-            line_cnt ++;
-        }
-        catch (std::exception& e)
-        {
-            logwrn << "MySQLppConnection: importSQLFile: sql error '" << e.what() << "'";
-            ss.str("");
-            error_cnt++;
+                if (line_cnt % 10 == 0)
+                {
+                    progress_dialog->setValue(100*byte_cnt/file_byte_size);
+                    QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+                }
 
-            if (error_cnt > 3)
+                line_cnt ++;
+            }
+            catch (std::exception& e)
             {
-                logwrn << "MySQLppConnection: importSQLFile: quit after too many errors";
+                logwrn << "MySQLppConnection: importSQLFile: sql error '" << e.what() << "'";
+                ss.str("");
+                error_cnt++;
 
-                QMessageBox m_warning (QMessageBox::Warning, "MySQL Text Import Failed",
-                                       "Quit after too many SQL errors. Please make sure that"
-                                       " the SQL file is correct.",
-                                       QMessageBox::Ok);
-                m_warning.exec();
+                if (error_cnt > 3)
+                {
+                    logwrn << "MySQLppConnection: importSQLFile: quit after too many errors";
 
-                break;
+                    QMessageBox m_warning (QMessageBox::Warning, "MySQL Text Import Failed",
+                                           "Quit after too many SQL errors. Please make sure that"
+                                           " the SQL file is correct.",
+                                           QMessageBox::Ok);
+                    m_warning.exec();
+
+                    break;
+                }
             }
+
         }
 
+        commitImportSQL (uncommitted_bytes);
     }
+    catch (std::exception& e)
+    {
+        logerr << "MySQLppConnection: importSQLFile: import failed: " << e.what();
+
+        rollbackImportSQL (uncommitted_bytes);
+        interface_.endBulkImport(); // restores indexes
+
+        delete progress_dialog;
+        throw;
+    }
+
+    interface_.endBulkImport();
+
     delete progress_dialog;
     progress_dialog = nullptr;
 
@@ -979,6 +1384,9 @@ void MySQLppConnection::importSQLArchiveFile(const std::string& filename)
     size_t line_cnt = 0;
     size_t error_cnt = 0;
     size_t byte_cnt = 0;
+    size_t uncommitted_bytes = 0;
+
+    interface_.startBulkImport();
 
     QMessageBox msg_box;
     std::string msg = "Importing archive '"+filename+"'.";
@@ -989,117 +1397,137 @@ void MySQLppConnection::importSQLArchiveFile(const std::string& filename)
     for (unsigned int cnt=0; cnt < 10; cnt++)
         QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
 
-    while (archive_read_next_header(a, &entry) == ARCHIVE_OK)
+    try
     {
-        loginf << "Archive file found: " << archive_entry_pathname(entry) << " size " << archive_entry_size(entry);
-
-        msg_box.setInformativeText(archive_entry_pathname(entry));
-
-        bool done=false;
-
-        std::stringstream ss;
-
-        for (;;)
+        while (archive_read_next_header(a, &entry) == ARCHIVE_OK)
         {
-            r = archive_read_data_block(a, &buff, &size, &offset);
-
-            if (r == ARCHIVE_EOF)
-                break;
-            if (r != ARCHIVE_OK)
-                throw std::runtime_error("MySQLppConnection: importSQLArchiveFile: archive error: "
-                                         +std::string(archive_error_string(a)));
+            loginf << "Archive file found: " << archive_entry_pathname(entry) << " size "
+                   << archive_entry_size(entry);
 
-            std::string str (reinterpret_cast<char const*>(buff), size);
+            msg_box.setInformativeText(archive_entry_pathname(entry));
 
-            //loginf << "UGA read offset " << offset << " size " << size;
+            bool done=false;
 
-            std::vector<std::string> lines = String::split(str, '\n');
-            std::string line;
+            std::stringstream ss;
 
-            //loginf << "UGA read str has " << lines.size() << " lines";
-
-            for (std::vector<std::string>::iterator line_it = lines.begin(); line_it != lines.end(); line_it++)
+            for (;;)
             {
-                if (line_it + 1 == lines.end() )
-                {
-                    //loginf << "last one";
-                    ss << *line_it;
+                r = archive_read_data_block(a, &buff, &size, &offset);
+
+                if (r == ARCHIVE_EOF)
                     break;
-                }
+                if (r != ARCHIVE_OK)
+                    throw std::runtime_error("MySQLppConnection: importSQLArchiveFile: archive error: "
+                                             +std::string(archive_error_string(a)));
 
-                try
-                {
-                    ss << *line_it << '\n';
+                std::string str (reinterpret_cast<char const*>(buff), size);
 
-                    line = ss.str();
+                //loginf << "UGA read offset " << offset << " size " << size;
 
-                    byte_cnt += line.size();
+                std::vector<std::string> lines = String::split(str, '\n');
+                std::string line;
 
-                    if (line.find ("delimiter") != std::string::npos || line.find ("DELIMITER") != std::string::npos
-                            || line.find ("VIEW") != std::string::npos)
+                //loginf << "UGA read str has " << lines.size() << " lines";
+
+                for (std::vector<std::string>::iterator line_it = lines.begin(); line_it != lines.end(); line_it++)
+                {
+                    if (line_it + 1 == lines.end() )
                     {
-                        loginf << "MySQLppConnection: importSQLArchiveFile: breaking at delimiter, bytes " << byte_cnt;
-                        done = true;
+                        //loginf << "last one";
+                        ss << *line_it;
                         break;
                     }
 
-                    if (line_it->back() == ';')
+                    try
                     {
-                        //                        loginf << "MySQLppConnection: importSQLArchiveFile: line cnt " << line_cnt
-                        //                               <<  " strlen " << ss.str().size() << "'";
-
-                        if (line.size())
-                            executeSQL (line+"\n");
-
-                        ss.str("");
+                        ss << *line_it << '\n';
+
+                        line = ss.str();
+
+                        byte_cnt += line.size();
+
+                        if (line.find ("delimiter") != std::string::npos || line.find ("DELIMITER") != std::string::npos
+                                || line.find ("VIEW") != std::string::npos)
+                        {
+                            loginf << "MySQLppConnection: importSQLArchiveFile: breaking at delimiter, bytes "
+                                   << byte_cnt;
+                            done = true;
+                            break;
+                        }
+
+                        if (line_it->back() == ';')
+                        {
+                            // loginf << "MySQLppConnection: importSQLArchiveFile: line cnt " << line_cnt
+                            //        <<  " strlen " << ss.str().size() << "'";
+
+                            if (line.size())
+                                executeImportSQL (line+"\n", uncommitted_bytes);
+
+                            ss.str("");
+                        }
+
+                        if (line_cnt % 10 == 0)
+                        {
+                            logdbg << "MySQLppConnection: importSQLArchiveFile: line cnt " << line_cnt;
+                            msg = "Read " + std::to_string(line_cnt) + " lines from "
+                                    + std::string(archive_entry_pathname(entry)) + " archive entry.";
+
+                            msg_box.setInformativeText(msg.c_str());
+                            msg_box.show();
+                            QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+                            // progress_dialog->setValue(100*byte_cnt/file_byte_size);
+                            // QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+                        }
+
+                        line_cnt ++;
                     }
-
-                    if (line_cnt % 10 == 0)
+                    catch (std::exception& e)
                     {
-                        logdbg << "MySQLppConnection: importSQLArchiveFile: line cnt " << line_cnt;
-                        msg = "Read " + std::to_string(line_cnt) + " lines from "
-                                + std::string(archive_entry_pathname(entry)) + " archive entry.";
-
-                        msg_box.setInformativeText(msg.c_str());
-                        msg_box.show();
-                        QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-                        //                        progress_dialog->setValue(100*byte_cnt/file_byte_size);
-                        //                        QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+                        logwrn << "MySQLppConnection: importSQLArchiveFile: sql error '" << e.what() << "'";
+                        ss.str("");
+                        error_cnt++;
+
+                        if (error_cnt > 3)
+                        {
+                            logwrn << "MySQLppConnection: importSQLArchiveFile: quit after too many errors";
+
+                            QMessageBox m_warning (QMessageBox::Warning, "MySQL Archive Import Failed",
+                                                   "Quit after too many SQL errors. Please make sure that"
+                                                   " the archive is correct as specified in the user manual.",
+                                                   QMessageBox::Ok);
+                            m_warning.exec();
+                            done=true;
+                            break;
+                        }
                     }
-
-                    line_cnt ++;
                 }
-                catch (std::exception& e)
-                {
-                    logwrn << "MySQLppConnection: importSQLArchiveFile: sql error '" << e.what() << "'";
-                    ss.str("");
-                    error_cnt++;
 
-                    if (error_cnt > 3)
-                    {
-                        logwrn << "MySQLppConnection: importSQLArchiveFile: quit after too many errors";
-
-                        QMessageBox m_warning (QMessageBox::Warning, "MySQL Archive Import Failed",
-                                               "Quit after too many SQL errors. Please make sure that"
-                                               " the archive is correct as specified in the user manual.",
-                                               QMessageBox::Ok);
-                        m_warning.exec();
-                        done=true;
-                        break;
-                    }
-                }
+                if (done)
+                    break;
             }
 
             if (done)
                 break;
+
+            loginf << "MySQLppConnection: importSQLArchiveFile: archive file " << archive_entry_pathname(entry)
+                   << " imported";
         }
 
-        if (done)
-            break;
+        commitImportSQL (uncommitted_bytes);
+    }
+    catch (std::exception& e)
+    {
+        logerr << "MySQLppConnection: importSQLArchiveFile: import failed: " << e.what();
 
-        loginf << "MySQLppConnection: importSQLArchiveFile: archive file " << archive_entry_pathname(entry) << " imported";
+        rollbackImportSQL (uncommitted_bytes);
+        interface_.endBulkImport(); // restores indexes
+
+        archive_read_free(a);
+        throw;
     }
 
+    interface_.endBulkImport();
+
     msg_box.close();
 
     QMessageBox msgBox;
@@ -1125,6 +1553,68 @@ void MySQLppConnection::importSQLArchiveFile(const std::string& filename)
     interface_.databaseContentChanged();
 }
 
+void MySQLppConnection::executeImportSQL (const std::string& sql, size_t& uncommitted_bytes)
+{
+    if (!uncommitted_bytes)
+        executeSQL ("START TRANSACTION;");
+
+    uncommitted_bytes += sql.size();
+
+    // only the failing statement is rolled back, as without transaction. replaces savepoint of previous statement
+    executeSQL ("SAVEPOINT import_statement;");
+
+    try
+    {
+        executeSQL (sql);
+    }
+    catch (std::exception&)
+    {
+        try
+        {
+            executeSQL ("ROLLBACK TO SAVEPOINT import_statement;");
+        }
+        catch (std::exception& e) // savepoint lost by implicit commit, e.g. of a table creation
+        {
+            logwrn << "MySQLppConnection: executeImportSQL: rollback to savepoint failed: " << e.what();
+        }
+
+        throw;
+    }
+
+    if (uncommitted_bytes >= interface_.bulkCommitBytes())
+        commitImportSQL(uncommitted_bytes);
+}
+
+void MySQLppConnection::commitImportSQL (size_t& uncommitted_bytes)
+{
+    if (!uncommitted_bytes)
+        return;
+
+    logdbg << "MySQLppConnection: commitImportSQL: committing " << uncommitted_bytes << " bytes";
+
+    executeSQL ("COMMIT;");
+    uncommitted_bytes = 0;
+}
+
+void MySQLppConnection::rollbackImportSQL (size_t& uncommitted_bytes)
+{
+    if (!uncommitted_bytes)
+        return;
+
+    logwrn << "MySQLppConnection: rollbackImportSQL: rolling back " << uncommitted_bytes << " bytes";
+
+    uncommitted_bytes = 0;
+
+    try
+    {
+        executeSQL ("ROLLBACK;");
+    }
+    catch (std::exception& e)
+    {
+        logerr << "MySQLppConnection: rollbackImportSQL: rollback failed: " << e.what();
+    }
+}
+
 //DBResult *MySQLppConnection::readBulkCommand (DBCommand *command, std::string main_statement,
 //std::string order_statement, unsigned int max_results)
 //{
@@ -23,6 +23,7 @@
 
 #include "configurable.h"
 #include "dbconnection.h"
+#include "statementcache.h"
 #include "global.h"
 
 class Buffer;
@@ -53,6 +54,14 @@ public:
     void deleteDatabase (const std::string& database_name);
     void openDatabase (const std::string& database_name);
 
+    std::unique_ptr<DBConnection> createReadConnection () override;
+    /// @brief Returns a read connection, since these are full connections
+    std::unique_ptr<DBConnection> createWriteConnection () override { return createReadConnection(); }
+
+    /// @brief Disables unique and foreign key checks
+    void beginBulkImport () override;
+    void endBulkImport () override;
+
     virtual void disconnect () override;
 
     void executeSQL(const std::string& sql) override;
@@ -67,6 +76,10 @@ public:
     void bindVariable (unsigned int index, double value) override;
     void bindVariable (unsigned int index, const std::string &value) override;
     void bindVariableNull (unsigned int index) override;
+    void bindColumns (const std::vector<ColumnHandle>& columns, size_t from_index, size_t to_index) override;
+    /// @brief Inserts using multi-row INSERT statements, or LOAD DATA LOCAL INFILE if configured
+    bool insertColumns (const std::string& table_name, const PropertyList& properties,
+                        const std::vector<ColumnHandle>& columns, size_t from_index, size_t to_index) override;
 
     std::shared_ptr <DBResult> execute (const DBCommand& command) override;
     std::shared_ptr <DBResult> execute (const DBCommandList& command_list) override;
@@ -101,7 +114,19 @@ public:
     void importSQLFile (const std::string& filename);
     void importSQLArchiveFile (const std::string& filename);
 
+    size_t statementCacheHits () const override { return statement_cache_.hits(); }
+    size_t statementCacheMisses () const override { return statement_cache_.misses(); }
+
 protected:
+    /// @brief Parsed template query with its bound parameters
+    struct BindQuery
+    {
+        BindQuery (mysqlpp::Query query) : query_(query), parameters_(&query_) {}
+
+        mysqlpp::Query query_;
+        mysqlpp::SQLQueryParms parameters_;
+    };
+
     DBInterface& interface_;
     std::string used_server_;
     std::string used_database_;
@@ -115,6 +140,18 @@ protected:
     mysqlpp::Query prepared_query_;
     /// Parameters which are bound to the a query
     mysqlpp::SQLQueryParms prepared_parameters_;
+    /// Query for binding variables to
+    std::shared_ptr<BindQuery> bind_query_;
+    /// SQL of bind_query_, key in statement_cache_
+    std::string bind_query_sql_;
+    /// Maximum number of cached bind queries
+    unsigned int statement_cache_size_ {64};
+    /// Flag if bulk inserts should use LOAD DATA LOCAL INFILE instead of multi-row INSERT statements
+    bool use_load_data_infile_ {false};
+    /// Maximum size of a statement sent to the server, queried on first bulk insert
+    size_t max_allowed_packet_ {0};
+    /// Parsed bind queries not in use
+    StatementCache<std::shared_ptr<BindQuery>> statement_cache_;
     /// Result from query for incremental reading.
     mysqlpp::UseQueryResult result_step_;
     /// Query is in use flag.
@@ -142,12 +179,36 @@ protected:
     /// @brief Executes an SQL command which returns no data (internal)
     void execute (const std::string &command);
 
-    void readRowIntoBuffer (mysqlpp::Row &row, const PropertyList &list, unsigned int num_properties,
-                            std::shared_ptr <Buffer> buffer, unsigned int index);
+    /// @brief Sets row at index in columns from text protocol values, nullptr for null values
+    void readRowIntoBuffer (const char* const* values, const unsigned long* lengths,
+                            const std::vector<ColumnHandle>& columns, unsigned int index);
 
     std::vector<std::string> getTableList();
     DBTableInfo getColumnList(const std::string &table);
 
+    /// @brief Constructor for read connections
+    MySQLppConnection(DBInterface &interface);
+
+    /// @brief Inserts rows using INSERT statements with as many rows as fit into max_allowed_packet_
+    void insertMultiRow (const std::string& table_name, const std::string& column_names,
+                         const std::vector<ColumnHandle>& columns, size_t from_index, size_t to_index);
+    /// @brief Inserts rows by writing them as tab-separated values file and loading it with LOAD DATA LOCAL INFILE
+    void insertLoadData (const std::string& table_name, const std::string& column_names,
+                         const std::vector<ColumnHandle>& columns, size_t from_index, size_t to_index);
+    /// @brief Appends value of column at row to out, as SQL literal or LOAD DATA field
+    void appendValue (std::string& out, const ColumnHandle& column, size_t row, bool load_data);
+
+    /**
+     * @brief Executes statement of an imported SQL file, commits after DBInterface::bulkCommitBytes
+     *
+     * If the statement fails, it is rolled back to a savepoint set before it, so the uncommitted ones are kept.
+     */
+    void executeImportSQL (const std::string& sql, size_t& uncommitted_bytes);
+    /// @brief Commits statements executed by executeImportSQL
+    void commitImportSQL (size_t& uncommitted_bytes);
+    /// @brief Rolls back uncommitted statements executed by executeImportSQL, does not throw
+    void rollbackImportSQL (size_t& uncommitted_bytes);
+
     /// @brief Used for performance tests.
     void performanceTest ();
 };
@@ -31,15 +31,141 @@
 #include "dbtableinfo.h"
 #include "stringconv.h"
 
+namespace
+{
+    /// @brief Binds value of an integral type column
+    template <typename T> inline void bindSQLiteValue (sqlite3_stmt* statement, int index,
+                                                       const NullableVector<T>& column, size_t row)
+    {
+        sqlite3_bind_int64(statement, index, static_cast<sqlite3_int64> (column.data()[row]));
+    }
+
+    template <> inline void bindSQLiteValue<float> (sqlite3_stmt* statement, int index,
+                                                    const NullableVector<float>& column, size_t row)
+    {
+        sqlite3_bind_double(statement, index, static_cast<double> (column.data()[row]));
+    }
+
+    template <> inline void bindSQLiteValue<double> (sqlite3_stmt* statement, int index,
+                                                     const NullableVector<double>& column, size_t row)
+    {
+        sqlite3_bind_double(statement, index, column.data()[row]);
+    }
+
+    template <> inline void bindSQLiteValue<std::string> (sqlite3_stmt* statement, int index,
+                                                          const NullableVector<std::string>& column, size_t row)
+    {
+        // dictionary value stays unchanged until step
+        const std::string& value = column.data()[row];
+        sqlite3_bind_text(statement, index, value.c_str(), value.size(), SQLITE_STATIC);
+    }
+
+    /// @brief Binds values of one column, with type resolved on construction
+    class SQLiteColumnBinder
+    {
+    public:
+        SQLiteColumnBinder (const ColumnHandle& column)
+        {
+            switch (column.dataType())
+            {
+            case PropertyDataType::BOOL:
+                set<bool> (column);
+                break;
+            case PropertyDataType::CHAR:
+                set<char> (column);
+                break;
+            case PropertyDataType::UCHAR:
+                set<unsigned char> (column);
+                break;
+            case PropertyDataType::INT:
+                set<int> (column);
+                break;
+            case PropertyDataType::UINT:
+                set<unsigned int> (column);
+                break;
+            case PropertyDataType::LONGINT:
+                set<long int> (column);
+                break;
+            case PropertyDataType::ULONGINT:
+                set<unsigned long int> (column);
+                break;
+            case PropertyDataType::FLOAT:
+                set<float> (column);
+                break;
+            case PropertyDataType::DOUBLE:
+                set<double> (column);
+                break;
+            case PropertyDataType::STRING:
+                set<std::string> (column);
+                break;
+            default:
+                logerr  <<  "SQLiteColumnBinder: constructor: unknown property type "
+                         << Property::asString(column.dataType());
+                throw std::runtime_error ("SQLiteColumnBinder: constructor: unknown property type "
+                                          + Property::asString(column.dataType()));
+            }
+        }
+
+        void bind (sqlite3_stmt* statement, int index, size_t row) const
+        {
+            if (row >= size_ || validity_->isNull(row))
+                sqlite3_bind_null(statement, index);
+            else
+                function_(statement, index, column_, row);
+        }
+
+    protected:
+        typedef void (*BindFunction) (sqlite3_stmt*, int, const void*, size_t);
+
+        BindFunction function_ {nullptr};
+        const void* column_ {nullptr};
+        const ValidityBitmap* validity_ {nullptr};
+        /// Number of set values, later ones are null
+        size_t size_ {0};
+
+        template <typename T> static void bindValue (sqlite3_stmt* statement, int index, const void* column,
+                                                     size_t row)
+        {
+            bindSQLiteValue<T> (statement, index, *static_cast<const NullableVector<T>*> (column), row);
+        }
+
+        template <typename T> void set (const ColumnHandle& column)
+        {
+            const NullableVector<T>& typed_column = column.get<T>();
+
+            function_ = &bindValue<T>;
+            column_ = &typed_column;
+            validity_ = &typed_column.validity();
+            size_ = typed_column.data().size();
+        }
+    };
+}
+
 SQLiteConnection::SQLiteConnection(const std::string &class_id, const std::string &instance_id, DBInterface *interface)
-: DBConnection (class_id, instance_id, interface), interface_(*interface), db_handle_(nullptr), prepared_command_(nullptr), prepared_command_done_(false),
-  widget_(nullptr), info_widget_(nullptr)
+: DBConnection (class_id, instance_id, interface), interface_(*interface), db_handle_(nullptr), statement_(nullptr),
+  statement_cache_(0, [] (sqlite3_stmt*& statement) { sqlite3_finalize(statement); }),
+  prepared_command_(nullptr), prepared_command_done_(false), widget_(nullptr), info_widget_(nullptr)
 {
     registerParameter("last_filename", &last_filename_, "");
+    registerParameter("use_wal", &use_wal_, true);
+    registerParameter("mmap_size_mb", &mmap_size_mb_, 256);
+    registerParameter("cache_size_kb", &cache_size_kb_, 32768);
+    registerParameter("bulk_cache_size_kb", &bulk_cache_size_kb_, 524288);
+    registerParameter("temp_store", &temp_store_, "memory");
+    registerParameter("statement_cache_size", &statement_cache_size_, 64);
+
+    statement_cache_.capacity(statement_cache_size_);
 
     createSubConfigurables();
 }
 
+SQLiteConnection::SQLiteConnection(DBInterface &interface)
+: interface_(interface), db_handle_(nullptr), statement_(nullptr),
+  statement_cache_(0, [] (sqlite3_stmt*& statement) { sqlite3_finalize(statement); }),
+  prepared_command_(nullptr), prepared_command_done_(false), widget_(nullptr), info_widget_(nullptr)
+{
+}
+
 SQLiteConnection::~SQLiteConnection()
 {
     assert (!db_handle_);
@@ -67,9 +193,36 @@ void SQLiteConnection::openFile (const std::string &file_name)
         sqlite3_close(db_handle_);
         throw std::runtime_error ("SQLiteConnection: openFile: error");
     }
-    char * sErrMsg = 0;
-    sqlite3_exec(db_handle_, "PRAGMA synchronous = OFF", NULL, NULL, &sErrMsg);
-    sqlite3_exec(db_handle_, "PRAGMA journal_mode = OFF", NULL, NULL, &sErrMsg);
+    sqlite3_busy_timeout(db_handle_, SQLITE_BUSY_TIMEOUT_MS); // wait for read connections
+
+    wal_active_ = false;
+
+    if (use_wal_)
+    {
+        // returns the resulting mode, which stays the old one if wal is not possible (e.g. in-memory database)
+        sqlite3_stmt* statement = nullptr;
+
+        if (sqlite3_prepare_v2(db_handle_, "PRAGMA journal_mode = WAL", -1, &statement, nullptr) == SQLITE_OK
+                && sqlite3_step(statement) == SQLITE_ROW)
+        {
+            const char* mode = reinterpret_cast<const char*> (sqlite3_column_text(statement, 0));
+            wal_active_ = mode && strcmp (mode, "wal") == 0;
+        }
+
+        sqlite3_finalize(statement);
+
+        if (!wal_active_)
+            logwrn << "SQLiteConnection: openFile: write-ahead logging not possible, using rollback journal";
+    }
+
+    if (!wal_active_)
+        executeSQL("PRAGMA journal_mode = DELETE");
+
+    setSynchronous();
+
+    setPragmas();
+
+    loginf << "SQLiteConnection: openFile: wal " << wal_active_;
 
     connection_ready_ = true;
 
@@ -78,6 +231,89 @@ void SQLiteConnection::openFile (const std::string &file_name)
     emit connectedSignal();
 }
 
+void SQLiteConnection::openFileReadOnly (const std::string &file_name)
+{
+    logdbg << "SQLiteConnection: openFileReadOnly: " << file_name;
+
+    last_filename_=file_name;
+    assert (last_filename_.size() > 0);
+    assert (!db_handle_);
+
+    int result = sqlite3_open_v2(last_filename_.c_str(), &db_handle_, SQLITE_OPEN_READONLY, NULL);
+
+    if (result != SQLITE_OK)
+    {
+        logerr  <<  "SQLiteConnection: openFileReadOnly: error " <<  result << " " <<  sqlite3_errmsg(db_handle_);
+        sqlite3_close(db_handle_);
+        db_handle_=nullptr;
+        throw std::runtime_error ("SQLiteConnection: openFileReadOnly: error");
+    }
+
+    sqlite3_busy_timeout(db_handle_, SQLITE_BUSY_TIMEOUT_MS); // wait for writes on other connections
+
+    setPragmas();
+
+    connection_ready_ = true;
+}
+
+void SQLiteConnection::setPragmas ()
+{
+    assert (db_handle_);
+
+    executeSQL("PRAGMA mmap_size = "+std::to_string(static_cast<unsigned long long>(mmap_size_mb_)*1024*1024));
+    executeSQL("PRAGMA cache_size = -"+std::to_string(cache_size_kb_)); // negative for KiB
+
+    if (temp_store_ == "default" || temp_store_ == "file" || temp_store_ == "memory")
+        executeSQL("PRAGMA temp_store = "+temp_store_);
+    else
+        logerr << "SQLiteConnection: setPragmas: unknown temp_store '" << temp_store_ << "'";
+}
+
+void SQLiteConnection::setSynchronous ()
+{
+    assert (db_handle_);
+
+    if (wal_active_) // consistent after crash, only latest commits may be lost
+        executeSQL("PRAGMA synchronous = NORMAL");
+    else
+        executeSQL("PRAGMA synchronous = OFF");
+}
+
+void SQLiteConnection::beginBulkImport ()
+{
+    loginf << "SQLiteConnection: beginBulkImport: cache size " << bulk_cache_size_kb_ << " KiB";
+    assert (connection_ready_);
+
+    executeSQL("PRAGMA cache_size = -"+std::to_string(bulk_cache_size_kb_));
+    executeSQL("PRAGMA synchronous = OFF"); // import is repeated after a crash anyway
+}
+
+void SQLiteConnection::endBulkImport ()
+{
+    loginf << "SQLiteConnection: endBulkImport";
+    assert (connection_ready_);
+
+    setPragmas();
+    setSynchronous();
+}
+
+std::unique_ptr<DBConnection> SQLiteConnection::createReadConnection ()
+{
+    assert (connection_ready_);
+
+    std::unique_ptr<SQLiteConnection> connection {new SQLiteConnection (interface_)};
+    connection->use_wal_ = use_wal_;
+    connection->wal_active_ = wal_active_;
+    connection->mmap_size_mb_ = mmap_size_mb_;
+    connection->cache_size_kb_ = cache_size_kb_;
+    connection->temp_store_ = temp_store_;
+    connection->statement_cache_size_ = statement_cache_size_;
+    connection->statement_cache_.capacity(statement_cache_size_);
+    connection->openFileReadOnly(last_filename_);
+
+    return std::move(connection);
+}
+
 void SQLiteConnection::disconnect()
 {
     loginf << "SQLiteConnection: disconnect";
@@ -98,6 +334,17 @@ void SQLiteConnection::disconnect()
 
     if (db_handle_)
     {
+        loginf << "SQLiteConnection: disconnect: statement cache hits " << statement_cache_.hits() << " misses "
+               << statement_cache_.misses();
+
+        if (statement_) // still in use
+        {
+            sqlite3_finalize(statement_);
+            statement_=nullptr;
+        }
+
+        statement_cache_.clear(); // all statements have to be finalized before closing
+
         sqlite3_close(db_handle_);
         db_handle_=nullptr;
     }
@@ -122,14 +369,7 @@ void SQLiteConnection::executeSQL(const std::string &sql)
 
 void SQLiteConnection::prepareBindStatement (const std::string &statement)
 {
-    const char * tail = 0;
-    int ret=sqlite3_prepare_v2(db_handle_, statement.c_str(), statement.size(), &statement_, &tail);
-
-    if (ret != SQLITE_OK)
-    {
-        logerr  << "DBInterface: prepareBindStatement: error preparing bind";
-        return;
-    }
+    prepareStatement(statement, true);
 }
 void SQLiteConnection::beginBindTransaction ()
 {
@@ -152,6 +392,7 @@ void SQLiteConnection::stepAndClearBindings ()
         {
             logerr  << "DBInterface: stepAndClearBindings: error while bind: " << ret2 << ": "
                     << sqlite3_errmsg(db_handle_);
+            finalizeStatement();
             throw std::runtime_error ("DBInterface: stepAndClearBindings: error while bind");
         }
     }
@@ -169,7 +410,7 @@ void SQLiteConnection::endBindTransaction ()
 }
 void SQLiteConnection::finalizeBindStatement ()
 {
-    sqlite3_finalize(statement_);
+    finalizeStatement();
 }
 
 void SQLiteConnection::bindVariable (unsigned int index, int value)
@@ -193,6 +434,43 @@ void SQLiteConnection::bindVariableNull (unsigned int index)
     sqlite3_bind_null(statement_, index);
 }
 
+void SQLiteConnection::bindColumns (const std::vector<ColumnHandle>& columns, size_t from_index, size_t to_index)
+{
+    logdbg  << "SQLiteConnection: bindColumns: " << columns.size() << " columns from " << from_index << " to "
+            << to_index;
+
+    assert (statement_);
+
+    std::vector<SQLiteColumnBinder> binders;
+    binders.reserve(columns.size());
+
+    for (auto& column_it : columns)
+        binders.push_back(SQLiteColumnBinder(column_it));
+
+    int num_columns = binders.size();
+    int result;
+
+    for (size_t row=from_index; row <= to_index; ++row)
+    {
+        for (int cnt=0; cnt < num_columns; ++cnt)
+            binders[cnt].bind(statement_, cnt+1, row);
+
+        result = sqlite3_step(statement_);
+
+        if (result != SQLITE_DONE)
+        {
+            logerr  << "SQLiteConnection: bindColumns: error while bind: " << result << ": "
+                    << sqlite3_errmsg(db_handle_);
+            finalizeStatement(); // finalizeBindStatement is a no-op then
+            throw std::runtime_error ("SQLiteConnection: bindColumns: error while bind");
+        }
+
+        sqlite3_reset(statement_); // all values are bound again, no clear needed
+    }
+
+    sqlite3_clear_bindings(statement_);
+}
+
 // TODO: beware of se deleted propertylist, new buffer should use deep copied list
 std::shared_ptr <DBResult> SQLiteConnection::execute (const DBCommand &command)
 {
@@ -248,12 +526,14 @@ void SQLiteConnection::execute (const std::string &command)
 
     int result;
 
-    prepareStatement(command.c_str());
+    prepareStatement(command, false); // one-off statement, usually with literal values
     result = sqlite3_step(statement_);
 
     if (result != SQLITE_DONE)
     {
-        logerr <<  "SQLiteConnection: execute: problem while stepping the result: " <<  result << " " <<  sqlite3_errmsg(db_handle_);
+        logerr <<  "SQLiteConnection: execute: problem while stepping the result: " <<  result << " "
+               <<  sqlite3_errmsg(db_handle_);
+        finalizeStatement();
         throw std::runtime_error ("SQLiteConnection: execute: problem while stepping the result");
     }
 
@@ -265,109 +545,106 @@ void SQLiteConnection::execute (const std::string &command, std::shared_ptr <Buf
     logdbg  << "SQLiteConnection: execute";
 
     assert (buffer);
-    unsigned int num_properties=0;
-
-    const PropertyList &list = buffer->properties();
-    num_properties = list.size();
+    std::vector<ColumnHandle> columns = buffer->columns();
 
     unsigned int cnt=buffer->size();
 
     int result;
 
-    prepareStatement(command.c_str());
+    prepareStatement(command, false); // one-off statement, usually with literal values
 
-    // Now step throught the result lines
-    for (result = sqlite3_step(statement_); result == SQLITE_ROW; result = sqlite3_step(statement_))
+    try
+    {
+        // Now step throught the result lines
+        for (result = sqlite3_step(statement_); result == SQLITE_ROW; result = sqlite3_step(statement_))
+        {
+            readRowIntoBuffer (columns, cnt);
+            cnt++;
+        }
+    }
+    catch (std::exception&)
     {
-        readRowIntoBuffer (list, num_properties, buffer, cnt);
-        cnt++;
+        finalizeStatement();
+        throw;
     }
 
     if (result != SQLITE_DONE)
     {
-        logerr <<  "SQLiteConnection: execute: problem while stepping the result: " <<  result << " " <<  sqlite3_errmsg(db_handle_);
+        logerr <<  "SQLiteConnection: execute: problem while stepping the result: " <<  result << " "
+               <<  sqlite3_errmsg(db_handle_);
+        finalizeStatement();
         throw std::runtime_error ("SQLiteConnection: execute: problem while stepping the result");
     }
 
     finalizeStatement();
 }
 
-void SQLiteConnection::readRowIntoBuffer (const PropertyList &list, unsigned int num_properties,
-                                          std::shared_ptr <Buffer> buffer, unsigned int index)
+void SQLiteConnection::readRowIntoBuffer (const std::vector<ColumnHandle>& columns, unsigned int index)
 {
-    for (unsigned int cnt=0; cnt < num_properties; cnt++)
+    unsigned int num_columns = columns.size();
+    const char* text;
+
+    for (unsigned int cnt=0; cnt < num_columns; cnt++)
     {
-        const Property &prop=list.at(cnt);
+        if (sqlite3_column_type(statement_, cnt) == SQLITE_NULL)
+            continue;
+
+        const ColumnHandle& column = columns[cnt];
 
-        switch (prop.dataType())
+        switch (column.dataType())
         {
         case PropertyDataType::BOOL:
-            if (sqlite3_column_type(statement_, cnt) != SQLITE_NULL)
-                buffer->get<bool>(prop.name()).set(index, static_cast<bool> (sqlite3_column_int(statement_, cnt)));
-//            else
-//                buffer->get<bool>(prop.name()).setNone(index);
-            //loginf  << "sqlex: bool " << prop->id_ << " val " << *ptr;
+            column.get<bool>().set(index, static_cast<bool> (sqlite3_column_int(statement_, cnt)));
             break;
         case PropertyDataType::UCHAR:
-            if (sqlite3_column_type(statement_, cnt) != SQLITE_NULL)
-                buffer->get<unsigned char>(prop.name()).set(index, static_cast<unsigned char> (sqlite3_column_int(statement_, cnt)));
-//            else
-//                buffer->get<unsigned char>(prop.name()).setNone(index);
-            //loginf  << "sqlex: uchar " << prop->id_ << " val " << *ptr;
+            column.get<unsigned char>().set(index, static_cast<unsigned char> (sqlite3_column_int(statement_, cnt)));
             break;
         case PropertyDataType::CHAR:
-            if (sqlite3_column_type(statement_, cnt) != SQLITE_NULL)
-                buffer->get<char>(prop.name()).set(index, static_cast<signed char> (sqlite3_column_int(statement_, cnt)));
-//            else
-//                buffer->get<char>(prop.name()).setNone(index);
-            //loginf  << "sqlex: char " << prop->id_ << " val " << *ptr;
+            column.get<char>().set(index, static_cast<signed char> (sqlite3_column_int(statement_, cnt)));
             break;
         case PropertyDataType::INT:
-            if (sqlite3_column_type(statement_, cnt) != SQLITE_NULL)
-                buffer->get<int>(prop.name()).set(index, static_cast<int> (sqlite3_column_int(statement_, cnt)));
-//            else
-//                buffer->get<int>(prop.name()).setNone(index);
-            //loginf  << "sqlex: int " << prop->id_ << " val " << *ptr;
+            column.get<int>().set(index, static_cast<int> (sqlite3_column_int(statement_, cnt)));
             break;
         case PropertyDataType::UINT:
-            if (sqlite3_column_type(statement_, cnt) != SQLITE_NULL)
-                buffer->get<unsigned int>(prop.name()).set(index, static_cast<unsigned int> (sqlite3_column_int(statement_, cnt)));
-//            else
-//                buffer->get<unsigned int>(prop.name()).setNone(index);
-            //loginf  << "sqlex: uint " << prop->id_ << " val " << *ptr;
+            column.get<unsigned int>().set(index, static_cast<unsigned int> (sqlite3_column_int(statement_, cnt)));
+            break;
+        case PropertyDataType::LONGINT:
+            column.get<long int>().set(index, static_cast<long int> (sqlite3_column_int64(statement_, cnt)));
+            break;
+        case PropertyDataType::ULONGINT:
+            column.get<unsigned long int>().set(
+                        index, static_cast<unsigned long int> (sqlite3_column_int64(statement_, cnt)));
             break;
         case PropertyDataType::STRING:
-            if (sqlite3_column_type(statement_, cnt) != SQLITE_NULL)
-                buffer->get<std::string>(prop.name()).set(index, std::string (reinterpret_cast<const char*> (sqlite3_column_text(statement_, cnt))));
-//            else
-//                buffer->get<std::string>(prop.name()).setNone(index);
-            //loginf  << "sqlex: string " << prop->id_ << " val " << *ptr;
+            // text before bytes, as required by sqlite
+            text = reinterpret_cast<const char*> (sqlite3_column_text(statement_, cnt));
+            column.get<std::string>().set(index, text, sqlite3_column_bytes(statement_, cnt));
             break;
         case PropertyDataType::FLOAT:
-            if (sqlite3_column_type(statement_, cnt) != SQLITE_NULL)
-                buffer->get<float>(prop.name()).set(index, static_cast<float> (sqlite3_column_double (statement_, cnt)));
-//            else
-//                buffer->get<float>(prop.name()).setNone(index);
-            //loginf  << "sqlex: float " << prop->id_ << " val " << *ptr;
+            column.get<float>().set(index, static_cast<float> (sqlite3_column_double (statement_, cnt)));
             break;
         case PropertyDataType::DOUBLE:
-            if (sqlite3_column_type(statement_, cnt) != SQLITE_NULL)
-                buffer->get<double>(prop.name()).set(index, static_cast<double> (sqlite3_column_double (statement_, cnt)));
-//            else
-//                buffer->get<double>(prop.name()).setNone(index);
-            //loginf  << "sqlex: double " << prop->id_ << " val " << *ptr;
+            column.get<double>().set(index, static_cast<double> (sqlite3_column_double (statement_, cnt)));
             break;
         default:
-            logerr  <<  "MySQLppConnection: readRowIntoBuffer: unknown property type";
-            throw std::runtime_error ("MySQLppConnection: readRowIntoBuffer: unknown property type");
+            logerr  <<  "SQLiteConnection: readRowIntoBuffer: unknown property type";
+            throw std::runtime_error ("SQLiteConnection: readRowIntoBuffer: unknown property type");
             break;
         }
     }
 }
 
-void SQLiteConnection::prepareStatement (const std::string &sql)
+void SQLiteConnection::prepareStatement (const std::string &sql, bool cached)
 {
-    logdbg  << "SQLiteConnection: prepareStatement: sql '" << sql << "'";
+    logdbg  << "SQLiteConnection: prepareStatement: sql '" << sql << "' cached " << cached;
+    assert (!statement_);
+
+    statement_sql_ = sql;
+    statement_cached_ = cached;
+
+    if (cached && statement_cache_.take(sql, statement_))
+        return;
+
     int result;
     const char* remaining_sql;
 
@@ -376,20 +653,38 @@ void SQLiteConnection::prepareStatement (const std::string &sql)
     result = sqlite3_prepare_v2(db_handle_, sql.c_str(), sql.size(), &statement_, &remaining_sql);
     if (result != SQLITE_OK)
     {
-        logerr <<  "SQLiteConnection: execute: error " <<  result << " " <<  sqlite3_errmsg(db_handle_);
-        sqlite3_close(db_handle_);
-        throw std::runtime_error ("SQLiteConnection: execute: error");
+        logerr <<  "SQLiteConnection: prepareStatement: error " <<  result << " " <<  sqlite3_errmsg(db_handle_);
+        sqlite3_finalize(statement_);
+        statement_=nullptr;
+        throw std::runtime_error ("SQLiteConnection: prepareStatement: error");
     }
 
     if (remaining_sql && *remaining_sql != '\0')
     {
-        logerr  <<  "SQLiteConnection: execute: there was unparsed sql text: " << remaining_sql;
-        throw std::runtime_error ("SQLiteConnection: execute: there was unparsed sql text");
+        logerr  <<  "SQLiteConnection: prepareStatement: there was unparsed sql text: " << remaining_sql;
+        sqlite3_finalize(statement_);
+        statement_=nullptr;
+        throw std::runtime_error ("SQLiteConnection: prepareStatement: there was unparsed sql text");
     }
 }
 void SQLiteConnection::finalizeStatement ()
 {
-    sqlite3_finalize(statement_);
+    if (!statement_)
+        return;
+
+    if (!statement_cached_)
+    {
+        sqlite3_finalize(statement_);
+        statement_=nullptr;
+        return;
+    }
+
+    // release locks and bound values, keep compiled statement
+    sqlite3_reset(statement_);
+    sqlite3_clear_bindings(statement_);
+
+    statement_cache_.put(statement_sql_, statement_);
+    statement_=nullptr;
 }
 
 void SQLiteConnection::prepareCommand (const std::shared_ptr<DBCommand> command)
@@ -400,7 +695,7 @@ void SQLiteConnection::prepareCommand (const std::shared_ptr<DBCommand> command)
     prepared_command_=command;
     prepared_command_done_=false;
 
-    prepareStatement (command->get().c_str());
+    prepareStatement (command->get(), true);
 }
 std::shared_ptr <DBResult> SQLiteConnection::stepPreparedCommand (unsigned int max_results)
 {
@@ -414,8 +709,7 @@ std::shared_ptr <DBResult> SQLiteConnection::stepPreparedCommand (unsigned int m
     assert (buffer->size() == 0);
     std::shared_ptr <DBResult> dbresult (new DBResult(buffer));
 
-    unsigned int num_properties = buffer->properties().size();
-    const PropertyList &list = buffer->properties();
+    std::vector<ColumnHandle> columns = buffer->columns();
 
     unsigned int cnt = 0;
     int result;
@@ -423,26 +717,39 @@ std::shared_ptr <DBResult> SQLiteConnection::stepPreparedCommand (unsigned int m
 
     max_results--;
 
-    // Now step throught the result lines
-    for (result = sqlite3_step(statement_); result == SQLITE_ROW; result = sqlite3_step(statement_))
+    try
     {
-        readRowIntoBuffer (list, num_properties, buffer, cnt);
+        // Now step throught the result lines
+        for (result = sqlite3_step(statement_); result == SQLITE_ROW; result = sqlite3_step(statement_))
+        {
+            readRowIntoBuffer (columns, cnt);
 
-        if (buffer->size()) // 0 == 1 otherwise
-            assert (buffer->size() == cnt+1);
+            if (buffer->size()) // 0 == 1 otherwise
+                assert (buffer->size() == cnt+1);
 
-        if (max_results != 0 && cnt >= max_results)
-        {
-            done=false;
-            break;
-        }
+            if (max_results != 0 && cnt >= max_results)
+            {
+                done=false;
+                break;
+            }
 
-        ++cnt;
+            ++cnt;
+        }
+    }
+    catch (std::exception&)
+    {
+        // statement back to cache, finalizeCommand is still required
+        finalizeStatement();
+        prepared_command_done_=true;
+        throw;
     }
 
     if (result != SQLITE_ROW && result != SQLITE_DONE)
     {
-        logerr <<  "SQLiteConnection: stepPreparedCommand: problem while stepping the result: " <<  result << " " <<  sqlite3_errmsg(db_handle_);
+        logerr <<  "SQLiteConnection: stepPreparedCommand: problem while stepping the result: " <<  result << " "
+               <<  sqlite3_errmsg(db_handle_);
+        finalizeStatement();
+        prepared_command_done_=true;
         throw std::runtime_error ("SQLiteConnection: stepPreparedCommand: problem while stepping the result");
     }
 
@@ -463,7 +770,7 @@ std::shared_ptr <DBResult> SQLiteConnection::stepPreparedCommand (unsigned int m
 void SQLiteConnection::finalizeCommand ()
 {
     assert (prepared_command_ != nullptr);
-    sqlite3_finalize(statement_);
+    finalizeStatement();
     prepared_command_=nullptr; // should be deleted by caller
     prepared_command_done_=true;
 }
@@ -494,7 +801,7 @@ std::vector <std::string> SQLiteConnection::getTableList()  // buffer of table n
     std::vector <std::string> tables;
 
     DBCommand command;
-    command.set ("SELECT name FROM sqlite_master WHERE name != 'sqlite_sequence' ORDER BY name DESC;");
+    command.set ("SELECT name FROM sqlite_master WHERE type='table' AND name != 'sqlite_sequence' ORDER BY name DESC;");
     PropertyList list;
     list.addProperty ("name", PropertyDataType::STRING);
     command.list (list);
@@ -22,15 +22,20 @@
 #include <string>
 
 #include "dbconnection.h"
+#include "statementcache.h"
 #include "global.h"
 
 class Buffer;
+class ColumnHandle;
 class DBInterface;
 class SQLiteConnectionWidget;
 class SQLiteConnectionInfoWidget;
 class SavedFile;
 class PropertyList;
 
+/// Time to wait for locks held by other connections, in milliseconds
+const int SQLITE_BUSY_TIMEOUT_MS=60000;
+
 /**
  * @brief Interface for a SQLite3 database connection
  *
@@ -43,6 +48,14 @@ public:
 
     void openFile (const std::string &file_name);
 
+    std::unique_ptr<DBConnection> createReadConnection () override;
+    /// @brief Returns if write-ahead logging is active, in which readers do not block the writer and vice versa
+    bool concurrentReadWrite () override { return wal_active_; }
+
+    /// @brief Raises the page cache size and disables syncing
+    void beginBulkImport () override;
+    void endBulkImport () override;
+
     virtual void disconnect ();
 
     void executeSQL(const std::string &sql);
@@ -57,6 +70,7 @@ public:
     void bindVariable (unsigned int index, double value);
     void bindVariable (unsigned int index, const std::string &value);
     void bindVariableNull (unsigned int index);
+    void bindColumns (const std::vector<ColumnHandle>& columns, size_t from_index, size_t to_index) override;
 
     std::shared_ptr <DBResult> execute (const DBCommand &command);
     std::shared_ptr <DBResult> execute (const DBCommandList &command_list);
@@ -66,6 +80,9 @@ public:
     void finalizeCommand ();
     bool getPreparedCommandDone () { return prepared_command_done_; }
 
+    size_t statementCacheHits () const override { return statement_cache_.hits(); }
+    size_t statementCacheMisses () const override { return statement_cache_.misses(); }
+
     std::map <std::string, DBTableInfo> getTableInfo ();
     virtual std::vector <std::string> getDatabases();
 
@@ -88,10 +105,31 @@ protected:
     DBInterface &interface_;
     std::string last_filename_;
 
+    /// Flag if write-ahead logging should be used, rollback journal otherwise
+    bool use_wal_ {true};
+    /// Flag if write-ahead logging is active in the opened file
+    bool wal_active_ {false};
+    /// Maximum size of memory mapped I/O, in MiB, 0 to disable
+    unsigned int mmap_size_mb_ {256};
+    /// Page cache size per database handle, in KiB
+    unsigned int cache_size_kb_ {32768};
+    /// Page cache size during bulk import, in KiB
+    unsigned int bulk_cache_size_kb_ {524288};
+    /// Storage of temporary tables and indices, 'default', 'file' or 'memory'
+    std::string temp_store_ {"memory"};
+
     /// Database handle to execute queries
     sqlite3* db_handle_;
     /// Statement for binding variables to.
     sqlite3_stmt *statement_;
+    /// SQL of statement_, key in statement_cache_
+    std::string statement_sql_;
+    /// Flag if statement_ is put into statement_cache_ when finalized, otherwise it is finalized
+    bool statement_cached_ {false};
+    /// Maximum number of cached statements
+    unsigned int statement_cache_size_ {64};
+    /// Prepared statements not in use
+    StatementCache<sqlite3_stmt*> statement_cache_;
 
     std::shared_ptr<DBCommand> prepared_command_;
     bool prepared_command_done_;
@@ -103,13 +141,27 @@ protected:
 
     void execute (const std::string &command);
     void execute (const std::string &command, std::shared_ptr <Buffer> buffer);
-    void readRowIntoBuffer (const PropertyList &list, unsigned int num_properties, std::shared_ptr <Buffer> buffer, unsigned int index);
-
-    void prepareStatement (const std::string &sql);
+    void readRowIntoBuffer (const std::vector<ColumnHandle>& columns, unsigned int index);
+
+    /// @brief Sets mmap_size, cache_size and temp_store pragmas on db_handle_
+    void setPragmas ();
+    /// @brief Sets synchronous pragma on db_handle_ depending on the journal mode
+    void setSynchronous ();
+
+    /// @brief Sets statement_ to cached or newly prepared statement
+    void prepareStatement (const std::string &sql) override { prepareStatement(sql, true); }
+    /// @brief Sets statement_ to newly prepared statement, or to cached one if cached is set
+    void prepareStatement (const std::string &sql, bool cached);
+    /// @brief Resets statement_ and puts it into the statement cache if it was cached, otherwise finalizes it
     void finalizeStatement ();
 
     std::vector<std::string> getTableList();
     DBTableInfo getColumnList(const std::string &table);
+
+    /// @brief Constructor for read connections
+    SQLiteConnection(DBInterface &interface);
+    /// @brief Opens file read-only, without notifying the interface
+    void openFileReadOnly (const std::string &file_name);
 };
 
 #endif /* DBINTERFACE_H_ */
@@ -0,0 +1,131 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATEMENTCACHE_H_
+#define STATEMENTCACHE_H_
+
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief Least-recently-used cache of prepared statements, keyed by SQL text
+ *
+ * Statements in use are taken out of the cache and put back when done, so each cached statement is used by only one
+ * caller at a time. When the capacity is exceeded, the least recently used statement is released using the release
+ * function. Not thread-safe, as statements belong to a single connection.
+ */
+template <class T>
+class StatementCache
+{
+public:
+    typedef std::function<void(T&)> ReleaseFunction;
+
+    /// @brief Constructor, release function is called for evicted and cleared statements
+    StatementCache (unsigned int capacity, ReleaseFunction release) : capacity_(capacity), release_(release) {}
+    /// @brief Destructor, releases all statements
+    virtual ~StatementCache () { clear(); }
+
+    /// @brief Takes statement for sql out of the cache, returns false if not cached
+    bool take (const std::string& sql, T& statement)
+    {
+        auto it = index_.find(sql);
+
+        if (it == index_.end())
+        {
+            ++misses_;
+            return false;
+        }
+
+        ++hits_;
+
+        statement = std::move(it->second->second);
+        entries_.erase(it->second);
+        index_.erase(it);
+
+        return true;
+    }
+
+    /// @brief Puts unused statement for sql into the cache as most recently used one
+    void put (const std::string& sql, T statement)
+    {
+        if (!capacity_ || index_.count(sql)) // same one already cached from concurrent use
+        {
+            release_(statement);
+            return;
+        }
+
+        entries_.emplace_front(sql, std::move(statement));
+        index_[sql] = entries_.begin();
+
+        evict();
+    }
+
+    /// @brief Releases all cached statements
+    void clear ()
+    {
+        for (auto& entry_it : entries_)
+            release_(entry_it.second);
+
+        entries_.clear();
+        index_.clear();
+    }
+
+    size_t size () const { return entries_.size(); }
+    unsigned int capacity () const { return capacity_; }
+    /// @brief Sets capacity, releases least recently used statements if exceeded
+    void capacity (unsigned int value)
+    {
+        capacity_ = value;
+        evict();
+    }
+
+    /// @brief Returns number of statements found in the cache
+    size_t hits () const { return hits_; }
+    /// @brief Returns number of statements not found in the cache
+    size_t misses () const { return misses_; }
+
+protected:
+    unsigned int capacity_;
+    ReleaseFunction release_;
+
+    /// Most recently used first
+    std::list<std::pair<std::string, T>> entries_;
+    std::unordered_map<std::string, typename std::list<std::pair<std::string, T>>::iterator> index_;
+
+    size_t hits_ {0};
+    size_t misses_ {0};
+
+    /// @brief Releases least recently used statements until capacity is not exceeded
+    void evict ()
+    {
+        while (entries_.size() > capacity_)
+        {
+            index_.erase(entries_.back().first);
+            release_(entries_.back().second);
+            entries_.pop_back();
+        }
+    }
+
+private:
+    StatementCache (const StatementCache&) = delete;
+    void operator= (const StatementCache&) = delete;
+};
+
+#endif /* STATEMENTCACHE_H_ */
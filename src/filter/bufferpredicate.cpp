@@ -0,0 +1,480 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <boost/algorithm/string.hpp>
+
+#include "bufferpredicate.h"
+#include "buffer.h"
+#include "logger.h"
+
+namespace
+{
+const uint64_t ALL_BITS = ~uint64_t(0);
+
+static_assert (CHUNKED_VECTOR_SEGMENT_SIZE % ValidityBitmap::WORD_BITS == 0,
+               "segments have to start at word boundaries");
+
+/// @brief Sets words for rows of data, one bit per row as returned by select
+template <class T, class Select> void selectWords (const ChunkedVector<T>& data, Select select,
+                                                   std::vector<uint64_t>& words)
+{
+    const size_t word_bits = ValidityBitmap::WORD_BITS;
+    size_t word_index = 0;
+
+    for (size_t segment_cnt=0; segment_cnt < data.numSegments(); ++segment_cnt)
+    {
+        const typename ChunkedVector<T>::Segment& segment = data.segment(segment_cnt);
+        size_t segment_size = segment.size();
+
+        for (size_t cnt=0; cnt < segment_size; cnt += word_bits, ++word_index)
+        {
+            size_t num_bits = std::min (word_bits, segment_size - cnt);
+            uint64_t word = 0;
+
+            for (size_t bit=0; bit < num_bits; ++bit) // branch-free, to allow vectorization
+                word |= static_cast<uint64_t> (select(segment[cnt+bit])) << bit;
+
+            assert (word_index < words.size());
+            words[word_index] = word;
+        }
+    }
+}
+
+/// @brief Sets words for rows of numeric data where compare returns true, on the (absolute) value as double
+template <class T, class Compare> void compareWords (const ChunkedVector<T>& data, bool absolute, Compare compare,
+                                                     std::vector<uint64_t>& words)
+{
+    if (absolute)
+        selectWords (data, [compare] (const T& value) { return compare(std::fabs(static_cast<double> (value))); },
+                     words);
+    else
+        selectWords (data, [compare] (const T& value) { return compare(static_cast<double> (value)); }, words);
+}
+
+/// @brief Sets words for rows of numeric data selected by term, not considering null values
+template <class T> void selectValues (const ChunkedVector<T>& data, const BufferPredicate::Term& term,
+                                      std::vector<uint64_t>& words)
+{
+    assert (term.numbers.size());
+
+    const double value = term.numbers.front();
+
+    switch (term.op)
+    {
+    case BufferPredicate::Operator::EQUAL:
+        compareWords (data, term.absolute, [value] (double number) { return number == value; }, words);
+        break;
+    case BufferPredicate::Operator::NOT_EQUAL:
+        compareWords (data, term.absolute, [value] (double number) { return number != value; }, words);
+        break;
+    case BufferPredicate::Operator::LESS:
+        compareWords (data, term.absolute, [value] (double number) { return number < value; }, words);
+        break;
+    case BufferPredicate::Operator::LESS_EQUAL:
+        compareWords (data, term.absolute, [value] (double number) { return number <= value; }, words);
+        break;
+    case BufferPredicate::Operator::GREATER:
+        compareWords (data, term.absolute, [value] (double number) { return number > value; }, words);
+        break;
+    case BufferPredicate::Operator::GREATER_EQUAL:
+        compareWords (data, term.absolute, [value] (double number) { return number >= value; }, words);
+        break;
+    case BufferPredicate::Operator::IN:
+    {
+        const std::vector<double>& numbers = term.numbers;
+        compareWords (data, term.absolute, [&numbers] (double number) {
+            return std::binary_search(numbers.begin(), numbers.end(), number); }, words);
+        break;
+    }
+    default:
+        assert (false); // null operators handled by caller
+    }
+}
+
+/// @brief Sets words for rows of string data selected by term, evaluated once per dictionary entry
+void selectValues (const DictionaryVector& data, const BufferPredicate::Term& term, std::vector<uint64_t>& words);
+
+/// @brief Sets words for rows of column selected by term, null rows are not selected except by IS NULL
+template <class T> void selectRows (const NullableVector<T>& column, const BufferPredicate::Term& term,
+                                    std::vector<uint64_t>& words)
+{
+    const ValidityBitmap& validity = column.validity();
+    size_t num_column_words = std::min (ValidityBitmap::numWords(validity.size()), words.size());
+
+    if (term.op == BufferPredicate::Operator::IS_NULL) // rows after the end of the column are null
+    {
+        for (size_t cnt=0; cnt < words.size(); ++cnt)
+            words[cnt] = cnt < num_column_words ? ~validity.word(cnt) : ALL_BITS;
+        return;
+    }
+
+    if (term.op == BufferPredicate::Operator::IS_NOT_NULL)
+        std::fill (words.begin(), words.begin() + num_column_words, ALL_BITS);
+    else
+        selectValues (column.data(), term, words);
+
+    for (size_t cnt=0; cnt < num_column_words; ++cnt)
+        words[cnt] &= validity.word(cnt);
+}
+
+/// @brief Returns flag indicating if value fulfills comparison op with values, values sorted for IN
+template <class T> bool compareValue (BufferPredicate::Operator op, const T& value, const std::vector<T>& values)
+{
+    switch (op)
+    {
+    case BufferPredicate::Operator::EQUAL:
+        return value == values.at(0);
+    case BufferPredicate::Operator::NOT_EQUAL:
+        return value != values.at(0);
+    case BufferPredicate::Operator::LESS:
+        return value < values.at(0);
+    case BufferPredicate::Operator::LESS_EQUAL:
+        return value <= values.at(0);
+    case BufferPredicate::Operator::GREATER:
+        return value > values.at(0);
+    case BufferPredicate::Operator::GREATER_EQUAL:
+        return value >= values.at(0);
+    case BufferPredicate::Operator::IN:
+        return std::binary_search(values.begin(), values.end(), value);
+    case BufferPredicate::Operator::IS_NULL:
+        return false;
+    case BufferPredicate::Operator::IS_NOT_NULL:
+        return true;
+    }
+
+    return false;
+}
+
+void selectValues (const DictionaryVector& data, const BufferPredicate::Term& term, std::vector<uint64_t>& words)
+{
+    assert (!term.absolute);
+
+    std::vector<unsigned char> code_selected (data.dictionarySize());
+
+    for (DictionaryVector::Code code=0; code < code_selected.size(); ++code)
+        code_selected[code] = compareValue(term.op, data.value(code), term.values);
+
+    selectWords (data.codes(), [&code_selected] (DictionaryVector::Code code) { return code_selected[code] != 0; },
+                 words);
+}
+
+bool isUpperBound (BufferPredicate::Operator op)
+{
+    return op == BufferPredicate::Operator::LESS || op == BufferPredicate::Operator::LESS_EQUAL;
+}
+
+bool isLowerBound (BufferPredicate::Operator op)
+{
+    return op == BufferPredicate::Operator::GREATER || op == BufferPredicate::Operator::GREATER_EQUAL;
+}
+}
+
+void BufferPredicate::addTerm (const std::string& property_name, PropertyDataType data_type, const std::string& op,
+                               const std::vector<std::string>& values, bool absolute)
+{
+    Term term;
+    term.property_name = property_name;
+    term.data_type = data_type;
+    term.absolute = absolute;
+
+    std::string op_str = boost::algorithm::to_upper_copy(boost::algorithm::trim_copy(op));
+
+    for (auto& value_it : values)
+    {
+        std::string value = boost::algorithm::trim_copy(value_it);
+
+        if (data_type == PropertyDataType::STRING && value.size() >= 2
+                && (value.front() == '\'' || value.front() == '"') && value.back() == value.front())
+            value = value.substr(1, value.size()-2);
+
+        term.values.push_back(value);
+    }
+
+    if (op_str == "IS" || op_str == "IS NOT")
+    {
+        if (term.values.size() != 1 || !boost::algorithm::iequals(term.values.front(), "NULL"))
+        {
+            setUnsupported ("operator "+op_str+" only supported with NULL");
+            return;
+        }
+
+        term.op = op_str == "IS" ? Operator::IS_NULL : Operator::IS_NOT_NULL;
+        term.values.clear();
+        terms_.push_back(term);
+        return;
+    }
+
+    if (op_str == "=")
+        term.op = Operator::EQUAL;
+    else if (op_str == "!=" || op_str == "<>")
+        term.op = Operator::NOT_EQUAL;
+    else if (op_str == "<")
+        term.op = Operator::LESS;
+    else if (op_str == "<=")
+        term.op = Operator::LESS_EQUAL;
+    else if (op_str == ">")
+        term.op = Operator::GREATER;
+    else if (op_str == ">=")
+        term.op = Operator::GREATER_EQUAL;
+    else if (op_str == "IN")
+        term.op = Operator::IN;
+    else
+    {
+        setUnsupported ("unsupported operator '"+op+"'");
+        return;
+    }
+
+    if (term.values.empty() || (term.op != Operator::IN && term.values.size() != 1))
+    {
+        setUnsupported ("wrong number of values for operator '"+op+"'");
+        return;
+    }
+
+    if (data_type == PropertyDataType::STRING)
+    {
+        if (absolute)
+        {
+            setUnsupported ("absolute value of string variable "+property_name);
+            return;
+        }
+
+        std::sort (term.values.begin(), term.values.end());
+    }
+    else
+    {
+        for (auto& value_it : term.values)
+        {
+            size_t parsed_size = 0;
+            double number;
+
+            try
+            {
+                number = std::stod(value_it, &parsed_size);
+            }
+            catch (std::exception& e)
+            {
+                parsed_size = 0;
+            }
+
+            if (!parsed_size || parsed_size != value_it.size())
+            {
+                setUnsupported ("non-numeric value '"+value_it+"' for variable "+property_name);
+                return;
+            }
+
+            if (data_type == PropertyDataType::FLOAT) // as stored in float columns
+                number = static_cast<float> (number);
+
+            term.numbers.push_back(number);
+        }
+
+        std::sort (term.numbers.begin(), term.numbers.end());
+        term.numbers.erase(std::unique(term.numbers.begin(), term.numbers.end()), term.numbers.end());
+    }
+
+    terms_.push_back(term);
+}
+
+void BufferPredicate::setUnsupported (const std::string& reason)
+{
+    logdbg << "BufferPredicate: setUnsupported: " << reason;
+    supported_ = false;
+}
+
+std::set<std::string> BufferPredicate::propertyNames () const
+{
+    std::set<std::string> names;
+
+    for (auto& term_it : terms_)
+        names.insert(term_it.property_name);
+
+    return names;
+}
+
+bool BufferPredicate::canEvaluate (Buffer& buffer) const
+{
+    if (!supported_)
+        return false;
+
+    const PropertyList& properties = buffer.properties();
+
+    for (auto& term_it : terms_)
+    {
+        if (!properties.hasProperty(term_it.property_name)
+                || properties.get(term_it.property_name).dataType() != term_it.data_type)
+        {
+            logdbg << "BufferPredicate: canEvaluate: buffer does not contain " << term_it.property_name;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+ValidityBitmap BufferPredicate::evaluate (Buffer& buffer) const
+{
+    assert (canEvaluate(buffer));
+
+    size_t size = buffer.size();
+    size_t num_words = ValidityBitmap::numWords(size);
+
+    std::vector<uint64_t> selection (num_words, ALL_BITS);
+    std::vector<uint64_t> words;
+
+    for (auto& term_it : terms_)
+    {
+        words.assign(num_words, 0);
+
+        ColumnHandle column = buffer.column(buffer.properties().get(term_it.property_name));
+
+        switch (term_it.data_type)
+        {
+        case PropertyDataType::BOOL:
+            selectRows (column.get<bool>(), term_it, words);
+            break;
+        case PropertyDataType::CHAR:
+            selectRows (column.get<char>(), term_it, words);
+            break;
+        case PropertyDataType::UCHAR:
+            selectRows (column.get<unsigned char>(), term_it, words);
+            break;
+        case PropertyDataType::INT:
+            selectRows (column.get<int>(), term_it, words);
+            break;
+        case PropertyDataType::UINT:
+            selectRows (column.get<unsigned int>(), term_it, words);
+            break;
+        case PropertyDataType::LONGINT:
+            selectRows (column.get<long int>(), term_it, words);
+            break;
+        case PropertyDataType::ULONGINT:
+            selectRows (column.get<unsigned long int>(), term_it, words);
+            break;
+        case PropertyDataType::FLOAT:
+            selectRows (column.get<float>(), term_it, words);
+            break;
+        case PropertyDataType::DOUBLE:
+            selectRows (column.get<double>(), term_it, words);
+            break;
+        case PropertyDataType::STRING:
+            selectRows (column.get<std::string>(), term_it, words);
+            break;
+        default:
+            logerr << "BufferPredicate: evaluate: unknown property type " << Property::asString(term_it.data_type);
+            throw std::runtime_error ("BufferPredicate: evaluate: unknown property type "
+                                      + Property::asString(term_it.data_type));
+        }
+
+        for (size_t cnt=0; cnt < num_words; ++cnt)
+            selection[cnt] &= words[cnt];
+    }
+
+    ValidityBitmap result;
+    result.assign(std::move(selection), size);
+
+    logdbg << "BufferPredicate: evaluate: selected " << size - result.nullCount() << " of " << size;
+
+    return result;
+}
+
+bool BufferPredicate::narrows (const BufferPredicate& other) const
+{
+    if (!supported_ || !other.supported_)
+        return false;
+
+    for (auto& other_term : other.terms_) // each has to be implied by one of the own terms
+    {
+        bool implied = false;
+
+        for (auto& term_it : terms_)
+        {
+            if (termNarrows(term_it, other_term))
+            {
+                implied = true;
+                break;
+            }
+        }
+
+        if (!implied)
+        {
+            logdbg << "BufferPredicate: narrows: no term narrows " << other_term.property_name;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool BufferPredicate::termNarrows (const Term& term, const Term& other)
+{
+    if (term.property_name != other.property_name || term.data_type != other.data_type
+            || term.absolute != other.absolute)
+        return false;
+
+    if (term.op == other.op && term.values == other.values && term.numbers == other.numbers)
+        return true;
+
+    if (other.op == Operator::IS_NOT_NULL) // all others select only non-null values
+        return term.op != Operator::IS_NULL;
+
+    if (term.op == Operator::IS_NULL || term.op == Operator::IS_NOT_NULL || other.op == Operator::IS_NULL)
+        return false;
+
+    bool is_string = term.data_type == PropertyDataType::STRING;
+    double number = is_string ? 0 : term.numbers.front();
+    const std::string& text = term.values.front();
+
+    if (term.op == Operator::EQUAL || term.op == Operator::IN) // all values have to be selected by other
+    {
+        if (is_string)
+            return std::all_of(term.values.begin(), term.values.end(),
+                               [&other] (const std::string& value) { return selectsValue(other, 0, value); });
+        else
+            return std::all_of(term.numbers.begin(), term.numbers.end(),
+                               [&other] (double value) { return selectsValue(other, value, ""); });
+    }
+
+    if (other.op == Operator::NOT_EQUAL) // other value must not be selected
+    {
+        if (term.op == Operator::NOT_EQUAL)
+            return false; // differing values
+
+        return !selectsValue(term, is_string ? 0 : other.numbers.front(), other.values.front());
+    }
+
+    bool same_bound = is_string ? text == other.values.front() : number == other.numbers.front();
+
+    // bound of term selected by other, or same bound with term excluding it
+    if (isUpperBound(term.op) && isUpperBound(other.op))
+        return selectsValue(other, number, text) || (same_bound && term.op == Operator::LESS);
+
+    if (isLowerBound(term.op) && isLowerBound(other.op))
+        return selectsValue(other, number, text) || (same_bound && term.op == Operator::GREATER);
+
+    return false;
+}
+
+bool BufferPredicate::selectsValue (const Term& term, double number, const std::string& text)
+{
+    if (term.data_type == PropertyDataType::STRING)
+        return compareValue(term.op, text, term.values);
+    else
+        return compareValue(term.op, number, term.numbers);
+}
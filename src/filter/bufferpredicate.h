@@ -0,0 +1,104 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BUFFERPREDICATE_H_
+#define BUFFERPREDICATE_H_
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "property.h"
+#include "validitybitmap.h"
+
+class Buffer;
+
+/**
+ * @brief Filter conditions compiled for evaluation on loaded Buffer columns
+ *
+ * Holds AND combined terms, each comparing a Buffer column (by DBO variable name, in variable units and standard
+ * format) with constant values. Evaluation works column-wise, creating one selection word per 64 rows, so the
+ * filters can be applied to loaded data without reading from the database. Null values are never selected, as
+ * in SQL, except by IS NULL.
+ *
+ * Numeric values are compared as double, values of float columns are rounded to float first. Conditions which
+ * can not be evaluated on buffers (e.g. LIKE) mark the predicate as unsupported.
+ */
+class BufferPredicate
+{
+public:
+    enum class Operator { EQUAL, NOT_EQUAL, LESS, LESS_EQUAL, GREATER, GREATER_EQUAL, IN, IS_NULL, IS_NOT_NULL };
+
+    /// @brief Comparison of one column with constant values
+    struct Term
+    {
+        std::string property_name;
+        PropertyDataType data_type;
+        Operator op;
+        /// Flag indicating if the absolute value of the column is compared
+        bool absolute;
+        /// Values as text, strings without quotes
+        std::vector<std::string> values;
+        /// Values for numeric data types, sorted for IN
+        std::vector<double> numbers;
+    };
+
+    /// @brief Constructor, creates empty predicate which selects all rows
+    BufferPredicate () {}
+
+    /**
+     * @brief Adds term from filter condition parts
+     *
+     * Operator is given as in SQL, values are split for IN. Marks predicate as unsupported if the term can
+     * not be evaluated on buffers.
+     */
+    void addTerm (const std::string& property_name, PropertyDataType data_type, const std::string& op,
+                  const std::vector<std::string>& values, bool absolute=false);
+    /// @brief Marks predicate as not evaluable on buffers
+    void setUnsupported (const std::string& reason);
+
+    /// @brief Returns flag indicating if predicate can be evaluated on buffers
+    bool supported () const { return supported_; }
+    bool empty () const { return terms_.empty(); }
+    const std::vector<Term>& terms () const { return terms_; }
+    /// @brief Returns names of all used properties
+    std::set<std::string> propertyNames () const;
+
+    /// @brief Returns flag indicating if buffer contains all used properties with matching data types
+    bool canEvaluate (Buffer& buffer) const;
+    /// @brief Returns selection of rows of buffer fulfilling all terms, of size of the buffer
+    ValidityBitmap evaluate (Buffer& buffer) const;
+
+    /**
+     * @brief Returns flag indicating if all rows selected by this predicate are also selected by other
+     *
+     * Checked conservatively per term, i.e. false if not obvious. Used to decide if data loaded using other can
+     * be filtered in memory.
+     */
+    bool narrows (const BufferPredicate& other) const;
+
+protected:
+    bool supported_ {true};
+    std::vector<Term> terms_;
+
+    /// @brief Returns flag indicating if all rows selected by term are also selected by other
+    static bool termNarrows (const Term& term, const Term& other);
+    /// @brief Returns flag indicating if non-null value (as number or text, depending on type) is selected by term
+    static bool selectsValue (const Term& term, double number, const std::string& text);
+};
+
+#endif /* BUFFERPREDICATE_H_ */
@@ -22,6 +22,7 @@
 #include "dbobjectmanager.h"
 #include "dbobject.h"
 #include "dbovariable.h"
+#include "bufferpredicate.h"
 
 #include "stringconv.h"
 
@@ -160,6 +161,37 @@ std::string DataSourcesFilter::getConditionString (const std::string& dbo_name,
     return ss.str();
 }
 
+void DataSourcesFilter::addToPredicate (const std::string& dbo_name, BufferPredicate& predicate)
+{
+    if (!active_ || dbo_name != dbo_name_)
+        return;
+
+    assert (object_->hasVariable(ds_column_name_));
+
+    if (!object_->existsInDB() || !object_->variable(ds_column_name_).existsInDB())
+        return;
+
+    std::vector<std::string> values;
+    bool got_all=true;
+
+    for (auto& ds_it : data_sources_)
+    {
+        if (ds_it.second.isActiveInFilter()) // in selection
+            values.push_back(std::to_string(ds_it.first));
+        else
+            got_all=false;
+    }
+
+    if (got_all)
+        return;
+
+    DBOVariable& variable = object_->variable(ds_column_name_);
+
+    if (values.size())
+        predicate.addTerm(variable.name(), variable.dataType(), "IN", values);
+    else
+        predicate.addTerm(variable.name(), variable.dataType(), "IS", {"NULL"});
+}
 
 void DataSourcesFilter::updateDataSources ()
 {
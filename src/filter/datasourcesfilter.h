@@ -105,6 +105,7 @@ public:
 
   virtual std::string getConditionString (const std::string& dbo_name, bool& first,
                                           std::vector <DBOVariable*>& filtered_variables);
+  virtual void addToPredicate (const std::string& dbo_name, BufferPredicate& predicate);
 
   virtual void generateSubConfigurable (const std::string &class_id, const std::string &instance_id);
 
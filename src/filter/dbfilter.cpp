@@ -227,6 +227,25 @@ std::string DBFilter::getConditionString (const std::string &dbo_name, bool &fir
     return ss.str();
 }
 
+void DBFilter::addToPredicate (const std::string &dbo_name, BufferPredicate& predicate)
+{
+    assert (!disabled_);
+
+    if (!active_)
+        return;
+
+    for (unsigned int cnt=0; cnt < conditions_.size(); cnt++)
+    {
+        if (conditions_.at(cnt)->valueInvalid())
+            continue;
+
+        conditions_.at(cnt)->addToPredicate(dbo_name, predicate);
+    }
+
+    for (unsigned int cnt=0; cnt < sub_filters_.size(); cnt ++)
+        sub_filters_.at(cnt)->addToPredicate(dbo_name, predicate);
+}
+
 void DBFilter::setAnd (bool op_and)
 {
     assert (!disabled_);
@@ -26,6 +26,7 @@ class DBFilterWidget;
 class DBFilterCondition;
 class FilterManager;
 class DBOVariable;
+class BufferPredicate;
 
 /**
  * @brief Dynamic database filter
@@ -74,6 +75,8 @@ public:
 
     /// @brief Returns the condition string for a DBObject
     virtual std::string getConditionString (const std::string &dbo_name, bool &first, std::vector <DBOVariable*>& filtered_variables);
+    /// @brief Adds the conditions for a DBObject to a predicate evaluated on loaded buffers
+    virtual void addToPredicate (const std::string &dbo_name, BufferPredicate& predicate);
     /// @brief Returns if only sub-filters and no own conditions exist
     bool onlyHasSubFilter () { return conditions_.size()>0; }
 
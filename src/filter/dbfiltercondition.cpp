@@ -40,6 +40,7 @@
 #include "dbfilter.h"
 #include "unitmanager.h"
 #include "unit.h"
+#include "bufferpredicate.h"
 
 #include "stringconv.h"
 
@@ -212,6 +213,51 @@ std::string DBFilterCondition::getConditionString (const std::string &dbo_name,
     return ss.str();
 }
 
+void DBFilterCondition::addToPredicate (const std::string& dbo_name, BufferPredicate& predicate)
+{
+    assert (usable_);
+    assert (variable_ || meta_variable_);
+
+    DBOVariable* variable=nullptr;
+
+    if (meta_variable_)
+    {
+        assert (meta_variable_->existsIn(dbo_name));
+
+        if (!meta_variable_->existsInDB())
+            return;
+
+        variable = &meta_variable_->getFor(dbo_name);
+    }
+    else
+        variable = variable_;
+
+    if (!variable->existsInDB())
+        return;
+
+    if (!op_and_)
+    {
+        predicate.setUnsupported ("OR combined condition "+instanceId());
+        return;
+    }
+
+    std::vector<std::string> value_strings;
+
+    if (operator_ == "IN")
+        value_strings = String::split(value_, ',');
+    else
+        value_strings.push_back(value_);
+
+    // loaded buffers are in standard format and variable units, so only the representation is fixed
+    if (variable->representation() != DBOVariable::Representation::STANDARD)
+    {
+        for (auto& value_it : value_strings)
+            value_it = variable->getValueStringFromRepresentation(value_it);
+    }
+
+    predicate.addTerm(variable->name(), variable->dataType(), operator_, value_strings, absolute_value_);
+}
+
 /**
  * Checks if value_ is different than edit_ value, if yes sets changed_ and emits possibleFilterChange.
  */
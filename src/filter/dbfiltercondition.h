@@ -30,6 +30,7 @@ class DBOVariable;
 class MetaDBOVariable;
 
 class DBFilter;
+class BufferPredicate;
 
 /**
  * @brief Filtering condition for SQL-clauses
@@ -65,6 +66,8 @@ public:
     /// @brief Returns condition string for a DBO type
     std::string getConditionString (const std::string& dbo_name, bool& first,
                                     std::vector <DBOVariable*>& filtered_variables);
+    /// @brief Adds condition for a DBO type to a predicate, with values in variable units as in loaded buffers
+    void addToPredicate (const std::string& dbo_name, BufferPredicate& predicate);
 
     /// @brief Returns the widget
     QWidget* getWidget () { assert(widget_); return widget_;}
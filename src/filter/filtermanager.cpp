@@ -27,6 +27,7 @@
 #include "dbconnection.h"
 #include "filtermanagerwidget.h"
 #include "datasourcesfilter.h"
+#include "bufferpredicate.h"
 
 using namespace std;
 
@@ -195,6 +196,22 @@ std::string FilterManager::getSQLCondition (const std::string& dbo_name, std::ve
     return ss.str();
 }
 
+BufferPredicate FilterManager::getBufferPredicate (const std::string& dbo_name)
+{
+    assert (ATSDB::instance().objectManager().object(dbo_name).loadable());
+
+    BufferPredicate predicate;
+
+    for (auto* filter : filters_)
+    {
+        if (filter->getActive() && filter->filters (dbo_name))
+            filter->addToPredicate (dbo_name, predicate);
+    }
+
+    logdbg  << "FilterManager: getBufferPredicate: name " << dbo_name << " terms " << predicate.terms().size()
+            << " supported " << predicate.supported();
+    return predicate;
+}
 
 unsigned int FilterManager::getNumFilters ()
 {
@@ -30,6 +30,7 @@ class DBFilter;
 class ATSDB;
 class FilterManagerWidget;
 class DBOVariable;
+class BufferPredicate;
 
 /**
  * @brief Manages all filters and generates SQL conditions
@@ -58,6 +59,8 @@ public:
 
     /// @brief Returns the SQL condition for a DBO and sets all used variable names
     std::string getSQLCondition (const std::string& dbo_name,std::vector <DBOVariable*>& filtered_variables);
+    /// @brief Returns the active filters for a DBObject as predicate, to be evaluated on loaded buffers
+    BufferPredicate getBufferPredicate (const std::string& dbo_name);
 
     /// @brief Returns number of existing filters
     unsigned int getNumFilters ();
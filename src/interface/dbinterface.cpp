@@ -22,8 +22,13 @@
 #include <QThread>
 #include <QProgressDialog>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #include "atsdb.h"
 #include "buffer.h"
+#include "bufferview.h"
 #include "config.h"
 #include "dbobject.h"
 #include "dbodatasource.h"
@@ -45,8 +50,10 @@
 #include "dbschema.h"
 //#include "StructureDescriptionManager.h"
 #include "jobmanager.h"
-#include "dboactivedatasourcesdbjob.h"
-#include "dbominmaxdbjob.h"
+#include "tablestatisticsdbjob.h"
+#include "createindexesdbjob.h"
+#include "columnstatistics.h"
+#include "nullablevector.h"
 #include "dimension.h"
 #include "unit.h"
 #include "unitmanager.h"
@@ -67,7 +74,13 @@ DBInterface::DBInterface(std::string class_id, std::string instance_id, ATSDB *a
 {
     QMutexLocker locker(&connection_mutex_);
 
-    registerParameter ("read_chunk_size", &read_chunk_size_, 50000);
+    registerParameter ("read_chunk_bytes", &read_chunk_bytes_, 4*1024*1024);
+    registerParameter ("min_read_chunk_size", &min_read_chunk_size_, 1000);
+    registerParameter ("max_read_chunk_size", &max_read_chunk_size_, 500000);
+    registerParameter ("read_chunk_target_ms", &read_chunk_target_ms_, 250);
+    registerParameter ("index_rebuild_min_rows", &index_rebuild_min_rows_, 500000);
+    registerParameter ("bulk_commit_bytes", &bulk_commit_bytes_, 64*1024*1024);
+    registerParameter ("max_read_connections", &max_read_connections_, 4);
     registerParameter ("used_connection", &used_connection_, "");
 
     createSubConfigurables();
@@ -80,6 +93,8 @@ DBInterface::~DBInterface()
 {
     logdbg  << "DBInterface: desctructor: start";
 
+    clearReadConnections();
+
     QMutexLocker locker(&connection_mutex_);
 
     for (auto it : connections_)
@@ -110,6 +125,9 @@ void DBInterface::useConnection (const std::string &connection_type)
 
 void DBInterface::databaseContentChanged ()
 {
+    assert (current_connection_);
+    JobManager::instance().concurrentDBReadWrite(current_connection_->concurrentReadWrite());
+
     updateTableInfo();
 
     if (!existsPropertiesTable())
@@ -122,6 +140,22 @@ void DBInterface::databaseContentChanged ()
 
 void DBInterface::closeConnection ()
 {
+    if (bulk_import_active_) // import aborted, indexes restored before closing
+    {
+        logwrn << "DBInterface: closeConnection: ending active bulk import";
+
+        try
+        {
+            endBulkImport();
+        }
+        catch (std::exception& e)
+        {
+            logerr << "DBInterface: closeConnection: ending bulk import failed: " << e.what();
+        }
+    }
+
+    clearReadConnections();
+
     QMutexLocker locker(&connection_mutex_);
 
     logdbg  << "DBInterface: closeConnection";
@@ -275,63 +309,263 @@ void DBInterface::createTable (DBTable& table)
     //emit databaseContentChangedSignal();
 }
 
-/**
- * Returns existsTable for table name.
- */
-bool DBInterface::existsMinMaxTable ()
+void DBInterface::createIndexes (DBTable& table)
 {
-    return existsTable(TABLE_NAME_MINMAX);
+    if (!existsTable(table.name()))
+        return;
+
+    QMutexLocker locker(&connection_mutex_);
+    assert (current_connection_);
+
+    createIndexes(table, *current_connection_);
 }
 
-/**
- * Returns existsTable for table name.
- */
-bool DBInterface::existsPropertiesTable ()
+void DBInterface::dropIndexes (DBTable& table)
 {
-    return existsTable(TABLE_NAME_PROPERTIES);
+    if (!existsTable(table.name()))
+        return;
+
+    QMutexLocker locker(&connection_mutex_);
+    assert (current_connection_);
+
+    for (auto& name_it : indexNames(table.name(), *current_connection_))
+    {
+        if (name_it.compare(0, INDEX_NAME_PREFIX.size(), INDEX_NAME_PREFIX) != 0) // not created by us
+            continue;
+
+        loginf << "DBInterface: dropIndexes: dropping index " << name_it;
+        current_connection_->executeSQL(sql_generator_.getDropIndexStatement(table.name(), name_it));
+    }
 }
 
-///**
-// * Gets SQL command for data sources list and packs the resulting buffer into a set, which is returned.
-// */
-std::set<int> DBInterface::queryActiveSensorNumbers(DBObject &object)
+void DBInterface::createIndexes ()
+{
+    loginf << "DBInterface: createIndexes";
+
+    DBSchemaManager& schema_manager = ATSDB::instance().schemaManager();
+
+    if (!schema_manager.hasCurrentSchema())
+        return;
+
+    for (auto& table_it : schema_manager.getCurrentSchema().tables())
+        createIndexes(*table_it.second);
+}
+
+void DBInterface::dropIndexes ()
+{
+    loginf << "DBInterface: dropIndexes";
+
+    DBSchemaManager& schema_manager = ATSDB::instance().schemaManager();
+
+    if (!schema_manager.hasCurrentSchema())
+        return;
+
+    for (auto& table_it : schema_manager.getCurrentSchema().tables())
+        dropIndexes(*table_it.second);
+}
+
+void DBInterface::startBulkImport ()
 {
-    logdbg  << "DBInterface: queryActiveSensorNumbers: start";
+    loginf << "DBInterface: startBulkImport";
+
+    if (bulk_import_active_) // previous one aborted
+    {
+        logwrn << "DBInterface: startBulkImport: already active";
+        return;
+    }
 
-    assert (object.existsInDB());
-    assert (object.hasCurrentDataSourceDefinition());
+    dropIndexes();
 
     QMutexLocker locker(&connection_mutex_);
+    assert (current_connection_);
 
-    std::string local_key_dbovar = object.currentDataSourceDefinition().localKey();
-    assert (object.hasVariable(local_key_dbovar));
-    const DBTableColumn& local_key_col = object.variable(local_key_dbovar).currentDBColumn();
+    current_connection_->beginBulkImport();
+    bulk_import_active_ = true;
+}
 
-    std::set<int> data;
+void DBInterface::endBulkImport ()
+{
+    loginf << "DBInterface: endBulkImport";
+    assert (bulk_import_active_);
 
-    std::shared_ptr<DBCommand> command = sql_generator_.getDistinctDataSourcesSelectCommand(object);
+    {
+        QMutexLocker locker(&connection_mutex_);
+        assert (current_connection_);
 
-    std::shared_ptr<DBResult> result = current_connection_->execute(*command);
+        current_connection_->endBulkImport();
+        bulk_import_active_ = false;
+    }
 
-    assert (result->containsData());
+    DBSchemaManager& schema_manager = ATSDB::instance().schemaManager();
+
+    if (!schema_manager.hasCurrentSchema())
+        return;
+
+    updateTableInfo(); // tables might have been created
+
+    std::vector <DBTable*> tables;
+
+    for (auto& table_it : schema_manager.getCurrentSchema().tables())
+        if (existsTable(table_it.first))
+            tables.push_back(table_it.second);
+
+    if (!tables.size())
+        return;
+
+    boost::posix_time::ptime start_time = boost::posix_time::microsec_clock::local_time();
+
+    createIndexesParallel(tables);
+
+    std::vector <std::string> table_names;
+    for (auto table_it : tables)
+        table_names.push_back(table_it->name());
+
+    QMutexLocker locker(&connection_mutex_);
+    current_connection_->executeSQL(sql_generator_.getAnalyzeStatement(table_names));
+
+    loginf << "DBInterface: endBulkImport: indexes and statistics done after "
+           << (boost::posix_time::microsec_clock::local_time() - start_time).total_milliseconds() << " ms";
+}
+
+void DBInterface::createIndexes (DBTable& table, DBConnection& connection)
+{
+    std::vector <const DBTableColumn*> columns =
+            ATSDB::instance().schemaManager().getCurrentSchema().indexedColumns(table);
+
+    if (!columns.size())
+        return;
+
+    std::set <std::string> existing_names = indexNames(table.name(), connection);
+
+    for (auto col_it : columns)
+    {
+        if (existing_names.count(sql_generator_.getIndexName(*col_it)))
+            continue;
+
+        loginf << "DBInterface: createIndexes: creating index on " << col_it->identifier();
+
+        boost::posix_time::ptime start_time = boost::posix_time::microsec_clock::local_time();
+
+        connection.executeSQL(sql_generator_.getCreateIndexStatement(*col_it));
+
+        loginf << "DBInterface: createIndexes: created index on " << col_it->identifier() << " after "
+               << (boost::posix_time::microsec_clock::local_time() - start_time).total_milliseconds() << " ms";
+    }
+}
+
+void DBInterface::createIndexesParallel (const std::vector <DBTable*>& tables)
+{
+    std::vector <std::unique_ptr<DBConnection>> connections;
+
+    unsigned int num_threads = std::min<size_t> (std::max (max_read_connections_, 1u), tables.size());
 
-    std::shared_ptr<Buffer> buffer = result->buffer();
-    for (unsigned int cnt=0; cnt < buffer->size(); cnt++)
     {
-        if (buffer->get<int>(local_key_col.name()).isNull(cnt))
+        QMutexLocker locker(&connection_mutex_);
+
+        for (unsigned int cnt=0; cnt < num_threads && num_threads > 1; ++cnt)
         {
-            logwrn << "DBInterface: queryActiveSensorNumbers: object " << object.name()
-                   << " has NULL ds_id's, which will be omitted";
+            std::unique_ptr<DBConnection> connection = current_connection_->createWriteConnection();
+
+            if (!connection) // not supported
+                break;
+
+            connections.push_back(std::move(connection));
         }
-        else
+    }
+
+    if (!connections.size()) // one after another on the main connection
+    {
+        loginf << "DBInterface: createIndexesParallel: creating indexes sequentially";
+
+        for (auto table_it : tables)
+            createIndexes(*table_it);
+
+        return;
+    }
+
+    loginf << "DBInterface: createIndexesParallel: creating indexes using " << connections.size() << " connections";
+
+    std::atomic<size_t> next_table {0};
+    std::atomic<unsigned int> error_cnt {0};
+    std::vector <std::thread> threads;
+
+    for (auto& connection_it : connections)
+    {
+        DBConnection* connection = connection_it.get();
+
+        threads.push_back(std::thread ([this, &tables, &next_table, &error_cnt, connection] ()
         {
-            int tmp = buffer->get<int>(local_key_col.name()).get(cnt);
-            data.insert (tmp);
-        }
+            for (size_t index = next_table++; index < tables.size(); index = next_table++)
+            {
+                try
+                {
+                    createIndexes(*tables.at(index), *connection);
+                }
+                catch (std::exception& e)
+                {
+                    logerr << "DBInterface: createIndexesParallel: table " << tables.at(index)->name()
+                           << " failed: " << e.what();
+                    ++error_cnt;
+                }
+            }
+        }));
     }
 
-    logdbg << "DBInterface: queryActiveSensorNumbers: done";
-    return data;
+    for (auto& thread_it : threads)
+        thread_it.join();
+
+    for (auto& connection_it : connections)
+        connection_it->disconnect();
+
+    if (error_cnt)
+        throw std::runtime_error ("DBInterface: createIndexesParallel: failed for "+std::to_string(error_cnt)
+                                  +" tables");
+}
+
+std::set <std::string> DBInterface::indexNames (const std::string& table_name, DBConnection& connection)
+{
+    std::shared_ptr <DBResult> result = connection.execute(*sql_generator_.getIndexNamesCommand(table_name));
+    assert (result);
+
+    std::set <std::string> names;
+
+    if (!result->containsData())
+        return names;
+
+    std::shared_ptr <Buffer> buffer = result->buffer();
+    NullableVector<std::string>& name_vec = buffer->get<std::string>("name");
+
+    for (size_t cnt=0; cnt < buffer->size(); ++cnt)
+        if (!name_vec.isNull(cnt))
+            names.insert(name_vec.get(cnt));
+
+    return names;
+}
+
+/**
+ * Returns existsTable for table name.
+ */
+bool DBInterface::existsMinMaxTable ()
+{
+    return existsTable(TABLE_NAME_MINMAX);
+}
+
+bool DBInterface::existsMinMaxCountColumns ()
+{
+    QMutexLocker locker(&connection_mutex_);
+
+    auto info_it = table_info_.find (TABLE_NAME_MINMAX);
+
+    return info_it != table_info_.end() && info_it->second.hasColumn("null_count")
+            && info_it->second.hasColumn("row_count");
+}
+
+/**
+ * Returns existsTable for table name.
+ */
+bool DBInterface::existsPropertiesTable ()
+{
+    return existsTable(TABLE_NAME_PROPERTIES);
 }
 
 bool DBInterface::hasDataSourceTables (DBObject& object)
@@ -729,11 +963,11 @@ bool DBInterface::hasProperty (const std::string& id)
 }
 
 void DBInterface::insertMinMax (const std::string& id, const std::string& object_name, const std::string& min,
-                                const std::string& max)
+                                const std::string& max, size_t null_count, size_t row_count)
 {
     QMutexLocker locker(&connection_mutex_);
 
-    std::string str = sql_generator_.getInsertMinMaxStatement(id, object_name, min, max);
+    std::string str = sql_generator_.getInsertMinMaxStatement(id, object_name, min, max, null_count, row_count);
     current_connection_->executeSQL (str);
 }
 
@@ -869,32 +1103,72 @@ void DBInterface::postProcess ()
 
     if (!existsMinMaxTable())
         createMinMaxTable();
-    else
-        clearTableContent (TABLE_NAME_MINMAX);
+    else if (!existsMinMaxCountColumns()) // created by older version
+        addMinMaxCountColumns();
+
+    if (!existsPropertiesTable())
+        createPropertiesTable ();
+
+    // added before the statistics jobs, which are run after it since it is not read-only
+    JobManager::instance().addDBJob(std::make_shared<CreateIndexesDBJob> (*this), JobPriority::POSTPROCESSING);
+
+    // one job per table, since tables can be shared by objects
+    std::map <std::string, std::shared_ptr<TableStatisticsDBJob>> table_jobs;
+    postprocess_table_objects_.clear();
+    postprocess_data_source_columns_.clear();
 
     for (auto obj_it : ATSDB::instance().objectManager())
     {
-        if (!obj_it.second->hasData())
+        DBObject& object = *obj_it.second;
+
+        if (!object.hasData())
             continue;
 
+        std::vector <const DBTable*> tables;
+        tables.push_back(&object.currentMetaTable().mainTable());
+
+        for (auto& table_it : object.currentMetaTable().subTables())
         {
-            DBOActiveDataSourcesDBJob* job = new DBOActiveDataSourcesDBJob (ATSDB::instance().interface(),
-                                                                            *obj_it.second);
+            if (table_it.second.existsInDB())
+                tables.push_back(&table_it.second);
+            else
+                loginf << "DBInterface: postProcess: table '" << table_it.first << " does not exist in db";
+        }
 
-            std::shared_ptr<Job> shared_job = std::shared_ptr<Job> (job);
-            connect (job, SIGNAL(doneSignal()), this, SLOT(postProcessingJobDoneSlot()), Qt::QueuedConnection);
-            JobManager::instance().addDBJob(shared_job);
-            postprocess_jobs_.push_back(shared_job);
+        for (auto table : tables)
+        {
+            if (!table_jobs.count(table->name()))
+                table_jobs[table->name()] = std::make_shared<TableStatisticsDBJob> (*this, *table);
+
+            postprocess_table_objects_[table->name()].push_back(object.name());
         }
+
+        if (object.hasCurrentDataSourceDefinition())
         {
-            DBOMinMaxDBJob* job = new DBOMinMaxDBJob (ATSDB::instance().interface(), *obj_it.second);
-            std::shared_ptr<Job> shared_job = std::shared_ptr<Job> (job);
-            connect (job, SIGNAL(doneSignal()), this, SLOT(postProcessingJobDoneSlot()), Qt::QueuedConnection);
-            JobManager::instance().addDBJob(shared_job);
-            postprocess_jobs_.push_back(shared_job);
+            std::string local_key_dbovar = object.currentDataSourceDefinition().localKey();
+            assert (object.hasVariable(local_key_dbovar));
+            const DBTableColumn& local_key_col = object.variable(local_key_dbovar).currentDBColumn();
+            const std::string& table_name = local_key_col.table().name();
+
+            if (table_jobs.count(table_name))
+            {
+                table_jobs.at(table_name)->addDistinctColumn(local_key_col.name());
+                postprocess_data_source_columns_[object.name()] = {table_name, local_key_col.name()};
+            }
+            else
+                logwrn << "DBInterface: postProcess: object " << object.name() << " data source table '"
+                       << table_name << "' not read, active data sources not set";
         }
     }
 
+    for (auto& job_it : table_jobs)
+    {
+        connect (job_it.second.get(), SIGNAL(doneSignal()), this, SLOT(postProcessingJobDoneSlot()),
+                 Qt::QueuedConnection);
+        JobManager::instance().addDBJob(job_it.second, JobPriority::POSTPROCESSING);
+        postprocess_jobs_.push_back(job_it.second);
+    }
+
     assert (!postprocess_dialog_);
     postprocess_dialog_ = new QProgressDialog (tr("Post-Processing"), tr(""), 0,
                                                static_cast<int>(postprocess_jobs_.size()));
@@ -920,6 +1194,12 @@ void DBInterface::postProcessingJobDoneSlot()
         Job *current = job_it->get();
         if (current == job_sender)
         {
+            if ((*job_it)->done() && !(*job_it)->failed())
+                postprocess_done_jobs_.push_back(*job_it);
+            else
+                logwrn << "DBInterface: postProcessingJobDoneSlot: job for table " << (*job_it)->table().name()
+                       << " failed, statistics not stored";
+
             postprocess_jobs_.erase(job_it);
             found = true;
             break;
@@ -929,6 +1209,14 @@ void DBInterface::postProcessingJobDoneSlot()
 
     if (postprocess_jobs_.size() == 0)
     {
+        // stored when no table is read anymore, so writing does not wait on the read connections
+        for (auto& job_it : postprocess_done_jobs_)
+            storeTableStatistics (*job_it);
+
+        postprocess_done_jobs_.clear();
+        postprocess_table_objects_.clear();
+        postprocess_data_source_columns_.clear();
+
         loginf << "DBInterface: postProcessingJobDoneSlot: done";
         setPostProcessed(true);
 
@@ -941,6 +1229,240 @@ void DBInterface::postProcessingJobDoneSlot()
         postprocess_dialog_->setValue(postprocess_job_num_-postprocess_jobs_.size());
 }
 
+void DBInterface::storeTableStatistics (const TableStatisticsDBJob& job)
+{
+    const DBTable& table = job.table();
+
+    logdbg << "DBInterface: storeTableStatistics: table " << table.name() << " rows " << job.rowCount();
+
+    if (!job.rowCount())
+        logwrn << "DBInterface: storeTableStatistics: table '" << table.name() << "' has no data";
+
+    std::string min;
+    std::string max;
+
+    for (auto& object_name : postprocess_table_objects_[table.name()])
+    {
+        for (auto& stat_it : job.columnStatistics())
+        {
+            const ColumnStatistics& statistics = *stat_it.second;
+
+            if (!statistics.hasValue())
+            {
+                loginf << "DBInterface: storeTableStatistics: id " << stat_it.first << " object " << object_name
+                       << " has NULL values";
+                continue;
+            }
+
+            min = statistics.minString();
+            max = statistics.maxString();
+            formatMinMax (table.column(stat_it.first), min, max);
+
+            logdbg << "DBInterface: storeTableStatistics: inserting id " << stat_it.first << " object "
+                   << object_name << " min " << min << " max " << max;
+            insertMinMax(stat_it.first, object_name, min, max, statistics.nullCount(), job.rowCount());
+        }
+    }
+
+    for (auto& ds_it : postprocess_data_source_columns_)
+    {
+        if (ds_it.second.first != table.name())
+            continue;
+
+        if (!job.distinctValues().count(ds_it.second.second)) // not collected, as not an integer column
+            continue;
+
+        std::stringstream ss;
+        bool first = true;
+
+        for (int ds_id : job.distinctValues().at(ds_it.second.second))
+        {
+            if (!first)
+                ss << ",";
+            ss << ds_id;
+            first = false;
+        }
+
+        setProperty(ACTIVE_DATA_SOURCES_PROPERTY_PREFIX+ds_it.first, ss.str());
+        loginf << "DBInterface: storeTableStatistics: dbo " << ds_it.first << " active sensors '" << ss.str() << "'";
+    }
+}
+
+void DBInterface::formatMinMax (const DBTableColumn& column, std::string& min, std::string& max)
+{
+    const std::string& data_format = column.dataFormat();
+
+    if (data_format == "")
+        ;
+    else if (data_format == "hexadecimal")
+    {
+        min = std::to_string(std::stoi(min, 0, 16));
+        max = std::to_string(std::stoi(max, 0, 16));
+    }
+    else if (data_format == "octal")
+    {
+        min = std::to_string(std::stoi(min, 0, 8));
+        max = std::to_string(std::stoi(max, 0, 8));
+    }
+    else
+        logwrn << "DBInterface: formatMinMax: column '" << column.name() << "' unknown format '"
+               << data_format << "'";
+}
+
+void DBInterface::mergeStatistics (DBObject& object,
+                                   const std::map<std::string, std::unique_ptr<ColumnStatistics>>& column_statistics,
+                                   size_t inserted_rows, const std::set<int>& data_sources)
+{
+    if (!existsMinMaxTable()) // not post-processed yet, created by postProcess
+    {
+        logdbg << "DBInterface: mergeStatistics: no minmax table, object " << object.name() << " skipped";
+        return;
+    }
+
+    if (!existsMinMaxCountColumns()) // post-processed by older version, counts unknown until post-processed again
+    {
+        logwrn << "DBInterface: mergeStatistics: minmax table without counts, object " << object.name()
+               << " skipped";
+        return;
+    }
+
+    logdbg << "DBInterface: mergeStatistics: object " << object.name() << " columns " << column_statistics.size()
+           << " inserted rows " << inserted_rows;
+
+    const MetaDBTable& meta_table = object.currentMetaTable();
+
+    PropertyList list;
+    list.addProperty("variable_name", PropertyDataType::STRING);
+    list.addProperty("min", PropertyDataType::STRING);
+    list.addProperty("max", PropertyDataType::STRING);
+    list.addProperty("null_count", PropertyDataType::LONGINT);
+    list.addProperty("row_count", PropertyDataType::LONGINT);
+
+    std::shared_ptr<Buffer> stored;
+
+    {
+        QMutexLocker locker(&connection_mutex_);
+
+        DBCommand command;
+        command.set(sql_generator_.getSelectMinMaxCountsStatement(object.name()));
+        command.list(list);
+
+        std::shared_ptr<DBResult> result = current_connection_->execute(command);
+
+        assert (result);
+        assert (result->containsData());
+        stored = result->buffer();
+    }
+
+    assert (stored);
+
+    NullableVector<std::string>& stored_names = stored->get<std::string>("variable_name");
+    NullableVector<std::string>& stored_mins = stored->get<std::string>("min");
+    NullableVector<std::string>& stored_maxs = stored->get<std::string>("max");
+    NullableVector<long int>& stored_null_counts = stored->get<long int>("null_count");
+    NullableVector<long int>& stored_row_counts = stored->get<long int>("row_count");
+
+    std::map<std::string, unsigned int> stored_indexes; // variable name -> row in stored
+
+    for (unsigned int cnt=0; cnt < stored->size(); ++cnt)
+        if (!stored_names.isNull(cnt))
+            stored_indexes[stored_names.get(cnt)] = cnt;
+
+    std::string min;
+    std::string max;
+
+    for (auto& col_it : meta_table.columns())
+    {
+        const DBTableColumn& column = col_it.second;
+        auto stat_it = column_statistics.find(col_it.first);
+
+        if (stat_it == column_statistics.end() && !inserted_rows) // not updated
+            continue;
+
+        // formatted values are stored as decimal numbers
+        bool decimal = column.dataFormat() == "hexadecimal" || column.dataFormat() == "octal";
+        std::unique_ptr<ColumnStatistics> merged = ColumnStatistics::create(
+                    decimal ? PropertyDataType::LONGINT : column.propertyType());
+
+        size_t null_count = 0;
+        size_t row_count = inserted_rows;
+
+        if (stat_it != column_statistics.end())
+        {
+            const ColumnStatistics& statistics = *stat_it->second;
+
+            if (statistics.hasValue())
+            {
+                min = statistics.minString();
+                max = statistics.maxString();
+                formatMinMax (column, min, max);
+                merged->merge(min, max);
+            }
+
+            if (inserted_rows)
+                null_count = statistics.nullCount();
+        }
+        else // not written, null in all inserted rows
+            null_count = inserted_rows;
+
+        if (stored_indexes.count(col_it.first))
+        {
+            unsigned int index = stored_indexes.at(col_it.first);
+
+            try
+            {
+                if (!stored_mins.isNull(index) && !stored_maxs.isNull(index))
+                    merged->merge(stored_mins.get(index), stored_maxs.get(index));
+            }
+            catch (std::exception& e)
+            {
+                logwrn << "DBInterface: mergeStatistics: object " << object.name() << " variable " << col_it.first
+                       << " stored minimum/maximum ignored: " << e.what();
+            }
+
+            if (!stored_null_counts.isNull(index))
+                null_count += stored_null_counts.get(index);
+
+            if (!stored_row_counts.isNull(index))
+                row_count += stored_row_counts.get(index);
+        }
+
+        if (!merged->hasValue()) // only NULL values, not stored as in postProcess
+            continue;
+
+        insertMinMax(col_it.first, object.name(), merged->minString(), merged->maxString(), null_count, row_count);
+    }
+
+    if (data_sources.size())
+    {
+        std::set<int> active = data_sources;
+
+        if (hasActiveDataSources(object))
+        {
+            std::set<int> stored_active = getActiveDataSources(object);
+
+            if (std::includes(stored_active.begin(), stored_active.end(), active.begin(), active.end()))
+                return; // no new ones
+
+            active.insert(stored_active.begin(), stored_active.end());
+        }
+
+        std::stringstream ss;
+        bool first = true;
+
+        for (int ds_id : active)
+        {
+            if (!first)
+                ss << ",";
+            ss << ds_id;
+            first = false;
+        }
+
+        setProperty(ACTIVE_DATA_SOURCES_PROPERTY_PREFIX+object.name(), ss.str());
+        loginf << "DBInterface: mergeStatistics: dbo " << object.name() << " active sensors '" << ss.str() << "'";
+    }
+}
+
 bool DBInterface::hasActiveDataSources (DBObject &object)
 {
     if (!object.existsInDB())
@@ -1017,26 +1539,80 @@ void DBInterface::insertBuffer (MetaDBTable& meta_table, std::shared_ptr<Buffer>
 {
     loginf << "DBInterface: insertBuffer: meta " << meta_table.name() << " buffer size " << buffer->size();
 
-    std::shared_ptr<Buffer> partial_buffer = getPartialBuffer(meta_table.mainTable(), buffer);
-    assert (partial_buffer->size());
-    insertBuffer(meta_table.mainTable(), partial_buffer);
+    // maintaining indexes row by row is slower than rebuilding them for large inserts. rebuilding covers the
+    // existing rows too, so only done if the insert is at least as large, otherwise appending in batches would
+    // rebuild over a growing table
+    bool rebuild_indexes = !bulk_import_active_ && buffer->size() >= index_rebuild_min_rows_;
 
-    for (auto& sub_it : meta_table.subTables())
+    if (rebuild_indexes && existsTable(meta_table.mainTable().name()))
+    {
+        size_t row_count = count(meta_table.mainTable().name());
+        rebuild_indexes = buffer->size() >= row_count;
+
+        logdbg << "DBInterface: insertBuffer: table " << meta_table.mainTable().name() << " rows " << row_count
+               << " rebuild indexes " << rebuild_indexes;
+    }
+
+    if (rebuild_indexes)
     {
-        partial_buffer = getPartialBuffer(sub_it.second, buffer);
-        assert (partial_buffer->size());
-        insertBuffer(sub_it.second, partial_buffer);
+        dropIndexes(meta_table.mainTable());
+
+        for (auto& sub_it : meta_table.subTables())
+            dropIndexes(sub_it.second);
+    }
+
+    try
+    {
+        BufferView partial_buffer = getPartialBuffer(meta_table.mainTable(), BufferView(buffer));
+        assert (partial_buffer.size());
+        insertBuffer(meta_table.mainTable(), partial_buffer);
+
+        for (auto& sub_it : meta_table.subTables())
+        {
+            partial_buffer = getPartialBuffer(sub_it.second, BufferView(buffer));
+            assert (partial_buffer.size());
+            insertBuffer(sub_it.second, partial_buffer);
+        }
+    }
+    catch (std::exception& e)
+    {
+        if (rebuild_indexes) // restore dropped ones, the original error is kept
+        {
+            logerr << "DBInterface: insertBuffer: insert failed, restoring indexes: " << e.what();
+
+            try
+            {
+                createIndexes(meta_table.mainTable());
+
+                for (auto& sub_it : meta_table.subTables())
+                    createIndexes(sub_it.second);
+            }
+            catch (std::exception& index_e)
+            {
+                logerr << "DBInterface: insertBuffer: restoring indexes failed: " << index_e.what();
+            }
+        }
+
+        throw;
+    }
+
+    if (rebuild_indexes)
+    {
+        createIndexes(meta_table.mainTable());
+
+        for (auto& sub_it : meta_table.subTables())
+            createIndexes(sub_it.second);
     }
 }
 
-void DBInterface::insertBuffer (DBTable& table, std::shared_ptr<Buffer> buffer)
+void DBInterface::insertBuffer (DBTable& table, const BufferView& buffer)
 {
-    loginf << "DBInterface: partialInsertBuffer: table " << table.name() << " buffer size " << buffer->size();
+    loginf << "DBInterface: partialInsertBuffer: table " << table.name() << " buffer size " << buffer.size();
 
     assert (current_connection_);
-    assert (buffer);
+    assert (buffer.buffer());
 
-    const PropertyList &properties = buffer->properties();
+    const PropertyList &properties = buffer.properties();
 
     for (unsigned int cnt=0; cnt < properties.size(); ++cnt)
     {
@@ -1052,20 +1628,21 @@ void DBInterface::insertBuffer (DBTable& table, std::shared_ptr<Buffer> buffer)
 
     assert (table.existsInDB());
 
-    std::string bind_statement = sql_generator_.insertDBUpdateStringBind(buffer, table.name());
-
     QMutexLocker locker(&connection_mutex_);
 
+    if (buffer.endIndex() > buffer.fromIndex() && current_connection_->insertColumns(
+                table.name(), properties, buffer.columns(), buffer.fromIndex(), buffer.endIndex()-1))
+        return;
+
+    std::string bind_statement = sql_generator_.insertDBUpdateStringBind(properties, table.name());
+
     logdbg  << "DBInterface: partialInsertBuffer: preparing bind statement";
     current_connection_->prepareBindStatement(bind_statement);
     current_connection_->beginBindTransaction();
 
     logdbg  << "DBInterface: partialInsertBuffer: starting inserts";
-    size_t size = buffer->size();
-    for (unsigned int cnt=0; cnt < size; ++cnt)
-    {
-        insertBindStatementUpdateForCurrentIndex(buffer, cnt);
-    }
+    if (buffer.endIndex() > buffer.fromIndex())
+        current_connection_->bindColumns(buffer.columns(), buffer.fromIndex(), buffer.endIndex()-1);
 
     logdbg  << "DBInterface: partialInsertBuffer: ending bind transactions";
     current_connection_->endBindTransaction();
@@ -1073,11 +1650,11 @@ void DBInterface::insertBuffer (DBTable& table, std::shared_ptr<Buffer> buffer)
     current_connection_->finalizeBindStatement();
 }
 
-std::shared_ptr<Buffer> DBInterface::getPartialBuffer (DBTable& table, std::shared_ptr<Buffer> buffer)
+BufferView DBInterface::getPartialBuffer (DBTable& table, const BufferView& buffer)
 {
-    logdbg << "DBInterface: getPartialBuffer: table " << table.name() << " buffer size " << buffer->size();
+    logdbg << "DBInterface: getPartialBuffer: table " << table.name() << " buffer size " << buffer.size();
 
-    PropertyList org_properties = buffer->properties();
+    const PropertyList& org_properties = buffer.properties();
     PropertyList partial_properties;
 
     for (unsigned int cnt=0; cnt < org_properties.size(); ++cnt)
@@ -1095,10 +1672,10 @@ std::shared_ptr<Buffer> DBInterface::getPartialBuffer (DBTable& table, std::shar
                    << " skipping property " << org_prop.name();
     }
 
-    std::shared_ptr<Buffer> tmp_buffer = buffer->getPartialCopy(partial_properties);
+    BufferView partial_buffer (buffer.buffer(), partial_properties, buffer.fromIndex());
 
-    logdbg << "DBInterface: getPartialBuffer: end with partial buffer size " << tmp_buffer->size();
-    return tmp_buffer;
+    logdbg << "DBInterface: getPartialBuffer: end with partial buffer size " << partial_buffer.size();
+    return partial_buffer;
 }
 
 bool DBInterface::checkUpdateBuffer (DBObject &object, DBOVariable &key_var, DBOVariableSet& list,
@@ -1150,8 +1727,8 @@ void DBInterface::updateBuffer (MetaDBTable& meta_table, const DBTableColumn& ke
     logdbg << "DBInterface: updateBuffer: meta " << meta_table.name() << " buffer size " << buffer->size()
            << " key " << key_col.identifier();
 
-    std::shared_ptr<Buffer> partial_buffer = getPartialBuffer(meta_table.mainTable(), buffer);
-    assert (partial_buffer->size());
+    BufferView partial_buffer = getPartialBuffer(meta_table.mainTable(), BufferView(buffer));
+    assert (partial_buffer.size());
     updateBuffer(meta_table.mainTable(), key_col, partial_buffer, from_index, to_index);
 
     for (auto& sub_it : meta_table.subTables())
@@ -1162,8 +1739,8 @@ void DBInterface::updateBuffer (MetaDBTable& meta_table, const DBTableColumn& ke
             logdbg << "DBInterface: updateBuffer: got sub table " << sub_it.second.name()
                    << " key col " << sub_key_col.identifier();
 
-            partial_buffer = getPartialBuffer(sub_it.second, buffer);
-            if (partial_buffer->size())
+            partial_buffer = getPartialBuffer(sub_it.second, BufferView(buffer));
+            if (partial_buffer.size())
             {
                 logdbg << "DBInterface: updateBuffer: doing update for sub table " << sub_it.second.name();
                 updateBuffer(sub_it.second, sub_key_col, partial_buffer, from_index, to_index);
@@ -1176,17 +1753,17 @@ void DBInterface::updateBuffer (MetaDBTable& meta_table, const DBTableColumn& ke
     }
 }
 
-void DBInterface::updateBuffer (DBTable& table, const DBTableColumn& key_col, std::shared_ptr<Buffer> buffer,
+void DBInterface::updateBuffer (DBTable& table, const DBTableColumn& key_col, const BufferView& buffer,
                                 int from_index, int to_index)
 {
-    logdbg << "DBInterface: updateBuffer: table " << table.name() << " buffer size " << buffer->size()
+    logdbg << "DBInterface: updateBuffer: table " << table.name() << " buffer size " << buffer.size()
            << " key " << key_col.identifier();
 
     //assert (checkUpdateBuffer(object, key_var, buffer));
     assert (current_connection_);
-    assert (buffer);
+    assert (buffer.buffer());
 
-    const PropertyList &properties = buffer->properties();
+    const PropertyList &properties = buffer.properties();
 
     for (unsigned int cnt=0; cnt < properties.size(); cnt++)
     {
@@ -1195,7 +1772,7 @@ void DBInterface::updateBuffer (DBTable& table, const DBTableColumn& key_col, st
                                       +"' does not exist in table "+table.name());
     }
 
-    std::string bind_statement =  sql_generator_.createDBUpdateStringBind(buffer, key_col, table.name());
+    std::string bind_statement =  sql_generator_.createDBUpdateStringBind(properties, key_col, table.name());
 
     QMutexLocker locker(&connection_mutex_);
 
@@ -1206,14 +1783,11 @@ void DBInterface::updateBuffer (DBTable& table, const DBTableColumn& key_col, st
     if (from_index < 0)
         from_index = 0;
     if (to_index < 0)
-        to_index = buffer->size()-1;
+        to_index = buffer.endIndex()-1;
 
-    logdbg  << "DBInterface: updateBuffer: starting inserts";
-    for (int cnt=from_index; cnt <= to_index; cnt++)
-    {
-        logdbg  << "DBInterface: updateBuffer: insert cnt " << cnt;
-        insertBindStatementUpdateForCurrentIndex(buffer, cnt);
-    }
+    logdbg  << "DBInterface: updateBuffer: starting updates";
+    if (to_index >= from_index)
+        current_connection_->bindColumns(buffer.columns(), from_index, to_index);
 
     logdbg  << "DBInterface: updateBuffer: ending bind transactions";
     current_connection_->endBindTransaction();
@@ -1221,9 +1795,11 @@ void DBInterface::updateBuffer (DBTable& table, const DBTableColumn& key_col, st
     current_connection_->finalizeBindStatement();
 }
 
-void DBInterface::prepareRead (const DBObject &dbobject, DBOVariableSet read_list, std::string custom_filter_clause,
-                               std::vector <DBOVariable *> filtered_variables, bool use_order,
-                               DBOVariable *order_variable, bool use_order_ascending, const std::string &limit)
+DBConnection* DBInterface::prepareRead (const DBObject &dbobject, DBOVariableSet read_list,
+                                        std::string custom_filter_clause,
+                                        std::vector <DBOVariable *> filtered_variables, bool use_order,
+                                        DBOVariable *order_variable, bool use_order_ascending,
+                                        const std::string &limit)
 {
     assert (current_connection_);
 
@@ -1238,59 +1814,231 @@ void DBInterface::prepareRead (const DBObject &dbobject, DBOVariableSet read_lis
     if (order_variable)
         assert (order_variable->existsInDB());
 
-    connection_mutex_.lock();
-
     std::shared_ptr<DBCommand> read = sql_generator_.getSelectCommand (
                 dbobject.currentMetaTable(), read_list, custom_filter_clause, filtered_variables, use_order,
                 order_variable, use_order_ascending, limit, true);
 
     loginf  << "DBInterface: prepareRead: dbo " << dbobject.name() << " sql '" << read->get() << "'";
-    current_connection_->prepareCommand(read);
+
+    return prepareReadCommand(read);
 }
 
 /**
- * Retrieves result from connection stepPreparedCommand, calls activateKeySearch on buffer and returns it.
+ * Retrieves result from readChunk, sets the DBO name in the buffer and returns it.
  */
-std::shared_ptr <Buffer> DBInterface::readDataChunk (const DBObject &dbobject)
+std::shared_ptr <Buffer> DBInterface::readDataChunk (DBConnection* connection, const DBObject &dbobject,
+                                                     unsigned int max_results)
+{
+    std::shared_ptr <Buffer> buffer = readChunk (connection, max_results);
+
+    buffer->dboName(dbobject.name());
+
+    return buffer;
+}
+
+DBConnection* DBInterface::prepareTableRead (const DBTable& table, const PropertyList& columns)
 {
-    // locked by prepareRead
     assert (current_connection_);
+    assert (table.existsInDB());
+
+    std::shared_ptr<DBCommand> read = sql_generator_.getTableSelectCommand (table, columns);
+
+    loginf  << "DBInterface: prepareTableRead: table " << table.name() << " sql '" << read->get() << "'";
+
+    return prepareReadCommand(read);
+}
+
+DBConnection* DBInterface::prepareReadCommand (std::shared_ptr<DBCommand> read)
+{
+    DBConnection* connection = acquireReadConnection();
+    assert (connection);
+
+    try
+    {
+        connection->prepareCommand(read);
+    }
+    catch (std::exception& e)
+    {
+        logerr << "DBInterface: prepareReadCommand: prepare failed: " << e.what();
+
+        try
+        {
+            connection->finalizeCommand(); // resets prepared command of connection
+        }
+        catch (std::exception& finalize_e)
+        {
+            logerr << "DBInterface: prepareReadCommand: finalize failed: " << finalize_e.what();
+        }
+
+        releaseReadConnection(connection); // main connection would stay locked otherwise
+        throw;
+    }
+
+    return connection;
+}
 
-    std::shared_ptr <DBResult> result = current_connection_->stepPreparedCommand(read_chunk_size_);
+/**
+ * Retrieves result from connection stepPreparedCommand, sets the last one flag and returns its buffer.
+ */
+std::shared_ptr <Buffer> DBInterface::readChunk (DBConnection* connection, unsigned int max_results)
+{
+    // acquired by prepareRead or prepareTableRead
+    assert (connection);
+    assert (max_results);
+
+    std::shared_ptr <DBResult> result = connection->stepPreparedCommand(max_results);
 
     if (!result)
     {
-        logerr  << "DBInterface: readDataChunk: connection returned error";
-        throw std::runtime_error ("DBInterface: readDataChunk: connection returned error");
+        logerr  << "DBInterface: readChunk: connection returned error";
+        throw std::runtime_error ("DBInterface: readChunk: connection returned error");
     }
 
     if (!result->containsData())
     {
-        logerr  << "DBInterface: readDataChunk: buffer does not contain data";
-        throw std::runtime_error ("DBInterface: readDataChunk: buffer does not contain data");
+        logerr  << "DBInterface: readChunk: buffer does not contain data";
+        throw std::runtime_error ("DBInterface: readChunk: buffer does not contain data");
     }
 
     std::shared_ptr <Buffer> buffer = result->buffer();
 
-    buffer->dboName(dbobject.name());
-
     assert (buffer);
 
-    bool last_one = current_connection_->getPreparedCommandDone();
+    bool last_one = connection->getPreparedCommandDone();
     buffer->lastOne (last_one);
 
     return buffer;
 }
 
+unsigned int DBInterface::maxReadChunkSize (const PropertyList& properties)
+{
+    unsigned int row_size = std::max (properties.rowSizeInBytes(), 1u);
+    unsigned int max_chunk_size = read_chunk_bytes_ / row_size;
+
+    max_chunk_size = std::min (max_chunk_size, max_read_chunk_size_);
+    max_chunk_size = std::max (max_chunk_size, min_read_chunk_size_);
 
-void DBInterface::finalizeReadStatement (const DBObject &dbobject)
+    logdbg << "DBInterface: maxReadChunkSize: row size " << row_size << " max chunk size " << max_chunk_size;
+
+    return std::max (max_chunk_size, 1u);
+}
+
+unsigned int DBInterface::nextReadChunkSize (unsigned int chunk_size, unsigned int max_chunk_size,
+                                             double fetch_ms_per_row, double transform_ms_per_row)
 {
-    connection_mutex_.unlock();
-    assert (current_connection_);
+    assert (max_chunk_size);
+
+    double next_size;
+
+    if (!chunk_size) // first one
+        next_size = max_chunk_size/8;
+    else if (transform_ms_per_row <= 0 || fetch_ms_per_row >= transform_ms_per_row) // fetching is slower
+        next_size = 2.0*chunk_size;
+    else // transformation is slower, fetching waits anyway
+        next_size = read_chunk_target_ms_ / transform_ms_per_row;
+
+    next_size = std::min (next_size, (double) max_chunk_size);
+    next_size = std::max (next_size, (double) std::min (min_read_chunk_size_, max_chunk_size));
+
+    return next_size;
+}
+
+void DBInterface::finalizeReadStatement (DBConnection* connection, const DBObject &dbobject)
+{
+    assert (connection);
 
-    logdbg  << "DBInterface: finishReadSystemTracks: start ";
+    logdbg  << "DBInterface: finalizeReadStatement: dbo " << dbobject.name();
     //prepared_.at(dbobject.name())=false;
-    current_connection_->finalizeCommand();
+    connection->finalizeCommand();
+
+    releaseReadConnection(connection);
+}
+
+void DBInterface::finalizeTableRead (DBConnection* connection)
+{
+    assert (connection);
+
+    connection->finalizeCommand();
+
+    releaseReadConnection(connection);
+}
+
+DBConnection* DBInterface::acquireReadConnection ()
+{
+    {
+        QMutexLocker locker(&read_connections_mutex_);
+
+        if (read_connections_.size()) // re-use idle one
+        {
+            DBConnection* connection = read_connections_.back().release();
+            read_connections_.pop_back();
+            used_read_connections_.insert(connection);
+            return connection;
+        }
+
+        if (num_read_connections_ < max_read_connections_)
+        {
+            assert (current_connection_);
+            std::unique_ptr<DBConnection> connection = current_connection_->createReadConnection();
+
+            if (connection)
+            {
+                ++num_read_connections_;
+                loginf << "DBInterface: acquireReadConnection: created read connection "
+                       << num_read_connections_;
+                used_read_connections_.insert(connection.get());
+                return connection.release();
+            }
+        }
+    }
+
+    // not supported or all in use, read on main connection
+    logdbg << "DBInterface: acquireReadConnection: using main connection";
+    connection_mutex_.lock();
+    return current_connection_;
+}
+
+void DBInterface::releaseReadConnection (DBConnection* connection)
+{
+    assert (connection);
+
+    if (connection == current_connection_)
+    {
+        connection_mutex_.unlock();
+        return;
+    }
+
+    QMutexLocker locker(&read_connections_mutex_);
+
+    if (!used_read_connections_.erase(connection))
+    {
+        // cleared while in use, might refer to a closed database
+        logdbg << "DBInterface: releaseReadConnection: deleting stale read connection";
+        connection->disconnect();
+        delete connection;
+        return;
+    }
+
+    read_connections_.push_back(std::unique_ptr<DBConnection> (connection));
+}
+
+void DBInterface::clearReadConnections ()
+{
+    QMutexLocker locker(&read_connections_mutex_);
+
+    assert (read_connections_.size() + used_read_connections_.size() == num_read_connections_);
+
+    if (used_read_connections_.size())
+        logwrn << "DBInterface: clearReadConnections: " << used_read_connections_.size()
+               << " read connections still in use, deleted when released";
+
+    for (auto& connection_it : read_connections_)
+        connection_it->disconnect();
+
+    // connections in use are no longer counted and not re-used
+    used_read_connections_.clear();
+    num_read_connections_ = 0;
+    read_connections_.clear();
 }
 
 void DBInterface::createPropertiesTable ()
@@ -1312,114 +2060,38 @@ void DBInterface::createMinMaxTable ()
     updateTableInfo ();
 }
 
-void DBInterface::clearTableContent (const std::string& table_name)
+void DBInterface::addMinMaxCountColumns ()
 {
-    QMutexLocker locker(&connection_mutex_);
-    //DELETE FROM tablename;
-    current_connection_->executeSQL("DELETE FROM "+table_name+";");
+    assert (existsMinMaxTable());
+    assert (!existsMinMaxCountColumns());
+
+    loginf << "DBInterface: addMinMaxCountColumns";
+
+    {
+        QMutexLocker locker(&connection_mutex_);
+
+        for (auto& statement_it : sql_generator_.getTableMinMaxAddCountColumnsStatements())
+            current_connection_->executeSQL(statement_it);
+    }
+
+    updateTableInfo ();
 }
 
-std::shared_ptr<DBResult> DBInterface::queryMinMaxNormalForTable (const DBTable& table)
+void DBInterface::clearTableContent (const std::string& table_name)
 {
     QMutexLocker locker(&connection_mutex_);
-    logdbg  << "DBInterface: queryMinMaxForTable: getting command";
-    std::shared_ptr <DBCommand> command = sql_generator_.getTableSelectMinMaxNormalStatement (table);
-
-    //loginf  << "DBInterface: queryMinMaxForTable: executing command '" << command->getCommandString() << "'";
-    std::shared_ptr<DBResult> result = current_connection_->execute(*command);
-    return result;
+    //DELETE FROM tablename;
+    current_connection_->executeSQL("DELETE FROM "+table_name+";");
 }
 
-void DBInterface::insertBindStatementUpdateForCurrentIndex (std::shared_ptr<Buffer> buffer, unsigned int row)
+void DBInterface::dropTable (const std::string& table_name)
 {
-    assert (buffer);
-    logdbg  << "DBInterface: insertBindStatementUpdateForCurrentIndex: start";
-    const PropertyList &list =buffer->properties();
-    unsigned int size = list.size();
-    logdbg  << "DBInterface: insertBindStatementUpdateForCurrentIndex: creating bind for " << size << " elements";
-
-    std::string connection_type = current_connection_->type();
-
-    assert (connection_type == MYSQL_IDENTIFIER || connection_type == SQLITE_IDENTIFIER);
-
-    unsigned int index_cnt=0;
-
-    logdbg << "DBInterface: insertBindStatementUpdateForCurrentIndex: starting for loop";
-    for (unsigned int cnt=0; cnt < size; cnt++)
     {
-        const Property &property = list.at(cnt);
-        PropertyDataType data_type = property.dataType();
-
-        logdbg  << "DBInterface: insertBindStatementUpdateForCurrentIndex: at cnt " << cnt << " id "
-                << property.name() << " index cnt " << index_cnt;
-
-        if (connection_type == SQLITE_IDENTIFIER)
-            index_cnt=cnt+1;
-        else if (connection_type == MYSQL_IDENTIFIER)
-            index_cnt=cnt+1;
-        else
-            throw std::runtime_error ("DBInterface: insertBindStatementForCurrentIndex: unknown db type");
-
-        if (buffer->isNone(property, row))
-        {
-            current_connection_->bindVariableNull (index_cnt);
-            logdbg  << "DBInterface: insertBindStatementUpdateForCurrentIndex: at " << cnt << " is null";
-            continue;
-        }
-
-        switch (data_type)
-        {
-        case PropertyDataType::BOOL:
-            current_connection_->bindVariable (index_cnt,
-                                               static_cast<int> (buffer->get<bool>(property.name()).get(row)));
-            break;
-        case PropertyDataType::CHAR:
-            current_connection_->bindVariable (index_cnt,
-                                               static_cast<int> (buffer->get<char>(property.name()).get(row)));
-            break;
-        case PropertyDataType::UCHAR:
-            current_connection_->bindVariable (index_cnt,
-                                               static_cast<int> (buffer->get<unsigned char>(property.name()).get(row)));
-            break;
-        case PropertyDataType::INT:
-            logdbg  << "DBInterface: insertBindStatementUpdateForCurrentIndex: at " << cnt << " is '"
-                    << buffer->get<int>(property.name()).get(row) << "'";
-            current_connection_->bindVariable (index_cnt,
-                                               static_cast<int> (buffer->get<int>(property.name()).get(row)));
-            break;
-        case PropertyDataType::UINT:
-            assert (false);
-            break;
-        case PropertyDataType::LONGINT:
-            assert (false);
-            break;
-        case PropertyDataType::ULONGINT:
-            assert (false);
-            break;
-        case PropertyDataType::FLOAT:
-            current_connection_->bindVariable (index_cnt,
-                                               static_cast<double> (buffer->get<float>(property.name()).get(row)));
-            break;
-        case PropertyDataType::DOUBLE:
-            current_connection_->bindVariable (index_cnt, buffer->get<double>(property.name()).get(row));
-            break;
-        case PropertyDataType::STRING:
-            if (connection_type == SQLITE_IDENTIFIER)
-                current_connection_->bindVariable (index_cnt, buffer->get<std::string>(property.name()).get(row));
-            else //MYSQL assumed
-                current_connection_->bindVariable (index_cnt, "'"+buffer->get<std::string>(property.name()).get(row)+"'");
-            break;
-        default:
-            logerr  <<  "Buffer: insertBindStatementUpdateForCurrentIndex: unknown property type "
-                     << Property::asString(data_type);
-            throw std::runtime_error ("Buffer: insertBindStatementUpdateForCurrentIndex: unknown property type "
-                                      + Property::asString(data_type));
-        }
+        QMutexLocker locker(&connection_mutex_);
+        current_connection_->executeSQL("DROP TABLE "+table_name+";");
     }
 
-    current_connection_->stepAndClearBindings();
-
-    logdbg  << "DBInterface: insertBindStatementUpdateForCurrentIndex: done";
+    updateTableInfo ();
 }
 
 //DBResult *DBInterface::getDistinctStatistics (const std::string &type, DBOVariable *variable, unsigned int sensor_number)
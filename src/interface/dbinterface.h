@@ -21,6 +21,7 @@
 #include <QMutex>
 #include <set>
 #include <memory>
+#include <vector>
 #include <qobject.h>
 
 #include "configurable.h"
@@ -34,7 +35,11 @@ static const std::string TABLE_NAME_MINMAX = "atsdb_minmax";
 
 class ATSDB;
 class Buffer;
+class BufferView;
+class ColumnHandle;
+class ColumnStatistics;
 class BufferWriter;
+class DBCommand;
 class DBConnection;
 class DBOVariable;
 class DBTable;
@@ -47,6 +52,7 @@ class DBTableInfo;
 class DBInterfaceWidget;
 class DBInterfaceInfoWidget;
 class Job;
+class TableStatisticsDBJob;
 class BufferWriter;
 
 class SQLGenerator;
@@ -117,26 +123,50 @@ public:
 //    void insertBuffer (DBTable& table, std::shared_ptr<Buffer> buffer, size_t from_index,
 //                       size_t to_index);
     void insertBuffer (MetaDBTable& meta_table, std::shared_ptr<Buffer> buffer);
-    void insertBuffer (DBTable& table, std::shared_ptr<Buffer> buffer);
+    void insertBuffer (DBTable& table, const BufferView& buffer);
 
     bool checkUpdateBuffer (DBObject &object, DBOVariable &key_var, DBOVariableSet& list,
                             std::shared_ptr<Buffer> buffer);
     void updateBuffer (MetaDBTable& meta_table, const DBTableColumn& key_col, std::shared_ptr<Buffer> buffer,
                        int from_index=-1, int to_index=-1); // no indexes means full buffer
-    void updateBuffer (DBTable& table, const DBTableColumn& key_col, std::shared_ptr<Buffer> buffer,
+    void updateBuffer (DBTable& table, const DBTableColumn& key_col, const BufferView& buffer,
                        int from_index=-1, int to_index=-1); // no indexes means full buffer
 
-    std::shared_ptr<Buffer> getPartialBuffer (DBTable& table, std::shared_ptr<Buffer> buffer);
-
-    //    /// @brief Prepares incremental read of DBO type
-    void prepareRead (const DBObject &dbobject, DBOVariableSet read_list, std::string custom_filter_clause,
-                      std::vector <DBOVariable *> filtered_variables, bool use_order=false,
-                      DBOVariable *order_variable=nullptr, bool use_order_ascending=false, const std::string &limit="");
-
-    /// @brief Returns data chunk of DBO type
-    std::shared_ptr <Buffer> readDataChunk (const DBObject &dbobject);
-    /// @brief Cleans up incremental read of DBO type
-    void finalizeReadStatement (const DBObject &dbobject);
+    /// @brief Returns view on the columns of buffer which exist in table
+    BufferView getPartialBuffer (DBTable& table, const BufferView& buffer);
+
+    /**
+     * @brief Prepares incremental read of DBO type, returns connection to read from
+     *
+     * Uses an additional read connection if supported, so reads can run concurrently. Otherwise the main connection
+     * is locked until finalizeReadStatement.
+     */
+    DBConnection* prepareRead (const DBObject &dbobject, DBOVariableSet read_list, std::string custom_filter_clause,
+                               std::vector <DBOVariable *> filtered_variables, bool use_order=false,
+                               DBOVariable *order_variable=nullptr, bool use_order_ascending=false,
+                               const std::string &limit="");
+    /// @brief Returns data chunk of DBO type with at most max_results rows
+    std::shared_ptr <Buffer> readDataChunk (DBConnection* connection, const DBObject &dbobject,
+                                            unsigned int max_results);
+    /// @brief Returns maximum number of rows of a read chunk, based on the byte budget for a chunk
+    unsigned int maxReadChunkSize (const PropertyList& properties);
+    /**
+     * @brief Returns number of rows for the next read chunk
+     *
+     * The first chunk (chunk_size 0) is small to deliver first data quickly. While fetching is slower than
+     * transformation, the size grows, since larger chunks reduce the per-chunk overhead. Otherwise it is set so that
+     * transformation of a chunk takes read_chunk_target_ms_. Never exceeds max_chunk_size.
+     */
+    unsigned int nextReadChunkSize (unsigned int chunk_size, unsigned int max_chunk_size, double fetch_ms_per_row,
+                                    double transform_ms_per_row);
+    /// @brief Cleans up incremental read of DBO type, releases connection
+    void finalizeReadStatement (DBConnection* connection, const DBObject &dbobject);
+    /// @brief Prepares incremental read of the given columns of all rows of table, returns connection to read from
+    DBConnection* prepareTableRead (const DBTable& table, const PropertyList& columns);
+    /// @brief Returns data chunk of prepared read with at most max_results rows
+    std::shared_ptr <Buffer> readChunk (DBConnection* connection, unsigned int max_results);
+    /// @brief Cleans up incremental read of table, releases connection
+    void finalizeTableRead (DBConnection* connection);
     /// @brief Sets reading_done_ flags
     //void clearResult ();
 
@@ -156,17 +186,52 @@ public:
 
     bool existsTable (const std::string& table_name);
     void createTable (DBTable& table);
+    /// @brief Creates missing secondary indexes of table, as defined by DBSchema::indexedColumns
+    void createIndexes (DBTable& table);
+    /// @brief Drops secondary indexes of table created by createIndexes
+    void dropIndexes (DBTable& table);
+    /// @brief Creates missing secondary indexes of all tables of the current schema existing in the database
+    void createIndexes ();
+    /// @brief Drops secondary indexes of all tables of the current schema created by createIndexes
+    void dropIndexes ();
+
+    /**
+     * @brief Starts bulk import session
+     *
+     * Drops secondary indexes and switches the connection to settings for fast inserts. Inserts and imports should
+     * be committed in batches of bulkCommitBytes.
+     */
+    void startBulkImport ();
+    /// @brief Ends bulk import session, rebuilds secondary indexes in parallel per table and updates statistics
+    void endBulkImport ();
+    bool bulkImportActive () const { return bulk_import_active_; }
+    /// @brief Returns number of bytes to be inserted per commit during bulk import
+    size_t bulkCommitBytes () const { return bulk_commit_bytes_; }
     /// @brief Returns if minimum/maximum table exists
     bool existsMinMaxTable ();
-    /// @brief Returns the minimum/maximum table
+    /// @brief Returns if minimum/maximum table exists with the null and row count columns, missing in older ones
+    bool existsMinMaxCountColumns ();
+    /// @brief Creates the minimum/maximum table
     void createMinMaxTable ();
+    /// @brief Adds the null and row count columns to a minimum/maximum table created by an older version
+    void addMinMaxCountColumns ();
     /// @brief Returns buffer with the minimum/maximum of a DBO variable
     std::pair<std::string, std::string> getMinMaxString (const DBOVariable& var);
     /// (dbo type, id) -> (min, max)
     std::map <std::pair<std::string, std::string>, std::pair<std::string, std::string> > getMinMaxInfo ();
-    /// @brief Inserts a minimum/maximum value pair
+    /// @brief Inserts a minimum/maximum value pair with the null and row count of the column
     void insertMinMax (const std::string& id, const std::string& object_name, const std::string& min,
-                       const std::string& max);
+                       const std::string& max, size_t null_count, size_t row_count);
+
+    /**
+     * @brief Merges statistics of rows written for object into the minimum/maximum table and active data sources
+     *
+     * Only done if statistics with counts were created by postProcess. column_statistics is by column name,
+     * inserted_rows is 0 for updated rows, for which the null and row counts are kept.
+     */
+    void mergeStatistics (DBObject& object,
+                          const std::map<std::string, std::unique_ptr<ColumnStatistics>>& column_statistics,
+                          size_t inserted_rows, const std::set<int>& data_sources);
 
     /// @brief Returns if database was post processed
     bool isPostProcessed ();
@@ -186,17 +251,14 @@ public:
 
     /// @brief Deletes table content for given table name
     void clearTableContent (const std::string& table_name);
+    /// @brief Drops table with given table name
+    void dropTable (const std::string& table_name);
 
-    /// @brief Returns minimum/maximum information for all columns in a table
-    std::shared_ptr<DBResult> queryMinMaxNormalForTable (const DBTable& table);
     //    /// @brief Returns minimum/maximum information for a given column in a table
     //    DBResult *queryMinMaxForColumn (DBTableColumn *column, std::string table);
 
     //    DBResult *getDistinctStatistics (const std::string &dbo_type, DBOVariable *variable, unsigned int sensor_number);
 
-    /// @brief Executes query and returns numbers for all active sensors
-    std::set<int> queryActiveSensorNumbers (DBObject &object);
-
     //    void deleteAllRowsWithVariableValue (DBOVariable *variable, std::string value, std::string filter);
     //    void updateAllRowsWithVariableValue (DBOVariable *variable, std::string value, std::string new_value, std::string filter);
 
@@ -218,9 +280,32 @@ protected:
 
     /// Protects the database
     QMutex connection_mutex_;
-
-    /// Size of a read chunk in incremental reading process
-    unsigned int read_chunk_size_;
+    /// Protects read_connections_, used_read_connections_ and num_read_connections_
+    QMutex read_connections_mutex_;
+    /// Idle additional connections for concurrent reading
+    std::vector<std::unique_ptr<DBConnection>> read_connections_;
+    /// Additional connections in use, connections in use but not contained are stale and deleted when released
+    std::set<DBConnection*> used_read_connections_;
+    /// Number of additional read connections, idle or in use
+    unsigned int num_read_connections_ {0};
+    /// Maximum number of additional read connections
+    unsigned int max_read_connections_;
+
+    /// Targeted size of a read chunk in bytes in incremental reading process
+    unsigned int read_chunk_bytes_;
+    /// Minimum number of rows of a read chunk
+    unsigned int min_read_chunk_size_;
+    /// Maximum number of rows of a read chunk
+    unsigned int max_read_chunk_size_;
+    /// Targeted transformation time of a read chunk in ms
+    unsigned int read_chunk_target_ms_;
+    /// Minimum number of inserted rows for which secondary indexes are dropped before and rebuilt after insertion,
+    /// only done if not fewer rows than already in the table are inserted
+    unsigned int index_rebuild_min_rows_;
+    /// Number of bytes to be inserted per commit during bulk import
+    unsigned int bulk_commit_bytes_;
+    /// Bulk import session active flag
+    bool bulk_import_active_ {false};
 
     /// Generates SQL statements
     SQLGenerator sql_generator_;
@@ -230,15 +315,39 @@ protected:
 
     std::map <std::string, DBTableInfo> table_info_;
 
-    std::vector <std::shared_ptr<Job>> postprocess_jobs_;
+    std::vector <std::shared_ptr<TableStatisticsDBJob>> postprocess_jobs_;
+    /// Finished post-processing jobs, results are stored when all are done
+    std::vector <std::shared_ptr<TableStatisticsDBJob>> postprocess_done_jobs_;
+    /// Table name -> names of objects using the table
+    std::map <std::string, std::vector<std::string>> postprocess_table_objects_;
+    /// Object name -> (table name, column name) of the data source key
+    std::map <std::string, std::pair<std::string, std::string>> postprocess_data_source_columns_;
     QProgressDialog* postprocess_dialog_ {nullptr};
     unsigned int postprocess_job_num_{0};
 
     virtual void checkSubConfigurables ();
 
-    void insertBindStatementUpdateForCurrentIndex (std::shared_ptr<Buffer> buffer, unsigned int row);
+    /// @brief Returns idle or new read connection, or the locked main connection if none is available
+    DBConnection* acquireReadConnection ();
+    /// @brief Acquires read connection and prepares read on it, releases the connection if preparing fails
+    DBConnection* prepareReadCommand (std::shared_ptr<DBCommand> read);
+    /// @brief Returns read connection to the idle ones (or deletes it if stale), or unlocks the main connection
+    void releaseReadConnection (DBConnection* connection);
+    /// @brief Disconnects and deletes idle read connections, marks ones in use as stale
+    void clearReadConnections ();
+
+    /// @brief Creates missing secondary indexes of table using connection, which has to be locked
+    void createIndexes (DBTable& table, DBConnection& connection);
+    /// @brief Creates missing secondary indexes of tables, in parallel on additional connections if supported
+    void createIndexesParallel (const std::vector <DBTable*>& tables);
+    /// @brief Returns names of all existing indexes of a table using connection, which has to be locked
+    std::set <std::string> indexNames (const std::string& table_name, DBConnection& connection);
 
     void setPostProcessed (bool value);
+    /// @brief Stores minimum/maximum values and active data sources of all objects using the table of job
+    void storeTableStatistics (const TableStatisticsDBJob& job);
+    /// @brief Converts minimum/maximum of column with data format to decimal numbers, as stored in minmax table
+    void formatMinMax (const DBTableColumn& column, std::string& min, std::string& max);
     //    /// @brief Returns buffer with min/max data from another Buffer with the string contents. Delete returned buffer yourself.
     //    Buffer *createFromMinMaxStringBuffer (Buffer *string_buffer, PropertyDataType data_type);
 };
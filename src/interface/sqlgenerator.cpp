@@ -51,7 +51,7 @@ SQLGenerator::SQLGenerator(DBInterface &db_interface)
 
     ss << "CREATE TABLE " << TABLE_NAME_MINMAX
        << " (variable_name VARCHAR(255), object_name VARCHAR(255), min VARCHAR(255), max VARCHAR(255),"
-             "PRIMARY KEY (variable_name, object_name));";
+             " null_count BIGINT, row_count BIGINT, PRIMARY KEY (variable_name, object_name));";
     table_minmax_create_statement_ = ss.str();
     ss.str(std::string());
 
@@ -170,6 +170,80 @@ std::string SQLGenerator::getCreateTableStatement (const DBTable& table)
 
 //}
 
+std::string SQLGenerator::getIndexName (const DBTableColumn& column)
+{
+    return INDEX_NAME_PREFIX+column.table().name()+"_"+column.name();
+}
+
+std::string SQLGenerator::getCreateIndexStatement (const DBTableColumn& column)
+{
+    std::string sql = "CREATE INDEX "+getIndexName(column)+" ON "+column.table().name()+" ("+column.name()+");";
+
+    loginf << "SQLGenerator: getCreateIndexStatement: sql '" << sql << "'";
+    return sql;
+}
+
+std::string SQLGenerator::getDropIndexStatement (const std::string& table_name, const std::string& index_name)
+{
+    std::string connection_type = db_interface_.connection().type();
+
+    if (connection_type == SQLITE_IDENTIFIER)
+        return "DROP INDEX "+index_name+";";
+    else if (connection_type == MYSQL_IDENTIFIER)
+        return "DROP INDEX "+index_name+" ON "+table_name+";";
+    else
+        throw std::runtime_error ("SQLGenerator: getDropIndexStatement: not yet implemented db type "
+                                  + connection_type);
+}
+
+std::shared_ptr<DBCommand> SQLGenerator::getIndexNamesCommand (const std::string& table_name)
+{
+    std::string connection_type = db_interface_.connection().type();
+
+    std::shared_ptr<DBCommand> command (new DBCommand ());
+
+    if (connection_type == SQLITE_IDENTIFIER)
+        command->set ("SELECT name FROM sqlite_master WHERE type = 'index' AND tbl_name = '"+table_name+"';");
+    else if (connection_type == MYSQL_IDENTIFIER)
+        command->set ("SELECT DISTINCT index_name FROM information_schema.statistics WHERE table_schema = DATABASE()"
+                      " AND table_name = '"+table_name+"';");
+    else
+        throw std::runtime_error ("SQLGenerator: getIndexNamesCommand: not yet implemented db type "
+                                  + connection_type);
+
+    PropertyList list;
+    list.addProperty("name", PropertyDataType::STRING);
+    command->list(list);
+
+    return command;
+}
+
+std::string SQLGenerator::getAnalyzeStatement (const std::vector<std::string>& table_names)
+{
+    std::string connection_type = db_interface_.connection().type();
+
+    if (connection_type == SQLITE_IDENTIFIER)
+        return "ANALYZE;";
+    else if (connection_type == MYSQL_IDENTIFIER)
+    {
+        assert (table_names.size());
+
+        std::string sql = "ANALYZE TABLE ";
+
+        for (auto name_it = table_names.begin(); name_it != table_names.end(); ++name_it)
+        {
+            if (name_it != table_names.begin())
+                sql += ", ";
+            sql += *name_it;
+        }
+
+        return sql+";";
+    }
+    else
+        throw std::runtime_error ("SQLGenerator: getAnalyzeStatement: not yet implemented db type "
+                                  + connection_type);
+}
+
 std::shared_ptr<DBCommand> SQLGenerator::getDataSourcesSelectCommand (DBObject &object)
 {
     assert (object.hasCurrentDataSourceDefinition ());
@@ -272,24 +346,31 @@ std::shared_ptr<DBCommand> SQLGenerator::getDataSourcesSelectCommand (DBObject &
     return getSelectCommand (meta, columns);
 }
 
-std::shared_ptr<DBCommand> SQLGenerator::getDistinctDataSourcesSelectCommand (DBObject &object)
+std::shared_ptr<DBCommand> SQLGenerator::getTableSelectCommand (const DBTable& table, const PropertyList& columns)
 {
-    // "SELECT DISTINCT sensor_number__value FROM " << table_names_.at(DBO_PLOTS) << " WHERE mapped_position__present = '1' AND sensor_number__present = '1' ORDER BY sensor_number__value;";
-    //return distinct_radar_numbers_statement_;
+    assert (columns.size());
+
+    std::stringstream ss;
 
-    assert (object.hasCurrentDataSourceDefinition());
+    ss << "SELECT ";
 
-    std::string local_key_dbovar = object.currentDataSourceDefinition().localKey();
-    assert (object.hasVariable(local_key_dbovar));
-    const DBTableColumn& local_key_col = object.variable(local_key_dbovar).currentDBColumn();
+    for (unsigned int cnt=0; cnt < columns.size(); ++cnt)
+    {
+        assert (table.hasColumn(columns.at(cnt).name()));
 
-    std::vector <const DBTableColumn*> columns;
-    columns.push_back(&local_key_col);
+        if (cnt != 0)
+            ss << ", ";
 
-    PropertyList list;
-    list.addProperty (local_key_col.name(), PropertyDataType::INT);
+        ss << columns.at(cnt).name();
+    }
 
-    return getSelectCommand (object.currentMetaTable(), columns, true);
+    ss << " FROM " << table.name() << ";";
+
+    std::shared_ptr<DBCommand> command (new DBCommand ());
+    command->set (ss.str());
+    command->list (columns);
+
+    return command;
 }
 
 //DBCommand *SQLGenerator::getCountStatement (const std::string &dbo_type, unsigned int sensor_number)
@@ -444,49 +525,6 @@ std::string SQLGenerator::getCountStatement (const std::string &table)
     return "SELECT COUNT(*) FROM " + table + ";";
 }
 
-std::shared_ptr <DBCommand> SQLGenerator::getTableSelectMinMaxNormalStatement (const DBTable& table)
-{
-    logdbg  << "SQLGenerator: getTableSelectMinMaxNormalStatement: start for table " << table.name();
-
-    stringstream ss;
-
-    std::shared_ptr<DBCommand> command (new DBCommand ());
-    assert (command);
-
-    PropertyList command_list;
-
-    ss << "SELECT ";
-
-    bool first=true;
-
-    for (auto col_it : table.columns())
-    {
-//        if (column->hasSpecialNull())
-//            continue;
-
-        logdbg  << "SQLGenerator: getTableSelectMinMaxNormalStatement: current name " << col_it.first;
-
-        if (!first)
-            ss << ",";
-
-        ss << "MIN("<< col_it.first <<"),MAX("<< col_it.first <<")";
-
-        command_list.addProperty(col_it.first+"MIN", PropertyDataType::STRING);
-        command_list.addProperty(col_it.first+"MAX", PropertyDataType::STRING);
-
-        first = false;
-    }
-
-    ss << " FROM " << table.name() << ";";
-
-    command->set (ss.str());
-    command->list(command_list);
-
-    logdbg  << "SQLGenerator: getTableSelectMinMaxNormalStatement: sql '" << ss.str() << "'";
-
-    return command;
-}
-
 //DBCommand *SQLGenerator::getColumnSelectMinMaxStatement (DBTableColumn *column, std::string table_name)
 //{
 //    stringstream ss;
@@ -542,11 +580,12 @@ std::string SQLGenerator::getSelectPropertyStatement (const std::string &id)
 }
 
 std::string SQLGenerator::getInsertMinMaxStatement (const std::string& variable_name, const std::string& object_name,
-                                                    const std::string& min, const std::string& max)
+                                                    const std::string& min, const std::string& max,
+                                                    size_t null_count, size_t row_count)
 {
     stringstream ss;
     ss << "REPLACE INTO " << TABLE_NAME_MINMAX << " VALUES ('" << variable_name <<"', '" << object_name <<"', '"
-       << min<< "', '"<< max <<"');";
+       << min<< "', '"<< max <<"', " << null_count << ", " << row_count << ");";
     return ss.str();
 }
 std::string SQLGenerator::getSelectMinMaxStatement (const std::string& variable_name, const std::string& object_name)
@@ -557,6 +596,14 @@ std::string SQLGenerator::getSelectMinMaxStatement (const std::string& variable_
     return ss.str();
 }
 
+std::string SQLGenerator::getSelectMinMaxCountsStatement (const std::string& object_name)
+{
+    stringstream ss;
+    ss << "SELECT variable_name,min,max,null_count,row_count FROM " << TABLE_NAME_MINMAX << " WHERE object_name = '"
+       << object_name << "';";
+    return ss.str();
+}
+
 std::string SQLGenerator::getSelectMinMaxStatement ()
 {
     stringstream ss;
@@ -569,6 +616,13 @@ std::string SQLGenerator::getTableMinMaxCreateStatement ()
     return table_minmax_create_statement_;
 }
 
+std::vector<std::string> SQLGenerator::getTableMinMaxAddCountColumnsStatements ()
+{
+    // one column per statement, as supported by all databases
+    return {"ALTER TABLE " + TABLE_NAME_MINMAX + " ADD COLUMN null_count BIGINT;",
+            "ALTER TABLE " + TABLE_NAME_MINMAX + " ADD COLUMN row_count BIGINT;"};
+}
+
 std::string SQLGenerator::getTablePropertiesCreateStatement ()
 {
     return table_properties_create_statement_;
@@ -643,14 +697,13 @@ std::string SQLGenerator::getTablePropertiesCreateStatement ()
 //    return ss.str();
 //}
 
-std::string SQLGenerator::insertDBUpdateStringBind(std::shared_ptr<Buffer> buffer, std::string tablename)
+std::string SQLGenerator::insertDBUpdateStringBind(const PropertyList& property_list, std::string tablename)
 {
-    assert (buffer);
     //assert (object.existsInDB());
     //assert (key_var.existsInDB());
     assert (tablename.size() > 0);
 
-    const std::vector <Property> &properties = buffer->properties().properties();
+    const std::vector <Property> &properties = property_list.properties();
 
     // INSERT INTO table_name (column1, column2, column3, ...) VALUES (value1, value2, value3, ...);
 
@@ -692,14 +745,13 @@ std::string SQLGenerator::insertDBUpdateStringBind(std::shared_ptr<Buffer> buffe
     return ss.str();
 }
 
-std::string SQLGenerator::createDBUpdateStringBind(std::shared_ptr<Buffer> buffer, const DBTableColumn& key_col,
+std::string SQLGenerator::createDBUpdateStringBind(const PropertyList& property_list, const DBTableColumn& key_col,
                                                    std::string tablename)
 {
-    assert (buffer);
     assert (key_col.existsInDB());
     assert (tablename.size() > 0);
 
-    const std::vector <Property> &properties = buffer->properties().properties();
+    const std::vector <Property> &properties = property_list.properties();
 
     // UPDATE table_name SET col1=val1,col2=value2 WHERE somecol=someval;
 
@@ -30,6 +30,10 @@ class MetaDBTable;
 class DBTableColumn;
 class DBObject;
 class DBTable;
+class PropertyList;
+
+/// Prefix of names of secondary indexes created from the schema
+const std::string INDEX_NAME_PREFIX="idx_";
 
 /**
  * @brief Creates SQL statements
@@ -47,11 +51,21 @@ public:
     virtual ~SQLGenerator();
 
     std::string getCreateTableStatement (const DBTable& table);
+    /// @brief Returns name of the secondary index for column
+    std::string getIndexName (const DBTableColumn& column);
+    /// @brief Returns statement to create secondary index for column
+    std::string getCreateIndexStatement (const DBTableColumn& column);
+    /// @brief Returns statement to drop secondary index of table
+    std::string getDropIndexStatement (const std::string& table_name, const std::string& index_name);
+    /// @brief Returns command to select the names of all indexes of table as strings
+    std::shared_ptr<DBCommand> getIndexNamesCommand (const std::string& table_name);
+    /// @brief Returns statement to update the query planner statistics of tables
+    std::string getAnalyzeStatement (const std::vector<std::string>& table_names);
     /// @brief Returns statement to bind variables for buffer contents
-    std::string insertDBUpdateStringBind(std::shared_ptr<Buffer> buffer, std::string tablename);
+    std::string insertDBUpdateStringBind(const PropertyList& properties, std::string tablename);
 //    std::string createDBInsertStringBind(Buffer *buffer, const std::string &tablename);
     /// @brief Returns statement to bind variables for buffer contents
-    std::string createDBUpdateStringBind(std::shared_ptr<Buffer> buffer, const DBTableColumn& key_col,
+    std::string createDBUpdateStringBind(const PropertyList& properties, const DBTableColumn& key_col,
                                          std::string tablename);
 //    /// @brief Returns statement to create table for buffer contents
 //    std::string createDBCreateString (Buffer *buffer, const std::string &tablename);
@@ -67,8 +81,8 @@ public:
     ///@brief Returns command for all data sources select for dbo
     std::shared_ptr<DBCommand> getDataSourcesSelectCommand (DBObject &object);
 
-    /// @brief Returns command for active data sources select
-    std::shared_ptr<DBCommand> getDistinctDataSourcesSelectCommand (DBObject &object);
+    /// @brief Returns command selecting the given columns of all rows of table
+    std::shared_ptr<DBCommand> getTableSelectCommand (const DBTable& table, const PropertyList& columns);
 
 //    DBCommand *getDistinctStatistics (const std::string &dbo_type, DBOVariable *variable, unsigned int sensor_number);
 
@@ -80,6 +94,8 @@ public:
 
     /// @brief Returns minimum/maximum table creation statement
     std::string getTableMinMaxCreateStatement ();
+    /// @brief Returns statements adding the null and row count columns to a minimum/maximum table lacking them
+    std::vector<std::string> getTableMinMaxAddCountColumnsStatements ();
     /// @brief Returns properties table creation statement
     std::string getTablePropertiesCreateStatement ();
 
@@ -89,16 +105,19 @@ public:
     std::string getSelectPropertyStatement (const std::string &id);
 
     /// @brief Returns minimum/maximum insertion statement
-    std::string getInsertMinMaxStatement (const std::string& variable_name, const std::string& object_name, const std::string& min, const std::string &max);
+    std::string getInsertMinMaxStatement (const std::string& variable_name, const std::string& object_name,
+                                          const std::string& min, const std::string &max, size_t null_count,
+                                          size_t row_count);
     /// @brief Returns minimum/maximum selection statement
     std::string getSelectMinMaxStatement (const std::string& variable_name, const std::string& object_name);
     std::string getSelectMinMaxStatement ();
+    /// @brief Returns selection statement of minimum/maximum and counts of all variables of an object
+    std::string getSelectMinMaxCountsStatement (const std::string& object_name);
 
 //    /// @brief Returns general info select statement
 //    DBCommand *getSelectInfoCommand(const std::string &dbo_type, std::vector<unsigned int> ids, DBOVariableSet read_list,
 //            bool use_filters, std::string order_by_variable, bool ascending, unsigned int limit_min=0,
 //            unsigned int limit_max=0);
-    std::shared_ptr<DBCommand> getTableSelectMinMaxNormalStatement (const DBTable& table);
 //    DBCommand *getColumnSelectMinMaxStatement (DBTableColumn *column, std::string table_name);
 
 //    std::string getDeleteStatement (const DBTableColumn &column, const std::string &value, const std::string &filter);
@@ -0,0 +1,107 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOUNDEDQUEUE_H_
+#define BOUNDEDQUEUE_H_
+
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+/**
+ * @brief Thread-safe FIFO queue with a maximum size, connecting the stages of a pipeline
+ *
+ * push blocks while the queue is full, so a fast producer is held back by a slow consumer. After close, push
+ * discards items and pop returns the remaining ones, then false.
+ */
+template <class T>
+class BoundedQueue
+{
+public:
+    /// @brief Constructor
+    BoundedQueue (size_t capacity) : capacity_(capacity) { assert (capacity_); }
+
+    /// @brief Appends item, waits while full, returns false if closed
+    bool push (T item)
+    {
+        std::unique_lock<std::mutex> lock (mutex_);
+
+        not_full_.wait (lock, [this] { return closed_ || items_.size() < capacity_; });
+
+        if (closed_)
+            return false;
+
+        items_.push_back(std::move(item));
+        not_empty_.notify_one();
+
+        return true;
+    }
+
+    /// @brief Removes oldest item, waits while empty, returns false if closed and empty
+    bool pop (T& item)
+    {
+        std::unique_lock<std::mutex> lock (mutex_);
+
+        not_empty_.wait (lock, [this] { return closed_ || items_.size(); });
+
+        if (items_.empty())
+            return false;
+
+        item = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+
+        return true;
+    }
+
+    /// @brief Closes queue, wakes waiting producers and consumers
+    void close ()
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+
+        closed_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+    /// @brief Removes all items
+    void clear ()
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+
+        items_.clear();
+        not_full_.notify_all();
+    }
+
+    size_t capacity () const { return capacity_; }
+
+protected:
+    size_t capacity_;
+    bool closed_ {false};
+    std::deque<T> items_;
+
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+
+private:
+    BoundedQueue (const BoundedQueue&) = delete;
+    void operator= (const BoundedQueue&) = delete;
+};
+
+#endif /* BOUNDEDQUEUE_H_ */
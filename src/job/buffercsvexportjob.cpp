@@ -21,7 +21,7 @@
 #include "buffercsvexportjob.h"
 #include "dbovariable.h"
 
-BufferCSVExportJob::BufferCSVExportJob(std::shared_ptr<Buffer> buffer, const DBOVariableSet& read_set,
+BufferCSVExportJob::BufferCSVExportJob(const BufferView& buffer, const DBOVariableSet& read_set,
                                        const std::string& file_name, bool overwrite, bool use_presentation)
     : Job("BufferCSVExportJob"), buffer_(buffer), read_set_(read_set), file_name_(file_name), overwrite_(overwrite),
       use_presentation_(use_presentation)
@@ -50,13 +50,11 @@ void BufferCSVExportJob::run ()
 
     if (output_file)
     {
-        const PropertyList &properties = buffer_->properties();
         size_t read_set_size = read_set_.getSize();
-        size_t buffer_size = buffer_->size();
+        size_t end_index = buffer_.endIndex();
         std::stringstream ss;
-        bool null;
         std::string value_str;
-        size_t row=0;
+        size_t row=buffer_.fromIndex();
 
         for (size_t col=0; col < read_set_size; col++)
         {
@@ -67,8 +65,19 @@ void BufferCSVExportJob::run ()
         }
         output_file << ss.str() << "\n";
 
+        std::vector<ColumnHandle> columns;
+        std::vector<bool> use_presentation;
 
-        for (; row < buffer_size; row++)
+        for (size_t col=0; col < read_set_size; col++)
+        {
+            DBOVariable& variable = read_set_.getVariable(col);
+            assert (buffer_.hasProperty(variable.name()));
+
+            columns.push_back(buffer_.column(variable.name()));
+            use_presentation.push_back(use_presentation_ && variable.dataType() != PropertyDataType::STRING);
+        }
+
+        for (; row < end_index; row++)
         {
             ss.str("");
 
@@ -76,139 +85,16 @@ void BufferCSVExportJob::run ()
             {
                 value_str = "";
 
-                DBOVariable& variable = read_set_.getVariable(col);
-                PropertyDataType data_type = variable.dataType();
-
-                std::string property_name = variable.name();
+                const ColumnHandle& column = columns[col];
 
-                if (data_type == PropertyDataType::BOOL)
-                {
-                    assert (buffer_->has<bool>(property_name));
-                    null = buffer_->get<bool>(property_name).isNull(row);
-                    if (!null)
-                    {
-                        if (use_presentation_)
-                            value_str = variable.getRepresentationStringFromValue(
-                                        buffer_->get<bool>(property_name).getAsString(row));
-                        else
-                            value_str = buffer_->get<bool>(property_name).getAsString(row);
-                    }
-                }
-                else if (data_type == PropertyDataType::CHAR)
-                {
-                    assert (buffer_->has<char>(property_name));
-                    null = buffer_->get<char>(property_name).isNull(row);
-                    if (!null)
-                    {
-                        if (use_presentation_)
-                            value_str = variable.getRepresentationStringFromValue(
-                                        buffer_->get<char>(property_name).getAsString(row));
-                        else
-                            value_str = buffer_->get<char>(property_name).getAsString(row);
-                    }
-                }
-                else if (data_type == PropertyDataType::UCHAR)
-                {
-                    assert (buffer_->has<unsigned char>(property_name));
-                    null = buffer_->get<unsigned char>(property_name).isNull(row);
-                    if (!null)
-                    {
-                        if (use_presentation_)
-                            value_str = variable.getRepresentationStringFromValue(
-                                        buffer_->get<unsigned char>(property_name).getAsString(row));
-                        else
-                            value_str = buffer_->get<unsigned char>(property_name).getAsString(row);
-                    }
-                }
-                else if (data_type == PropertyDataType::INT)
-                {
-                    assert (buffer_->has<int>(property_name));
-                    null = buffer_->get<int>(property_name).isNull(row);
-                    if (!null)
-                    {
-                        if (use_presentation_)
-                            value_str = variable.getRepresentationStringFromValue(
-                                        buffer_->get<int>(property_name).getAsString(row));
-                        else
-                            value_str = buffer_->get<int>(property_name).getAsString(row);
-                    }
-                }
-                else if (data_type == PropertyDataType::UINT)
-                {
-                    assert (buffer_->has<unsigned int>(property_name));
-                    null = buffer_->get<unsigned int>(properties.at(col).name()).isNull(row);
-                    if (!null)
-                    {
-                        if (use_presentation_)
-                            value_str = variable.getRepresentationStringFromValue(
-                                        buffer_->get<unsigned int>(property_name).getAsString(row));
-                        else
-                            value_str = buffer_->get<unsigned int>(property_name).getAsString(row);
-                    }
-                }
-                else if (data_type == PropertyDataType::LONGINT)
-                {
-                    assert (buffer_->has<long int>(property_name));
-                    null = buffer_->get<long int>(property_name).isNull(row);
-                    if (!null)
-                    {
-                        if (use_presentation_)
-                            value_str = variable.getRepresentationStringFromValue(
-                                        buffer_->get<long int>(property_name).getAsString(row));
-                        else
-                            value_str = buffer_->get<long int>(property_name).getAsString(row);
-                    }
-                }
-                else if (data_type == PropertyDataType::ULONGINT)
-                {
-                    assert (buffer_->has<unsigned long int>(property_name));
-                    null = buffer_->get<unsigned long int>(property_name).isNull(row);
-                    if (!null)
-                    {
-                        if (use_presentation_)
-                            value_str = variable.getRepresentationStringFromValue(
-                                        buffer_->get<unsigned long int>(property_name).getAsString(row));
-                        else
-                            value_str = buffer_->get<unsigned long int>(property_name).getAsString(row);
-                    }
-                }
-                else if (data_type == PropertyDataType::FLOAT)
-                {
-                    assert (buffer_->has<float>(property_name));
-                    null = buffer_->get<float>(properties.at(col).name()).isNull(row);
-                    if (!null)
-                    {
-                        if (use_presentation_)
-                            value_str = variable.getRepresentationStringFromValue(
-                                        buffer_->get<float>(property_name).getAsString(row));
-                        else
-                            value_str = buffer_->get<float>(property_name).getAsString(row);
-                    }
-                }
-                else if (data_type == PropertyDataType::DOUBLE)
-                {
-                    assert (buffer_->has<double>(property_name));
-                    null = buffer_->get<double>(property_name).isNull(row);
-                    if (!null)
-                    {
-                        if (use_presentation_)
-                            value_str = variable.getRepresentationStringFromValue(
-                                        buffer_->get<double>(property_name).getAsString(row));
-                        else
-                            value_str = buffer_->get<double>(property_name).getAsString(row);
-                    }
-                }
-                else if (data_type == PropertyDataType::STRING)
+                if (!column.isNull(row))
                 {
-                    assert (buffer_->has<std::string>(property_name));
-                    null = buffer_->get<std::string>(property_name).isNull(row);
-                    if (!null)
-                    {
-                        value_str = buffer_->get<std::string>(property_name).getAsString(row);
-                    }
+                    if (use_presentation[col])
+                        value_str = read_set_.getVariable(col).getRepresentationStringFromValue(
+                                    column.getAsString(row));
+                    else
+                        value_str = column.getAsString(row);
                 }
-                else
-                    throw std::domain_error ("BufferCSVExportJob: run: unknown property data type");
 
                 if (col != 0)
                     ss << ";";
@@ -223,7 +109,8 @@ void BufferCSVExportJob::run ()
         boost::posix_time::time_duration diff = stop_time_ - start_time_;
 
         if (diff.total_seconds() > 0)
-            loginf  << "BufferCSVExportJob: run: done after " << diff << ", " << 1000.0*row/diff.total_milliseconds() << " el/s";
+            loginf  << "BufferCSVExportJob: run: done after " << diff << ", "
+                      << 1000.0*buffer_.size()/diff.total_milliseconds() << " el/s";
     }
     else
     {
@@ -22,20 +22,20 @@
 #include <memory>
 
 #include "job.h"
-#include "buffer.h"
+#include "bufferview.h"
 #include "dbovariableset.h"
 
 class BufferCSVExportJob : public Job
 {
 public:
-    BufferCSVExportJob(std::shared_ptr<Buffer> buffer, const DBOVariableSet& read_set, const std::string& file_name,
+    BufferCSVExportJob(const BufferView& buffer, const DBOVariableSet& read_set, const std::string& file_name,
                        bool overwrite, bool use_presentation);
     virtual ~BufferCSVExportJob();
 
     virtual void run ();
 
 protected:
-    std::shared_ptr<Buffer> buffer_;
+    BufferView buffer_;
     DBOVariableSet read_set_;
 
     std::string file_name_;
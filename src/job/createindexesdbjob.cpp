@@ -15,32 +15,36 @@
  * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <QThread>
+#include "createindexesdbjob.h"
+#include "dbinterface.h"
+#include "logger.h"
 
-#include "finalizedboreadjob.h"
-#include "dbobject.h"
-#include "dbovariableset.h"
-#include "buffer.h"
-
-FinalizeDBOReadJob::FinalizeDBOReadJob(DBObject &dbobject, DBOVariableSet &read_list, std::shared_ptr<Buffer> buffer)
-    : Job("FinalizeDBOReadJob"), dbobject_(dbobject), read_list_(read_list), buffer_ (buffer)
+CreateIndexesDBJob::CreateIndexesDBJob (DBInterface& db_interface)
+: Job("CreateIndexesDBJob"), db_interface_(db_interface)
 {
-    assert (buffer_);
 }
 
-FinalizeDBOReadJob::~FinalizeDBOReadJob()
+CreateIndexesDBJob::~CreateIndexesDBJob()
 {
-
 }
 
-void FinalizeDBOReadJob::run ()
+void CreateIndexesDBJob::run ()
 {
-    logdbg << "FinalizeDBOReadJob: run: read_list size " << read_list_.getSize();
+    loginf << "CreateIndexesDBJob: run";
+
     started_ = true;
 
-    buffer_->transformVariables(read_list_, true);
+    try
+    {
+        db_interface_.createIndexes();
+    }
+    catch (std::exception& e)
+    {
+        logerr << "CreateIndexesDBJob: run: creating indexes failed: " << e.what();
+        failed_ = true;
+    }
 
-    logdbg << "FinalizeDBOReadJob: run: done";
     done_=true;
-}
 
+    loginf << "CreateIndexesDBJob: run: done";
+}
@@ -15,37 +15,34 @@
  * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#ifndef DBOMINMAXDBJOB_H_
-#define DBOMINMAXDBJOB_H_
+#ifndef CREATEINDEXESDBJOB_H_
+#define CREATEINDEXESDBJOB_H_
 
 #include "job.h"
 
-class DBObject;
 class DBInterface;
-class DBTable;
 
 /**
- * @brief Post-processing Job
- *
- * Updates meta-information about database content: A list of active data sources and minimum/maximum values of all
- * variables.
+ * @brief Creates the secondary indexes of all tables of the current schema
  *
+ * Used by the post-processing, since creating the indexes takes long for large tables, so it is not done in the GUI
+ * thread. Added as DB job before the table statistics jobs, which then profit from the indexes.
  */
-class DBOMinMaxDBJob : public Job
+class CreateIndexesDBJob : public Job
 {
 public:
-    DBOMinMaxDBJob(DBInterface& db_interface, const DBObject& object);
-    virtual ~DBOMinMaxDBJob();
+    CreateIndexesDBJob (DBInterface& db_interface);
+    virtual ~CreateIndexesDBJob ();
 
     virtual void run ();
 
+    /// @brief Returns if creating the indexes failed, only valid when done
+    bool failed () const { return failed_; }
+
 protected:
     DBInterface& db_interface_;
-    const DBObject& object_;
-    /// @brief Creates minimum/maximum table and values
-    //void createMinMaxValuesSpecial ();
-    void createMinMaxValuesNormal ();
-    void processTable (const DBTable& table);
+
+    bool failed_ {false};
 };
 
-#endif /* DBOMINMAXDBJOB_H_ */
+#endif /* CREATEINDEXESDBJOB_H_ */
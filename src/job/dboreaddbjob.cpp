@@ -15,11 +15,14 @@
  * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <thread>
+
 #include "dboreaddbjob.h"
 #include "dbobject.h"
 #include "dbovariable.h"
 #include "propertylist.h"
 #include "dbinterface.h"
+#include "dbtablecolumn.h"
 #include "buffer.h"
 #include "logger.h"
 
@@ -63,44 +66,102 @@ void DBOReadDBJob::run ()
 
     start_time_ = boost::posix_time::microsec_clock::local_time();
 
-    db_interface_.prepareRead (dbobject_, read_list_, custom_filter_clause_, filtered_variables_, use_order_,
-                               order_variable_, use_order_ascending_, limit_str_);
+    DBConnection* connection = nullptr;
 
-    unsigned int cnt=0;
-    unsigned int row_count=0;
-    while (!done_)
+    try
+    {
+        connection = db_interface_.prepareRead (dbobject_, read_list_, custom_filter_clause_, filtered_variables_,
+                                                use_order_, order_variable_, use_order_ascending_, limit_str_);
+    }
+    catch (std::exception& e) // connection released by prepareRead
     {
-        std::shared_ptr<Buffer> buffer = db_interface_.readDataChunk(dbobject_);
-        assert (buffer);
+        logerr << "DBOReadDBJob: run: " << dbobject_.name() << ": prepare failed: " << e.what();
+
+        obsolete_=true;
+        done_=true;
+        return;
+    }
+
+    BoundedQueue<std::shared_ptr<Buffer>> chunks (DBO_READ_MAX_PENDING_CHUNKS);
+    std::thread merge_thread (&DBOReadDBJob::transformAndMerge, this, std::ref(chunks));
 
-        cnt++;
+    PropertyList properties;
+    for (auto& var_it : read_list_.getSet())
+        properties.addProperty(var_it->currentDBColumn().name(), var_it->currentDBColumn().propertyType());
+
+    unsigned int max_chunk_size = db_interface_.maxReadChunkSize(properties);
+    unsigned int chunk_size = db_interface_.nextReadChunkSize(0, max_chunk_size, 0, 0);
 
-        if (obsolete_)
+    unsigned int cnt=0;
+
+    try
+    {
+        while (1)
         {
-            loginf << "DBOReadDBJob: run: " << dbobject_.name() << ": obsolete after prepared";
-            break;
+            boost::posix_time::ptime fetch_start = boost::posix_time::microsec_clock::local_time();
+
+            std::shared_ptr<Buffer> buffer = db_interface_.readDataChunk(connection, dbobject_, chunk_size);
+            assert (buffer);
+
+            double fetch_ms = (boost::posix_time::microsec_clock::local_time() - fetch_start).total_microseconds()
+                    / 1000.0;
+
+            cnt++;
+
+            if (obsolete_ || failed_)
+            {
+                loginf << "DBOReadDBJob: run: " << dbobject_.name() << ": obsolete after prepared";
+                break;
+            }
+
+            assert (buffer->dboName() == dbobject_.name());
+
+            logdbg << "DBOReadDBJob: run: " << dbobject_.name() << ": fetched #buffers " << cnt << " size "
+                   << buffer->size() << " in " << fetch_ms << " ms, last one " << buffer->lastOne();
+
+            bool last_one = buffer->lastOne();
+
+            if (!chunks.push(buffer)) // waits if transformation is behind
+                break;
+
+            if (last_one)
+                break;
+
+            if (buffer->size())
+                chunk_size = db_interface_.nextReadChunkSize(chunk_size, max_chunk_size, fetch_ms/buffer->size(),
+                                                             transform_ms_per_row_);
         }
+    }
+    catch (std::exception& e)
+    {
+        logerr << "DBOReadDBJob: run: " << dbobject_.name() << ": read failed: " << e.what();
 
-        assert (buffer->dboName() == dbobject_.name());
+        failed_=true; // remaining chunks are discarded
+        chunks.close();
+        merge_thread.join();
 
-        logdbg << "DBOReadDBJob: run: " << dbobject_.name() << ": intermediate signal, #buffers "
-               << cnt << " last one " << buffer->lastOne();
-        row_count += buffer->size();
-        emit intermediateSignal(buffer);
+        db_interface_.finalizeReadStatement(connection, dbobject_);
 
-        if (buffer->lastOne())
-            break;
+        obsolete_=true;
+        done_=true;
+        return;
     }
 
+    chunks.close();
+    merge_thread.join();
+
+    if (failed_) // transformation failed, merge thread is joined
+        obsolete_=true;
+
     loginf << "DBOReadDBJob: run: " << dbobject_.name() << ": finalizing statement";
-    db_interface_.finalizeReadStatement(dbobject_);
+    db_interface_.finalizeReadStatement(connection, dbobject_);
 
     stop_time_ = boost::posix_time::microsec_clock::local_time();
     boost::posix_time::time_duration diff = stop_time_ - start_time_;
 
     if (diff.total_seconds() > 0)
         loginf << "DBOReadDBJob: run: " << dbobject_.name() << ": done after " << diff << ", "
-               << 1000.0*row_count/diff.total_milliseconds() << " el/s";
+               << 1000.0*row_count_/diff.total_milliseconds() << " el/s";
 
 
     done_=true;
@@ -108,3 +169,45 @@ void DBOReadDBJob::run ()
     loginf << "DBOReadDBJob: run: " << dbobject_.name() << ": done";
     return;
 }
+
+void DBOReadDBJob::transformAndMerge (BoundedQueue<std::shared_ptr<Buffer>>& chunks)
+{
+    std::shared_ptr<Buffer> chunk;
+
+    while (chunks.pop(chunk))
+    {
+        if (obsolete_ || failed_) // discard remaining ones
+            continue;
+
+        boost::posix_time::ptime transform_start = boost::posix_time::microsec_clock::local_time();
+        size_t chunk_size = chunk->size();
+
+        try
+        {
+            chunk->transformVariables(read_list_, true);
+
+            if (!buffer_)
+            {
+                buffer_ = chunk;
+                buffer_->reserve(dbobject_.count()); // upper bound for rows to be loaded
+            }
+            else
+                buffer_->seizeBuffer (*chunk.get());
+        }
+        catch (std::exception& e)
+        {
+            logerr << "DBOReadDBJob: transformAndMerge: " << dbobject_.name() << ": failed: " << e.what();
+            failed_ = true;
+            chunks.close();
+            continue;
+        }
+
+        if (chunk_size)
+            transform_ms_per_row_ = (boost::posix_time::microsec_clock::local_time() - transform_start)
+                    .total_microseconds() / 1000.0 / chunk_size;
+
+        row_count_ = buffer_->size();
+
+        emit progressSignal();
+    }
+}
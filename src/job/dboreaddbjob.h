@@ -20,24 +20,38 @@
 
 #include "boost/date_time/posix_time/posix_time.hpp"
 
+#include <atomic>
+
 #include "job.h"
+#include "boundedqueue.h"
 #include "dbovariableset.h"
 
 class Buffer;
 class DBObject;
 class DBInterface;
 
+/// Maximum number of read chunks waiting for transformation, limits memory if reading is faster
+const size_t DBO_READ_MAX_PENDING_CHUNKS=4;
+
 /**
  * @brief DBO reading job
  *
- * Incrementally reads data record from DBO tables and writes the results into a DBDataSet.
+ * Incrementally reads data record from DBO tables and writes the results into a single buffer.
  *
+ * Runs as a pipeline of two stages: the job thread fetches chunks from the database, while a second thread
+ * transforms the variables of the fetched chunks and merges them into the result buffer. At most
+ * DBO_READ_MAX_PENDING_CHUNKS chunks wait between the stages, otherwise fetching waits. The result buffer is only to
+ * be used after the job is done.
+ *
+ * The number of rows per chunk is adapted from the measured fetch and transformation times, see
+ * DBInterface::nextReadChunkSize.
  */
 class DBOReadDBJob : public Job
 {
     Q_OBJECT
 signals:
-    void intermediateSignal (std::shared_ptr<Buffer> buffer);
+    /// @brief Emitted after a chunk was merged, with rowCount updated
+    void progressSignal ();
 
 public:
     DBOReadDBJob(DBInterface &db_interface, DBObject &dbobject, DBOVariableSet read_list, std::string custom_filter_clause,
@@ -47,8 +61,15 @@ public:
 
     virtual void run ();
 
+    virtual bool readOnly () { return true; }
+
     DBOVariableSet &readList () { return read_list_; }
 
+    /// @brief Returns result buffer, nullptr if no data was read. Only to be called when done
+    std::shared_ptr<Buffer> buffer () { assert (done_); return buffer_; }
+    /// @brief Returns number of rows merged so far
+    size_t rowCount () { return row_count_; }
+
 protected:
     DBInterface &db_interface_;
     DBObject &dbobject_;
@@ -62,6 +83,18 @@ protected:
 
     boost::posix_time::ptime start_time_;
     boost::posix_time::ptime stop_time_;
+
+    /// Merged chunks
+    std::shared_ptr<Buffer> buffer_;
+    std::atomic<size_t> row_count_ {0};
+    /// Flag if fetching or transformation failed, set and read by both stages
+    std::atomic<bool> failed_ {false};
+
+    /// Measured transformation and merge time per row of the last chunk, 0 if none yet
+    std::atomic<double> transform_ms_per_row_ {0};
+
+    /// @brief Transforms and merges chunks until the queue is closed and empty, runs in own thread
+    void transformAndMerge (BoundedQueue<std::shared_ptr<Buffer>>& chunks);
 };
 
 #endif /* DBOREADDBJOB_H_ */
@@ -0,0 +1,50 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "endbulkimportdbjob.h"
+#include "dbinterface.h"
+#include "logger.h"
+
+EndBulkImportDBJob::EndBulkImportDBJob (DBInterface& db_interface)
+: Job("EndBulkImportDBJob"), db_interface_(db_interface)
+{
+}
+
+EndBulkImportDBJob::~EndBulkImportDBJob()
+{
+}
+
+void EndBulkImportDBJob::run ()
+{
+    loginf << "EndBulkImportDBJob: run";
+
+    started_ = true;
+
+    try
+    {
+        db_interface_.endBulkImport();
+    }
+    catch (std::exception& e)
+    {
+        logerr << "EndBulkImportDBJob: run: ending bulk import failed: " << e.what();
+        failed_ = true;
+    }
+
+    done_=true;
+
+    loginf << "EndBulkImportDBJob: run: done";
+}
@@ -15,33 +15,34 @@
  * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#ifndef DBOACTIVEDATASOURCESDBJOB_H_
-#define DBOACTIVEDATASOURCESDBJOB_H_
+#ifndef ENDBULKIMPORTDBJOB_H_
+#define ENDBULKIMPORTDBJOB_H_
 
 #include "job.h"
 
 class DBInterface;
-class DBObject;
 
 /**
- * @brief Generates the active data sources information for a DBObject
+ * @brief Ends the bulk import session of the database interface
  *
- * For a given DBObject type, uses the DBInterface to generate the active data sources. The compacted information is
- * added as property string.
+ * Rebuilds the secondary indexes and updates the planner statistics, which takes long for large imports, so it is
+ * not done in the GUI thread. Added as DB job after the inserts of the import.
  */
-class DBOActiveDataSourcesDBJob : public Job
+class EndBulkImportDBJob : public Job
 {
 public:
-    DBOActiveDataSourcesDBJob(DBInterface& db_interface, DBObject &object);
-    virtual ~DBOActiveDataSourcesDBJob();
+    EndBulkImportDBJob (DBInterface& db_interface);
+    virtual ~EndBulkImportDBJob ();
 
     virtual void run ();
 
-    DBObject& dbObject () { return object_; }
+    /// @brief Returns if ending the session failed, only valid when done
+    bool failed () const { return failed_; }
 
 protected:
     DBInterface& db_interface_;
-    DBObject &object_;
+
+    bool failed_ {false};
 };
 
-#endif /* DBOACTIVEDATASOURCESDBJOB_H_ */
+#endif /* ENDBULKIMPORTDBJOB_H_ */
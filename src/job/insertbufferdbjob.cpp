@@ -18,6 +18,7 @@
 #include "boost/date_time/posix_time/posix_time.hpp"
 
 #include "buffer.h"
+#include "columnstatistics.h"
 #include "insertbufferdbjob.h"
 #include "dbinterface.h"
 #include "dbobject.h"
@@ -55,6 +56,18 @@ void InsertBufferDBJob::run ()
     assert (buffer_->size());
 
     db_interface_.insertBuffer(dbobject_.currentMetaTable(), buffer_);
+
+    // statistics of the written rows are merged, so post-processing does not have to be repeated
+    try
+    {
+        db_interface_.mergeStatistics(dbobject_, ColumnStatistics::create(*buffer_), buffer_->size(),
+                                      dbobject_.dataSourceKeys(*buffer_));
+    }
+    catch (std::exception& e) // data is written, only statistics are outdated
+    {
+        logerr << "InsertBufferDBJob: run: merging statistics failed: " << e.what();
+    }
+
     loading_stop_time_ = boost::posix_time::microsec_clock::local_time();
 
     double load_time;
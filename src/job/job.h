@@ -22,6 +22,11 @@
 #include <QRunnable>
 #include <memory>
 
+/// @brief Priority lanes of jobs, in order of descending priority
+enum class JobPriority { INTERACTIVE=0, LOAD, POSTPROCESSING, EXPORT };
+
+const unsigned int NUM_JOB_PRIORITIES=4;
+
 /**
  * @brief Encapsulates a work-package
  *
@@ -60,6 +65,13 @@ public:
 
     const std::string &name() { return name_; }
 
+    /// @brief Returns priority lane, set when added to the JobManager
+    JobPriority priority () { return priority_; }
+    void priority (JobPriority priority) { priority_=priority; }
+
+    /// @brief Returns if DB job only reads from the database, so it can run concurrently with other reading ones
+    virtual bool readOnly () { return false; }
+
 protected:
     std::string name_;
     ///
@@ -68,6 +80,8 @@ protected:
     bool done_ {false};
     /// Obsolete flag
     bool obsolete_ {false};
+    /// Priority lane
+    JobPriority priority_ {JobPriority::INTERACTIVE};
 
     virtual void setDone () { done_=true; }
 };
@@ -15,23 +15,84 @@
  * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
 #include <qtimer.h>
-#include <QThreadPool>
+#include <QMutexLocker>
 #include <QCoreApplication>
 
 #include "jobmanager.h"
 #include "jobmanagerwidget.h"
 #include "job.h"
+#include "workerpool.h"
 #include "logger.h"
 #include "stringconv.h"
 
 using namespace Utils;
 
+/**
+ * @brief Runs a Job in the thread pool and notifies the JobManager when finished
+ *
+ * Holds a reference to the job while running, is deleted by the thread pool.
+ */
+class JobRunner : public QRunnable
+{
+public:
+    JobRunner (std::shared_ptr<Job> job) : job_(job) {}
+
+    virtual void run()
+    {
+        job_->run();
+        JobManager::instance().notifyChange();
+    }
+
+protected:
+    std::shared_ptr<Job> job_;
+};
+
 JobManager::JobManager()
     : Configurable ("JobManager", "JobManager0", 0, "threads.xml"), stop_requested_(false), stopped_(false),
       widget_(nullptr)
 {
     logdbg  << "JobManager: constructor";
+
+    registerParameter ("num_threads", &num_threads_, 0);
+    registerParameter ("max_interactive_threads", &max_interactive_threads_, 0);
+    registerParameter ("max_load_threads", &max_load_threads_, 0);
+    registerParameter ("max_postprocessing_threads", &max_postprocessing_threads_, 0);
+    registerParameter ("max_export_threads", &max_export_threads_, 0);
+    registerParameter ("max_db_read_jobs", &max_db_read_jobs_, 4);
+
+    if (!max_db_read_jobs_)
+        max_db_read_jobs_ = 1;
+
+    unsigned int num_threads = num_threads_;
+    if (!num_threads)
+        num_threads = std::max (QThread::idealThreadCount(), 1);
+
+    std::array<unsigned int, NUM_JOB_PRIORITIES> lane_limits;
+    lane_limits.at(static_cast<size_t>(JobPriority::INTERACTIVE)) = max_interactive_threads_;
+
+    // default background lanes share all but one thread, which is kept free for interactive jobs
+    unsigned int background_threads = std::max (num_threads-1, 1u);
+    unsigned int export_threads = max_export_threads_ ? max_export_threads_ : 1;
+    unsigned int postprocessing_threads = max_postprocessing_threads_ ? max_postprocessing_threads_
+                                                                      : std::max ((background_threads-1)/2, 1u);
+    unsigned int load_threads = max_load_threads_;
+    if (!load_threads)
+    {
+        unsigned int used_threads = export_threads + postprocessing_threads;
+        load_threads = background_threads > used_threads ? background_threads - used_threads : 1;
+    }
+
+    lane_limits.at(static_cast<size_t>(JobPriority::LOAD)) = load_threads;
+    lane_limits.at(static_cast<size_t>(JobPriority::POSTPROCESSING)) = postprocessing_threads;
+    lane_limits.at(static_cast<size_t>(JobPriority::EXPORT)) = export_threads;
+
+    loginf << "JobManager: constructor: lane limits interactive " << max_interactive_threads_ << " load "
+           << load_threads << " post-processing " << postprocessing_threads << " export " << export_threads;
+
+    pool_.reset(new WorkerPool (num_threads, lane_limits));
 }
 
 JobManager::~JobManager()
@@ -39,29 +100,33 @@ JobManager::~JobManager()
     logdbg  << "JobManager: destructor";
 }
 
-void JobManager::addJob (std::shared_ptr<Job> job)
+void JobManager::addJob (std::shared_ptr<Job> job, JobPriority priority)
 {
     logdbg << "JobManager: addJob: " << job->name() << " num " << jobs_.unsafe_size();
     jobs_.push(job);
 
-    QThreadPool::globalInstance()->start(job.get());
+    job->priority(priority);
+    startJob(job);
 
     updateWidget();
 }
 
-void JobManager::addNonBlockingJob (std::shared_ptr<Job> job)
+void JobManager::addNonBlockingJob (std::shared_ptr<Job> job, JobPriority priority)
 {
     loginf << "JobManager: addNonBlockingJob: " << job->name() << " num " << non_blocking_jobs_.unsafe_size();
     non_blocking_jobs_.push(job);
 
-    QThreadPool::globalInstance()->start(job.get());
+    job->priority(priority);
+    startJob(job);
 
     updateWidget();
 }
 
-void JobManager::addDBJob (std::shared_ptr<Job> job)
+void JobManager::addDBJob (std::shared_ptr<Job> job, JobPriority priority)
 {
+    job->priority(priority);
     queued_db_jobs_.push(job);
+    notifyChange();
 
     updateWidget();
 
@@ -72,11 +137,22 @@ void JobManager::addDBJob (std::shared_ptr<Job> job)
 void JobManager::cancelJob (std::shared_ptr<Job> job)
 {
     job->setObsolete();
+    notifyChange();
+}
+
+void JobManager::concurrentDBReadWrite (bool value)
+{
+    loginf << "JobManager: concurrentDBReadWrite: " << value;
+
+    concurrent_db_read_write_ = value;
+    notifyChange();
 }
 
 bool JobManager::noJobs ()
 {
-    return jobs_.empty() && non_blocking_jobs_.empty() && !active_db_job_ && queued_db_jobs_.empty();
+    QMutexLocker locker (&active_db_jobs_mutex_);
+
+    return jobs_.empty() && non_blocking_jobs_.empty() && active_db_jobs_.empty() && queued_db_jobs_.empty();
 }
 
 /**
@@ -90,6 +166,15 @@ void JobManager::run()
 
     while (1)
     {
+        {
+            QMutexLocker locker (&mutex_);
+
+            while (!changed_ && !(stop_requested_ && noJobs()))
+                condition_.wait(&mutex_);
+
+            changed_ = false;
+        }
+
         if (stop_requested_ && noJobs())
             break;
 
@@ -192,79 +277,21 @@ void JobManager::run()
         //            }
         //        }
 
-        if (active_db_job_)
-        {
-            // see if active db job done or obsolete
-            if(active_db_job_->obsolete())
-            {
-                logdbg << "JobManager: run: flushing db obsolete job";
-
-                while (!active_db_job_->done()) // wait for finish
-                {
-                    logdbg << "JobManager: run: waiting to obsolete finish";
-                    //QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-                    msleep(10);
-                }
-
-                if (!stop_requested_)
-                    active_db_job_->emitObsolete();
-
-                active_db_job_ = nullptr;
-                changed = true;
-            }
-            else if (active_db_job_->done())
-            {
-                logdbg << "JobManager: run: flushing db done job";
-
-                if (!stop_requested_)
-                    active_db_job_->emitDone();
-
-
-                active_db_job_ = nullptr;
-                changed = true;
-                really_update_widget = true;
-            }
-        }
-
-        while (!active_db_job_ && !queued_db_jobs_.empty())
+        if (processDBJobs(really_update_widget))
         {
-            // start a new one if needed
-            std::shared_ptr<Job> current;
-            queued_db_jobs_.try_pop(current);
-
-            assert (current);
-            assert (!current->done());
-
-            if (current->obsolete())
-            {
-                if (!stop_requested_)
-                    current->emitObsolete();
-
-                continue;
-            }
-
-            logdbg << "JobManager: run: starting dbjob " << current->name();
-            active_db_job_ = current;
-
-            QThreadPool::globalInstance()->start(active_db_job_.get());
             changed = true;
 
-            break;
+            if (!stop_requested_ && !numDBJobs())
+                emit databaseIdle();
         }
 
-        if (!stop_requested_ && changed && !active_db_job_ && queued_db_jobs_.empty())
-            emit databaseIdle();
-
         if (!stop_requested_ && changed)
             updateWidget(really_update_widget);
-
-        //QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-        msleep(1);
     }
 
     assert (jobs_.empty());
     assert (non_blocking_jobs_.empty());
-    assert (!active_db_job_);
+    assert (active_db_jobs_.empty());
     assert (queued_db_jobs_.empty());
 
     stopped_=true;
@@ -277,8 +304,12 @@ void JobManager::shutdown ()
 
     stop_requested_ = true;
 
-    if (active_db_job_)
-        active_db_job_->setObsolete();
+    {
+        QMutexLocker locker (&active_db_jobs_mutex_);
+
+        for (auto& job_it : active_db_jobs_)
+            job_it->setObsolete();
+    }
 
     for (auto job_it = queued_db_jobs_.unsafe_begin(); job_it != queued_db_jobs_.unsafe_end(); ++job_it)
         (*job_it)->setObsolete ();
@@ -291,22 +322,12 @@ void JobManager::shutdown ()
 
     loginf  << "JobManager: shutdown: waiting on jobs to quit";
 
-    while (!queued_db_jobs_.empty() || active_db_job_ || !jobs_.empty() || !non_blocking_jobs_.empty())
-    {
-        loginf  << "JobManager: shutdown: waiting on jobs to finish: empty queued " << !queued_db_jobs_.empty()
-                << " db " << (active_db_job_ != nullptr) << " jobs " << !jobs_.empty()
-                                                       << " non-locking " << !non_blocking_jobs_.empty();
+    notifyChange();
+    wait(); // run stops after all jobs are flushed
 
-        msleep(1000);
-    }
+    assert (stopped_);
 
-    while (!stopped_)
-    {
-        loginf  << "JobManager: shutdown: waiting on run stop";
-//        while (QCoreApplication::hasPendingEvents())
-//            QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-        msleep(1000);
-    }
+    pool_->stop();
 
     if (widget_)
     {
@@ -317,6 +338,111 @@ void JobManager::shutdown ()
     loginf  << "JobManager: shutdown: done";
 }
 
+bool JobManager::processDBJobs (bool& really_update_widget)
+{
+    QMutexLocker locker (&active_db_jobs_mutex_);
+
+    bool changed = false;
+
+    // flush finished ones, obsolete ones are flushed after finish
+    for (auto job_it = active_db_jobs_.begin(); job_it != active_db_jobs_.end();)
+    {
+        std::shared_ptr<Job> current = *job_it;
+
+        if (!current->done())
+        {
+            ++job_it;
+            continue;
+        }
+
+        job_it = active_db_jobs_.erase(job_it);
+        changed = true;
+
+        if (current->obsolete())
+        {
+            logdbg << "JobManager: processDBJobs: flushing db obsolete job";
+
+            if (!stop_requested_)
+                current->emitObsolete();
+        }
+        else
+        {
+            logdbg << "JobManager: processDBJobs: flushing db done job";
+
+            if (!stop_requested_)
+                current->emitDone();
+
+            really_update_widget = true;
+        }
+    }
+
+    unsigned int num_writing = std::count_if (active_db_jobs_.begin(), active_db_jobs_.end(),
+                                              [] (const std::shared_ptr<Job>& job) { return !job->readOnly(); });
+
+    // start queued ones in order, read-only ones concurrently, others exclusively. read-only ones never start
+    // while a writing one runs, so they see the changes of all earlier jobs
+    while (!queued_db_jobs_.empty())
+    {
+        std::shared_ptr<Job> current = *queued_db_jobs_.unsafe_begin();
+        assert (current);
+        assert (!current->done());
+
+        if (current->obsolete())
+        {
+            queued_db_jobs_.try_pop(current);
+
+            if (!stop_requested_)
+                current->emitObsolete();
+
+            changed = true;
+            continue;
+        }
+
+        if (current->readOnly())
+        {
+            if (num_writing)
+                break;
+
+            if (active_db_jobs_.size() >= max_db_read_jobs_)
+                break;
+        }
+        else
+        {
+            if (num_writing)
+                break;
+
+            if (active_db_jobs_.size() && !concurrent_db_read_write_)
+                break; // wait for exclusive access
+
+            ++num_writing;
+        }
+
+        queued_db_jobs_.try_pop(current);
+
+        logdbg << "JobManager: processDBJobs: starting dbjob " << current->name() << " active "
+               << active_db_jobs_.size();
+        active_db_jobs_.push_back(current);
+
+        startJob(current);
+        changed = true;
+    }
+
+    return changed;
+}
+
+void JobManager::startJob (std::shared_ptr<Job> job)
+{
+    pool_->start(new JobRunner(job), job->priority());
+}
+
+void JobManager::notifyChange ()
+{
+    QMutexLocker locker (&mutex_);
+
+    changed_ = true;
+    condition_.wakeOne();
+}
+
 JobManagerWidget *JobManager::widget()
 {
     if (!widget_)
@@ -336,12 +462,14 @@ unsigned int JobManager::numJobs ()
 
 unsigned int JobManager::numDBJobs ()
 {
-    return active_db_job_ ? queued_db_jobs_.unsafe_size()+1 : queued_db_jobs_.unsafe_size();
+    QMutexLocker locker (&active_db_jobs_mutex_);
+
+    return active_db_jobs_.size() + queued_db_jobs_.unsafe_size();
 }
 
 int JobManager::numThreads ()
 {
-    return QThreadPool::globalInstance()->activeThreadCount();
+    return pool_->activeThreadCount();
 }
 
 void JobManager::updateWidget (bool really)
@@ -26,15 +26,16 @@
 #include <memory>
 #include <QMutex>
 #include <QThread>
+#include <QWaitCondition>
 
 #include <tbb/concurrent_queue.h>
 
 #include "singleton.h"
 #include "configurable.h"
+#include "job.h"
 
-class WorkerThread;
+class WorkerPool;
 //class DBJob;
-class Job;
 class JobManagerWidget;
 
 /**
@@ -42,8 +43,17 @@ class JobManagerWidget;
  *
  * Allows addition of TransformationJobs, which are held in a list and assigned to any active TransformationWorkers.
  * A number of such TransformationWorkers are generated and managed.
- * Using a timer event, jobs are checked if earlier jobs are done and flushed in the order of addition. Jobs may be
- * done, but can be blocked by unfinished jobs which were added earlier.
+ * The thread sleeps until a job is added, finished or cancelled, then jobs are checked if earlier jobs are done and
+ * flushed in the order of addition. Jobs may be done, but can be blocked by unfinished jobs which were added earlier.
+ *
+ * Jobs are run in an own WorkerPool, in the lane of the given priority. The number of threads and the maximum number
+ * of threads per lane are configurable, 0 for defaults (all threads for interactive jobs, one for export jobs, about
+ * half of the others for post-processing jobs and the rest for load jobs, so that the default background lanes leave
+ * one thread for interactive jobs if more than three threads are available).
+ *
+ * DB jobs are started in order of addition. Read-only DB jobs run concurrently, up to a configurable maximum,
+ * while other DB jobs are run exclusively. If the database allows concurrent reading and writing, a writing DB job
+ * may also start while earlier read-only ones are running.
  *
  */
 class JobManager: public QThread, public Singleton, public Configurable
@@ -56,11 +66,14 @@ signals:
 public:
     virtual ~JobManager();
 
-    void addJob (std::shared_ptr<Job> job);
-    void addNonBlockingJob (std::shared_ptr<Job> job);
-    void addDBJob (std::shared_ptr<Job> job);
+    void addJob (std::shared_ptr<Job> job, JobPriority priority=JobPriority::INTERACTIVE);
+    void addNonBlockingJob (std::shared_ptr<Job> job, JobPriority priority=JobPriority::INTERACTIVE);
+    void addDBJob (std::shared_ptr<Job> job, JobPriority priority=JobPriority::INTERACTIVE);
     void cancelJob (std::shared_ptr<Job> job);
 
+    /// @brief Sets if writing DB jobs may run concurrently with read-only ones
+    void concurrentDBReadWrite (bool value);
+
     bool noJobs ();
     unsigned int numJobs ();
     unsigned int numDBJobs ();
@@ -84,18 +97,50 @@ protected:
     tbb::concurrent_queue <std::shared_ptr<Job>> jobs_;
     tbb::concurrent_queue <std::shared_ptr<Job>> non_blocking_jobs_;
 
-    std::shared_ptr<Job> active_db_job_;
+    /// Running DB jobs, either one writing or several read-only ones
+    std::list<std::shared_ptr<Job>> active_db_jobs_;
+    /// Guards active_db_jobs_
+    QMutex active_db_jobs_mutex_;
     tbb::concurrent_queue <std::shared_ptr<Job>> queued_db_jobs_;
 
     JobManagerWidget *widget_;
 
+    unsigned int num_threads_ {0};
+    unsigned int max_interactive_threads_ {0};
+    unsigned int max_load_threads_ {0};
+    unsigned int max_postprocessing_threads_ {0};
+    unsigned int max_export_threads_ {0};
+    /// Maximum number of concurrently running read-only DB jobs
+    unsigned int max_db_read_jobs_ {0};
+    /// Flag if a writing DB job may run concurrently with read-only ones
+    volatile bool concurrent_db_read_write_ {false};
+
+    std::unique_ptr<WorkerPool> pool_;
+
     boost::posix_time::ptime last_update_time_;
 
+    /// Guards changed_
+    QMutex mutex_;
+    /// Signalled on changed_
+    QWaitCondition condition_;
+    /// Flag indicating if jobs were added, finished or cancelled since last check
+    bool changed_ {false};
+
     /// @brief Constructor
     JobManager();
 
     void updateWidget (bool really=false);
+
+    /// @brief Starts job in worker pool lane of its priority, notifies when finished
+    void startJob (std::shared_ptr<Job> job);
+    /// @brief Wakes thread to check jobs
+    void notifyChange ();
+    /// @brief Flushes finished DB jobs and starts queued ones if possible, returns if anything changed
+    bool processDBJobs (bool& really_update_widget);
+
 private:
+    friend class JobRunner;
+
     void run ();
 
 };
@@ -1,5 +1,7 @@
 #include "jsonmappingjob.h"
 #include "jsonobjectparser.h"
+#include "jsonobjectsplitter.h"
+#include "jsonextractionplan.h"
 #include "buffer.h"
 #include "dbobject.h"
 
@@ -10,6 +12,21 @@ JSONMappingJob::JSONMappingJob(std::vector<nlohmann::json>&& json_objects,
 
 }
 
+JSONMappingJob::JSONMappingJob(std::shared_ptr<JSONObjectBlock> objects, JSONTape&& tape,
+                               const std::map <std::string, JSONObjectParser>& mappings, size_t key_count)
+    : Job ("JSONMappingJob"), use_tape_(true), objects_(objects), tape_(std::move(tape)), parsers_(mappings),
+      key_count_(key_count)
+{
+    assert (objects_);
+}
+
+JSONMappingJob::JSONMappingJob(std::shared_ptr<JSONObjectBlock> objects,
+                               const std::map <std::string, JSONObjectParser>& mappings, size_t key_count)
+    : Job ("JSONMappingJob"), extract_(true), objects_(objects), parsers_(mappings), key_count_(key_count)
+{
+    assert (objects_);
+}
+
 JSONMappingJob::~JSONMappingJob()
 {
 
@@ -24,25 +41,81 @@ void JSONMappingJob::run ()
     for (auto& parser_it : parsers_)
         buffers_[parser_it.second.dbObject().name()] = parser_it.second.getNewBuffer();
 
+    // columns bound once for all objects
+    std::map<std::string, std::vector<ColumnHandle>> columns;
+
+    for (auto& parser_it : parsers_)
+        columns[parser_it.first] = parser_it.second.bindColumns(*buffers_.at(parser_it.second.dbObject().name()));
+
     bool parsed;
     bool parsed_any = false;
 
     logdbg << "JSONMappingJob: run: mapping json";
-    for (auto& j_it : json_objects_)
+    if (extract_)
     {
-        parsed = false;
-        parsed_any = false;
+        JSONExtractionPlan plan (parsers_, buffers_);
+
+        for (size_t cnt=0; cnt < objects_->size(); ++cnt)
+        {
+            try
+            {
+                parsed_any = plan.extract(objects_->objectBegin(cnt), objects_->objectEnd(cnt));
+            }
+            catch (JSONTape::Error& e)
+            {
+                logwrn << "JSONMappingJob: run: parse error " << e.what() << " in '" << objects_->object(cnt) << "'";
+                ++num_parse_errors_;
+                continue;
+            }
+            ++num_parsed_;
+
+            if (parsed_any)
+                ++num_mapped_;
+            else
+                ++num_not_mapped_;
+        }
 
-        for (auto& map_it : parsers_)
+        objects_ = nullptr; // text not needed anymore
+    }
+    else if (use_tape_)
+    {
+        for (size_t cnt=0; cnt < tape_.numDocuments(); ++cnt)
+        {
+            parsed = false;
+            parsed_any = false;
+
+            for (auto& map_it : parsers_)
+            {
+                parsed = map_it.second.parseJSON(JSONTapeValue {tape_, tape_.root(cnt)},
+                                                 buffers_.at(map_it.second.dbObject().name()),
+                                                 columns.at(map_it.first));
+                parsed_any |= parsed;
+            }
+            if (parsed_any)
+                ++num_mapped_;
+            else
+                ++num_not_mapped_;
+        }
+    }
+    else
+    {
+        for (auto& j_it : json_objects_)
         {
-            logdbg << "JSONMappingJob: run: mapping json: obj " << map_it.second.dbObject().name();
-            parsed = map_it.second.parseJSON(j_it, buffers_.at(map_it.second.dbObject().name()));
-            parsed_any |= parsed;
+            parsed = false;
+            parsed_any = false;
+
+            for (auto& map_it : parsers_)
+            {
+                logdbg << "JSONMappingJob: run: mapping json: obj " << map_it.second.dbObject().name();
+                parsed = map_it.second.parseJSON(j_it, buffers_.at(map_it.second.dbObject().name()),
+                                                 columns.at(map_it.first));
+                parsed_any |= parsed;
+            }
+            if (parsed_any)
+                ++num_mapped_;
+            else
+                ++num_not_mapped_;
         }
-        if (parsed_any)
-            ++num_mapped_;
-        else
-            ++num_not_mapped_;
     }
 
     logdbg << "JSONMappingJob: run: creating buffers";
@@ -84,3 +157,13 @@ size_t JSONMappingJob::numCreated() const
 {
     return num_created_;
 }
+
+size_t JSONMappingJob::numParsed() const
+{
+    return num_parsed_;
+}
+
+size_t JSONMappingJob::numParseErrors() const
+{
+    return num_parse_errors_;
+}
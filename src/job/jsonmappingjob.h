@@ -3,11 +3,13 @@
 
 #include "job.h"
 #include "json.hpp"
+#include "jsontape.h"
 
 #include <vector>
 #include <memory>
 
 class JSONObjectParser;
+class JSONObjectBlock;
 class Buffer;
 
 class JSONMappingJob : public Job
@@ -15,6 +17,12 @@ class JSONMappingJob : public Job
 public:
     JSONMappingJob(std::vector<nlohmann::json>&& json_objects, const std::map <std::string, JSONObjectParser>& mappings,
                    size_t key_count);
+    /// @brief Constructor for objects parsed into tape, which references the text of the objects block
+    JSONMappingJob(std::shared_ptr<JSONObjectBlock> objects, JSONTape&& tape,
+                   const std::map <std::string, JSONObjectParser>& mappings, size_t key_count);
+    /// @brief Constructor for objects text, from which mapped values are extracted without parsing into a DOM
+    JSONMappingJob(std::shared_ptr<JSONObjectBlock> objects, const std::map <std::string, JSONObjectParser>& mappings,
+                   size_t key_count);
     // json obj moved, mappings referenced
     virtual ~JSONMappingJob();
 
@@ -25,6 +33,9 @@ public:
     size_t numMapped() const;
     size_t numNotMapped() const;
     size_t numCreated() const;
+    /// @brief Returns number of objects parsed by extraction, 0 if already parsed
+    size_t numParsed() const;
+    size_t numParseErrors() const;
 
     std::map<std::string, std::shared_ptr<Buffer>>&& buffers () { return std::move(buffers_); }
 
@@ -32,8 +43,15 @@ private:
     size_t num_mapped_ {0}; // number of parsed where a parse was successful
     size_t num_not_mapped_ {0}; // number of parsed where no parse was successful
     size_t num_created_ {0}; // number of created objects from parsing
+    size_t num_parsed_ {0}; // number of objects extracted without syntax error
+    size_t num_parse_errors_ {0};
 
     std::vector<nlohmann::json> json_objects_;
+
+    bool use_tape_ {false};
+    bool extract_ {false};
+    std::shared_ptr<JSONObjectBlock> objects_;
+    JSONTape tape_;
     const std::map <std::string, JSONObjectParser>& parsers_;
     size_t key_count_;
 
@@ -1,10 +1,11 @@
 #include "jsonparsejob.h"
+#include "jsonobjectsplitter.h"
 #include "logger.h"
 
 using namespace nlohmann;
 
-JSONParseJob::JSONParseJob(std::vector<std::string>&& objects)
-    : Job ("JSONParseJob"), objects_(objects)
+JSONParseJob::JSONParseJob(std::shared_ptr<JSONObjectBlock> objects, bool use_tape)
+    : Job ("JSONParseJob"), objects_(objects), use_tape_(use_tape)
 {
 
 }
@@ -16,22 +17,53 @@ JSONParseJob::~JSONParseJob()
 
 void JSONParseJob::run ()
 {
-    loginf << "JSONParseJob: run: start with " << objects_.size() << " objects";
+    assert (objects_);
+
+    loginf << "JSONParseJob: run: start with " << objects_->size() << " objects tape " << use_tape_;
 
     started_ = true;
-    for (auto& str_it : objects_)
+
+    if (use_tape_)
     {
-        try
+        tape_.reserve(objects_->textSize()/8); // rough estimate of number of values
+
+        for (size_t cnt=0; cnt < objects_->size(); ++cnt)
         {
-            json_objects_.push_back(json::parse(str_it));
+            try
+            {
+                tape_.parse(objects_->objectBegin(cnt), objects_->objectEnd(cnt));
+            }
+            catch (JSONTape::Error& e)
+            {
+                logwrn << "JSONParseJob: run: parse error " << e.what() << " in '" << objects_->object(cnt) << "'";
+                ++parse_errors_;
+                continue;
+            }
+            ++objects_parsed_;
         }
-        catch (nlohmann::detail::parse_error e)
+
+        // text kept, referenced by tape
+    }
+    else
+    {
+        json_objects_.reserve(objects_->size());
+
+        for (size_t cnt=0; cnt < objects_->size(); ++cnt)
         {
-            logwrn << "JSONParseJob: run: parse error " << e.what() << " in '" << str_it << "'";
-            ++parse_errors_;
-            continue;
+            try
+            {
+                json_objects_.push_back(json::parse(objects_->objectBegin(cnt), objects_->objectEnd(cnt)));
+            }
+            catch (nlohmann::detail::parse_error e)
+            {
+                logwrn << "JSONParseJob: run: parse error " << e.what() << " in '" << objects_->object(cnt) << "'";
+                ++parse_errors_;
+                continue;
+            }
+            ++objects_parsed_;
         }
-        ++objects_parsed_;
+
+        objects_ = nullptr; // text not needed anymore
     }
 
     loginf << "JSONParseJob: run: done with " << objects_parsed_ << " objects, errors " << parse_errors_;
@@ -53,4 +85,19 @@ std::vector<nlohmann::json>& JSONParseJob::jsonObjects()
     return json_objects_;
 }
 
+bool JSONParseJob::useTape() const
+{
+    return use_tape_;
+}
+
+JSONTape& JSONParseJob::tape()
+{
+    return tape_;
+}
+
+std::shared_ptr<JSONObjectBlock> JSONParseJob::objects()
+{
+    return std::move(objects_);
+}
+
 
@@ -1,26 +1,41 @@
 #ifndef JSONPARSEJOB_H
 #define JSONPARSEJOB_H
 
+#include <memory>
+
 #include "job.h"
 #include "json.hpp"
+#include "jsontape.h"
+
+class JSONObjectBlock;
 
 class JSONParseJob : public Job
 {
 public:
-    JSONParseJob(std::vector<std::string>&& objects); // is moved from objects
+    /// @brief Constructor, parses into a JSONTape instead of nlohmann::json objects if use_tape is set
+    JSONParseJob(std::shared_ptr<JSONObjectBlock> objects, bool use_tape=false);
     virtual ~JSONParseJob();
 
     virtual void run ();
 
     std::vector<nlohmann::json>& jsonObjects(); // for move operation
 
+    bool useTape() const;
+    /// @brief Returns tape with one document per parsed object, for move operation
+    JSONTape& tape();
+    /// @brief Returns objects text referenced by tape, nullptr if not using tape
+    std::shared_ptr<JSONObjectBlock> objects();
+
     size_t objectsParsed() const;
     size_t parseErrors() const;
 
 private:
-    std::vector<std::string> objects_;
+    std::shared_ptr<JSONObjectBlock> objects_;
     std::vector<nlohmann::json> json_objects_;
 
+    bool use_tape_ {false};
+    JSONTape tape_;
+
     size_t objects_parsed_ {0};
     size_t parse_errors_ {0};
 };
@@ -5,10 +5,11 @@
 #include <archive.h>
 #include <archive_entry.h>
 
-#include <regex>
-
 using namespace Utils;
 
+/// Number of bytes read from plain files at once
+const size_t JSON_READ_BLOCK_SIZE=1 << 20;
+
 ReadJSONFilePartJob::ReadJSONFilePartJob(const std::string& file_name, bool archive, unsigned int num_objects)
     : Job("ReadJSONFilePartJob"), file_name_(file_name), archive_(archive), num_objects_(num_objects)
 {
@@ -29,7 +30,7 @@ void ReadJSONFilePartJob::run ()
 
     assert (!done_);
     assert (!file_read_done_);
-    assert (!objects_.size());
+    assert (!objects_);
     assert (!bytes_read_tmp_);
 
     if (!init_performed_)
@@ -41,8 +42,6 @@ void ReadJSONFilePartJob::run ()
     //while (!file_read_done_ && objects_.size() < num_objects_)
     readFilePart();
 
-    //cleanCommas ();
-
     done_=true;
 
     logdbg << "ReadJSONFilePartJob: run: done";
@@ -78,8 +77,10 @@ void ReadJSONFilePartJob::performInit ()
     {
         file_stream_.open(file_name_, std::ios::ate);
         bytes_to_read_ = file_stream_.tellg();
-        loginf << "ReadJSONFilePartJob: performInit: non-archive size " << bytes_to_read_;
-        file_stream_.seekg(0);
+        loginf << "ReadJSONFilePartJob: performInit: non-archive size " << bytes_to_read_ << " start offset "
+               << start_offset_;
+        file_stream_.seekg(start_offset_);
+        bytes_read_ = start_offset_;
     }
 
     init_performed_ = true;
@@ -97,7 +98,6 @@ void ReadJSONFilePartJob::readFilePart ()
         size_t size;
 
         int r;
-        bool closed_bracked = false;
 
         while (1)
         {
@@ -156,42 +156,15 @@ void ReadJSONFilePartJob::readFilePart ()
                                                  +std::string(archive_error_string(a)));
                 }
 
-                std::string str (reinterpret_cast<char const*>(buff), size);
-
-                for (char c : str)
-                {
-                    closed_bracked = false;
-
-                    if (c == '{')
-                        ++open_count_;
-                    else if (c == '}')
-                    {
-                        --open_count_;
-                        closed_bracked = true;
-                    }
-
-                    if (open_count_ || closed_bracked) // only add if enclosed by brackets
-                        tmp_stream_ << c;
+                splitter_.add(reinterpret_cast<char const*>(buff), size);
 
-                    ++bytes_read_;
-                    ++bytes_read_tmp_;
+                bytes_read_ += size;
+                bytes_read_tmp_ += size;
 
-                    if (c == '\n') // next lines after objects
-                        continue;
-
-                    if (closed_bracked && open_count_ == 0)
-                    {
-                        objects_.push_back(tmp_stream_.str());
-                        tmp_stream_.str("");
-                    }
-
-                }
-
-                if (objects_.size() > num_objects_ || (objects_.size() && bytes_read_tmp_ > 1e7))
+                if (splitter_.numObjects() > num_objects_ || (splitter_.numObjects() && bytes_read_tmp_ > 1e7))
                     // parsed buffer, reached obj limit
                 {
-                    //|| (objects_.size() && bytes_read_tmp_ > 1e7)
-                    //loginf << "UGA returning " << bytes_read_tmp_;
+                    objects_ = splitter_.takeBlock();
                     entry_done_ = false;
                     return;
                 }
@@ -202,68 +175,57 @@ void ReadJSONFilePartJob::readFilePart ()
             }
             if (entry_done_) // will read next entry
             {
-                assert (open_count_ == 0); // nothing left open
-                assert (tmp_stream_.str().size() == 0 || tmp_stream_.str() == "\n");
+                assert (!splitter_.inObject()); // nothing left open
+                objects_ = splitter_.takeBlock();
                 return;
             }
         }
 
         loginf << "ReadJSONFilePartJob: readFilePart: archive done";
 
-        assert (open_count_ == 0); // nothing left open
-        assert (tmp_stream_.str().size() == 0 || tmp_stream_.str() == "\n");
+        assert (!splitter_.inObject()); // nothing left open
+        objects_ = splitter_.takeBlock();
 
         file_read_done_ = true;
     }
     else
     {
-        char c;
-        bool closed_bracked = false;
-
-        while (file_stream_.get(c) && objects_.size() < num_objects_) // loop getting single characters
+        while (splitter_.numObjects() < num_objects_)
         {
-            closed_bracked = false;
-
-            if (c == '{')
-                ++open_count_;
-            else if (c == '}')
-            {
-                --open_count_;
-                closed_bracked = true;
-            }
-
-            if (open_count_ || closed_bracked) // only add if enclosed by brackets
-                tmp_stream_ << c;
-
-            ++bytes_read_;
-
-            if (c == '\n') // next lines after objects
-                continue;
+            size_t read_size = splitter_.read(file_stream_, JSON_READ_BLOCK_SIZE);
+            bytes_read_ += read_size;
 
-            if (closed_bracked && open_count_ == 0)
+            if (!read_size)
             {
-                //loginf << "ReadJSONFilePartJob: readFilePart: obj '" << tmp_stream_.str() << "'";
-                objects_.push_back(tmp_stream_.str());
-                tmp_stream_.str("");
+                file_read_done_ = true;
+                break;
             }
         }
 
-        if (objects_.size() != num_objects_)
-            file_read_done_ = true;
+        if (file_read_done_ && splitter_.inObject())
+            logwrn << "ReadJSONFilePartJob: readFilePart: incomplete object at end of file ignored";
 
-        loginf << "ReadJSONFilePartJob: readFilePart: parsed " << objects_.size() << " done " << file_read_done_;
+        objects_ = splitter_.takeBlock();
 
-        assert (open_count_ == 0); // nothing left open
-        assert (tmp_stream_.str().size() == 0 || tmp_stream_.str() == "\n");
+        loginf << "ReadJSONFilePartJob: readFilePart: parsed " << objects_->size() << " done " << file_read_done_;
     }
 
     loginf << "ReadJSONFilePartJob: readFilePart: done";
 }
 
+void ReadJSONFilePartJob::continueAt (size_t offset, JSONObjectSplitter&& splitter)
+{
+    assert (!archive_);
+    assert (!started_);
+
+    start_offset_ = offset;
+    splitter_ = std::move(splitter);
+}
+
 void ReadJSONFilePartJob::resetDone ()
 {
     assert (!file_read_done_);
-    assert (!objects_.size());
+    assert (!objects_);
     done_ = false; // yet another part
     bytes_read_tmp_ = 0;
 }
@@ -273,7 +235,7 @@ bool ReadJSONFilePartJob::fileReadDone() const
     return file_read_done_;
 }
 
-std::vector<std::string>&& ReadJSONFilePartJob::objects()
+std::shared_ptr<JSONObjectBlock> ReadJSONFilePartJob::objects()
 {
     return std::move(objects_);
 }
@@ -339,24 +301,3 @@ float ReadJSONFilePartJob::getStatusPercent ()
     else
         return 100.0*static_cast<double>(bytes_read_)/static_cast<double>(bytes_to_read_);
 }
-
-void ReadJSONFilePartJob::cleanCommas ()
-{
-    loginf << "ReadJSONFilePartJob: cleanCommas: " << objects_.size() << " objects";
-
-    std::regex commas_between_brackets("\\[(,|\n)+\\]");
-    std::regex multiple_commas(",\\n*,+");
-    std::regex stupid_commas_at_bracket_begin("\\[\\n*,+");
-    std::regex stupid_commas_at_bracket_end(",+\\n*\\]");
-
-    for (auto& str_it : objects_)
-    {
-        str_it = std::regex_replace(str_it, commas_between_brackets, {"[]"});
-        str_it = std::regex_replace(str_it, multiple_commas, {","});
-        str_it = std::regex_replace(str_it, stupid_commas_at_bracket_begin, {"["});
-        str_it = std::regex_replace(str_it, stupid_commas_at_bracket_end, {"]"});
-
-        // \[(,|\n)+\]   commas between brackets
-        // /,(?!["{}[\]])/g  multiple commas
-    }
-}
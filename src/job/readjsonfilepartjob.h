@@ -3,11 +3,12 @@
 
 #include "job.h"
 
-#include <vector>
+#include <memory>
 #include <string>
-#include <sstream>
 #include <fstream>
 
+#include "jsonobjectsplitter.h"
+
 class ReadJSONFilePartJob : public Job
 {
 public:
@@ -16,11 +17,13 @@ public:
 
     virtual void run ();
 
+    /// @brief Continues reading of non-archive file at offset with the state of splitter, before first run
+    void continueAt (size_t offset, JSONObjectSplitter&& splitter);
     void resetDone ();
 
     bool fileReadDone() const;
 
-    std::vector<std::string>&& objects(); // for moving out
+    std::shared_ptr<JSONObjectBlock> objects(); // for moving out
 
     size_t bytesRead() const;
     size_t bytesToRead() const;
@@ -34,11 +37,11 @@ protected:
 
     bool file_read_done_ {false};
     bool init_performed_ {false};
+    /// Offset at which reading of non-archive file starts
+    size_t start_offset_ {0};
 
     std::ifstream file_stream_;
-    std::stringstream tmp_stream_;
-
-    unsigned int open_count_ {0};
+    JSONObjectSplitter splitter_;
 
     struct archive *a;
     struct archive_entry *entry;
@@ -48,15 +51,13 @@ protected:
     size_t bytes_to_read_ {0};
     size_t bytes_read_ {0};
     size_t bytes_read_tmp_ {0};
-    std::vector<std::string> objects_;
+    std::shared_ptr<JSONObjectBlock> objects_;
 
     void performInit ();
     void readFilePart ();
 
     void openArchive (bool raw);
     void closeArchive ();
-
-    void cleanCommas ();
 };
 
 #endif // READJSONFILEPARTJOB_H
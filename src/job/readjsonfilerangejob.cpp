@@ -0,0 +1,182 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "readjsonfilerangejob.h"
+#include "logger.h"
+
+namespace
+{
+const size_t JSON_RANGE_READ_BLOCK_SIZE=1 << 20;
+const size_t JSON_RANGE_SEARCH_BLOCK_SIZE=1 << 16;
+}
+
+ReadJSONFileRangeJob::ReadJSONFileRangeJob (const std::string& file_name, size_t from_offset, size_t to_offset,
+                                            unsigned int num_objects)
+    : Job("ReadJSONFileRangeJob"), file_name_(file_name), from_offset_(from_offset), to_offset_(to_offset),
+      num_objects_(num_objects)
+{
+    assert (from_offset_ <= to_offset_);
+    assert (num_objects_);
+}
+
+ReadJSONFileRangeJob::~ReadJSONFileRangeJob()
+{
+}
+
+void ReadJSONFileRangeJob::run ()
+{
+    logdbg << "ReadJSONFileRangeJob: run: range " << from_offset_ << " to " << to_offset_;
+
+    started_ = true;
+
+    assert (!done_);
+    assert (blocks_.empty());
+
+    std::ifstream file_stream (file_name_, std::ios::binary);
+
+    if (!file_stream)
+        throw std::runtime_error("ReadJSONFileRangeJob: run: unable to open file '"+file_name_+"'");
+
+    file_stream.seekg(from_offset_);
+
+    size_t range_size = to_offset_-from_offset_;
+
+    while (bytes_read_ < range_size && !obsolete_)
+    {
+        size_t read_size = splitter_.read(file_stream,
+                                          std::min(JSON_RANGE_READ_BLOCK_SIZE, range_size-bytes_read_));
+
+        if (!read_size)
+        {
+            logwrn << "ReadJSONFileRangeJob: run: end of file at " << from_offset_+bytes_read_
+                   << " before end of range " << to_offset_;
+            break;
+        }
+
+        bytes_read_ += read_size;
+
+        if (splitter_.numObjects() >= num_objects_)
+            blocks_.push_back(splitter_.takeBlock());
+    }
+
+    if (obsolete_)
+    {
+        logdbg << "ReadJSONFileRangeJob: run: obsolete";
+        blocks_.clear();
+        return;
+    }
+
+    if (splitter_.numObjects())
+        blocks_.push_back(splitter_.takeBlock());
+
+    ends_at_top_level_ = splitter_.atTopLevel();
+
+    logdbg << "ReadJSONFileRangeJob: run: range " << from_offset_ << " to " << to_offset_ << " blocks "
+           << blocks_.size() << " ends at top level " << ends_at_top_level_;
+
+    done_ = true;
+}
+
+std::vector<std::shared_ptr<JSONObjectBlock>>& ReadJSONFileRangeJob::blocks ()
+{
+    return blocks_;
+}
+
+std::vector<size_t> ReadJSONFileRangeJob::rangeOffsets (const std::string& file_name, size_t range_size)
+{
+    assert (range_size);
+
+    std::ifstream file_stream (file_name, std::ios::binary | std::ios::ate);
+
+    if (!file_stream)
+        throw std::runtime_error("ReadJSONFileRangeJob: rangeOffsets: unable to open file '"+file_name+"'");
+
+    size_t file_size = file_stream.tellg();
+
+    std::vector<size_t> offsets {0};
+    std::vector<char> buffer (JSON_RANGE_SEARCH_BLOCK_SIZE);
+
+    size_t search_offset = range_size;
+
+    while (search_offset < file_size)
+    {
+        // search for newline followed by opening brace, starting with the character before the nominal offset
+        size_t block_offset = search_offset-1;
+        size_t object_offset = file_size;
+
+        file_stream.clear();
+        file_stream.seekg(block_offset);
+
+        while (object_offset == file_size && block_offset < file_size)
+        {
+            file_stream.read(buffer.data(), buffer.size());
+            size_t read_size = file_stream.gcount();
+
+            if (!read_size)
+                break;
+
+            const char* begin = buffer.data();
+            const char* end = begin+read_size;
+
+            for (const char* pos = begin; pos+1 < end; ++pos)
+            {
+                pos = static_cast<const char*> (std::memchr(pos, '\n', end-pos-1));
+
+                if (!pos)
+                    break;
+
+                if (pos[1] == '{')
+                {
+                    object_offset = block_offset+(pos+1-begin);
+                    break;
+                }
+            }
+
+            if (object_offset == file_size)
+            {
+                // re-read last character, could be newline
+                block_offset += read_size-1;
+
+                if (read_size == 1)
+                    break;
+
+                file_stream.clear();
+                file_stream.seekg(block_offset);
+            }
+        }
+
+        if (object_offset == file_size)
+            break;
+
+        assert (object_offset > offsets.back());
+        offsets.push_back(object_offset);
+
+        search_offset = object_offset+range_size;
+    }
+
+    offsets.push_back(file_size);
+
+    logdbg << "ReadJSONFileRangeJob: rangeOffsets: file size " << file_size << " ranges " << offsets.size()-1;
+
+    return offsets;
+}
@@ -0,0 +1,82 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef READJSONFILERANGEJOB_H
+#define READJSONFILERANGEJOB_H
+
+#include "job.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "jsonobjectsplitter.h"
+
+/**
+ * @brief Reads a byte range of a non-archive JSON file and splits it into blocks of objects
+ *
+ * Used to split a large file with several jobs concurrently. Ranges start at a line starting with an opening
+ * brace (see rangeOffsets), which is assumed to be the start of a top-level object. Since this can not be known
+ * without scanning the text before, each job checks the assumption of its successor: only if the text of the
+ * range ends outside of objects and strings (endsAtTopLevel), the next range was split as a sequential read would
+ * have done. Otherwise the blocks of the following ranges must be discarded, and the file is read sequentially
+ * after the range, continuing with the incomplete object of the splitter.
+ */
+class ReadJSONFileRangeJob : public Job
+{
+public:
+    /// @brief Constructor, range is given as [from_offset, to_offset), blocks hold about num_objects objects
+    ReadJSONFileRangeJob (const std::string& file_name, size_t from_offset, size_t to_offset,
+                          unsigned int num_objects);
+    virtual ~ReadJSONFileRangeJob();
+
+    virtual void run ();
+
+    /// @brief Returns blocks of objects in file order, for moving out
+    std::vector<std::shared_ptr<JSONObjectBlock>>& blocks ();
+
+    /// @brief Returns flag indicating if the range ended outside of objects and strings, only valid when done
+    bool endsAtTopLevel () const { return ends_at_top_level_; }
+    /// @brief Returns splitter with the incomplete object at the end of the range, for continuing the read
+    JSONObjectSplitter& splitter () { return splitter_; }
+
+    size_t fromOffset () const { return from_offset_; }
+    size_t toOffset () const { return to_offset_; }
+    size_t bytesRead() const { return bytes_read_; }
+
+    /**
+     * @brief Returns start offsets of ranges of about range_size bytes, followed by the file size
+     *
+     * Each range except the first starts at an opening brace at the beginning of a line. If no such line is found
+     * after a nominal offset, the rest of the file is one range.
+     */
+    static std::vector<size_t> rangeOffsets (const std::string& file_name, size_t range_size);
+
+protected:
+    std::string file_name_;
+    size_t from_offset_ {0};
+    size_t to_offset_ {0};
+    unsigned int num_objects_ {0};
+
+    JSONObjectSplitter splitter_;
+    std::vector<std::shared_ptr<JSONObjectBlock>> blocks_;
+
+    size_t bytes_read_ {0};
+    bool ends_at_top_level_ {false};
+};
+
+#endif // READJSONFILERANGEJOB_H
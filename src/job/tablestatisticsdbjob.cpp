@@ -0,0 +1,137 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "boost/date_time/posix_time/posix_time.hpp"
+
+#include "tablestatisticsdbjob.h"
+#include "dbinterface.h"
+#include "dbconnection.h"
+#include "dbtable.h"
+#include "dbtablecolumn.h"
+#include "buffer.h"
+#include "propertylist.h"
+#include "logger.h"
+
+TableStatisticsDBJob::TableStatisticsDBJob (DBInterface& db_interface, const DBTable& table)
+: Job("TableStatisticsDBJob"), db_interface_(db_interface), table_(table)
+{
+    assert (table_.existsInDB());
+}
+
+TableStatisticsDBJob::~TableStatisticsDBJob()
+{
+}
+
+void TableStatisticsDBJob::addDistinctColumn (const std::string& column_name)
+{
+    assert (!started_);
+    assert (table_.hasColumn(column_name));
+
+    if (table_.column(column_name).propertyType() != PropertyDataType::INT)
+    {
+        logwrn << "TableStatisticsDBJob: addDistinctColumn: table " << table_.name() << " column " << column_name
+               << " is not an integer column, distinct values are not collected";
+        return;
+    }
+
+    distinct_values_[column_name]; // added empty
+}
+
+void TableStatisticsDBJob::run ()
+{
+    logdbg << "TableStatisticsDBJob: run: table " << table_.name();
+
+    started_ = true;
+
+    boost::posix_time::ptime start_time = boost::posix_time::microsec_clock::local_time();
+
+    PropertyList properties;
+
+    for (auto& col_it : table_.columns())
+    {
+        properties.addProperty(col_it.first, col_it.second->propertyType());
+        column_statistics_[col_it.first] = ColumnStatistics::create(col_it.second->propertyType());
+    }
+
+    unsigned int chunk_size = db_interface_.maxReadChunkSize(properties);
+
+    DBConnection* connection = db_interface_.prepareTableRead(table_, properties);
+    assert (connection);
+
+    std::shared_ptr<Buffer> buffer;
+    std::vector<std::pair<ColumnStatistics*, ColumnHandle>> columns;
+
+    try
+    {
+        while (!obsolete_)
+        {
+            buffer = db_interface_.readChunk(connection, chunk_size);
+            assert (buffer);
+
+            size_t size = buffer->size();
+            row_count_ += size;
+
+            if (size)
+            {
+                columns.clear();
+
+                for (auto& stat_it : column_statistics_)
+                {
+                    assert (buffer->properties().hasProperty(stat_it.first));
+                    columns.push_back({stat_it.second.get(),
+                                       buffer->column(buffer->properties().get(stat_it.first))});
+                }
+
+                for (auto& col_it : columns)
+                    col_it.first->update(col_it.second, 0, size);
+
+                for (auto& distinct_it : distinct_values_)
+                    ColumnStatistics::distinctValues(buffer->column(buffer->properties().get(distinct_it.first)),
+                                                     0, size, distinct_it.second);
+            }
+
+            if (buffer->lastOne())
+                break;
+        }
+    }
+    catch (std::exception& e)
+    {
+        logerr << "TableStatisticsDBJob: run: table " << table_.name() << " read failed: " << e.what();
+        failed_ = true;
+    }
+
+    db_interface_.finalizeTableRead(connection);
+
+    if (obsolete_)
+    {
+        logdbg << "TableStatisticsDBJob: run: table " << table_.name() << " obsolete";
+        failed_ = true;
+    }
+
+    if (failed_)
+    {
+        done_=true; // flushed by the job manager only when done
+        return;
+    }
+
+    boost::posix_time::time_duration diff = boost::posix_time::microsec_clock::local_time() - start_time;
+
+    loginf << "TableStatisticsDBJob: run: table " << table_.name() << " rows " << row_count_ << " columns "
+           << column_statistics_.size() << " done (" << diff.total_milliseconds()/1000.0 << " s)";
+
+    done_=true;
+}
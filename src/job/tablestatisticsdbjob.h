@@ -0,0 +1,75 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TABLESTATISTICSDBJOB_H_
+#define TABLESTATISTICSDBJOB_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "job.h"
+#include "columnstatistics.h"
+
+class DBInterface;
+class DBTable;
+
+/**
+ * @brief Post-processing job computing the statistics of one database table in a single scan
+ *
+ * Reads all columns of the table in chunks and computes the row count, the minimum, maximum and null count of every
+ * column and the distinct values of the added data source columns. Only reads using its own read connection, so
+ * jobs of different tables run in parallel.
+ */
+class TableStatisticsDBJob : public Job
+{
+public:
+    TableStatisticsDBJob (DBInterface& db_interface, const DBTable& table);
+    virtual ~TableStatisticsDBJob ();
+
+    /// @brief Adds integer column of which the distinct values are collected, e.g. the data source key
+    void addDistinctColumn (const std::string& column_name);
+
+    virtual void run ();
+    virtual bool readOnly () { return true; }
+
+    const DBTable& table () const { return table_; }
+
+    /// @brief Returns if reading the table failed or the job was obsolete, statistics are not valid then
+    bool failed () const { return failed_; }
+
+    /// @brief Returns number of rows, only valid when done
+    size_t rowCount () const { return row_count_; }
+    /// @brief Returns statistics per column name, only valid when done
+    const std::map<std::string, std::unique_ptr<ColumnStatistics>>& columnStatistics () const
+    { return column_statistics_; }
+    /// @brief Returns distinct non-null values per added distinct column, only valid when done
+    const std::map<std::string, std::set<int>>& distinctValues () const { return distinct_values_; }
+
+protected:
+    DBInterface& db_interface_;
+    const DBTable& table_;
+
+    /// Flag if statistics are incomplete, done is still set so the job is flushed
+    bool failed_ {false};
+    size_t row_count_ {0};
+    std::map<std::string, std::unique_ptr<ColumnStatistics>> column_statistics_;
+    std::map<std::string, std::set<int>> distinct_values_;
+};
+
+#endif /* TABLESTATISTICSDBJOB_H_ */
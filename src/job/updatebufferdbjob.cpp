@@ -18,6 +18,7 @@
 #include "boost/date_time/posix_time/posix_time.hpp"
 
 #include "buffer.h"
+#include "columnstatistics.h"
 #include "updatebufferdbjob.h"
 #include "dbinterface.h"
 #include "dbobject.h"
@@ -75,6 +76,17 @@ void UpdateBufferDBJob::run ()
         emit updateProgressSignal(100.0*index_to/buffer_->size());
     }
 
+    // statistics of the written rows are merged, so post-processing does not have to be repeated
+    try
+    {
+        db_interface_.mergeStatistics(dbobject_, ColumnStatistics::create(*buffer_), 0,
+                                      dbobject_.dataSourceKeys(*buffer_));
+    }
+    catch (std::exception& e) // data is written, only statistics are outdated
+    {
+        logerr << "UpdateBufferDBJob: run: merging statistics failed: " << e.what();
+    }
+
     loading_stop_time_ = boost::posix_time::microsec_clock::local_time();
 
     double load_time;
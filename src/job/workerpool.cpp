@@ -0,0 +1,231 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cassert>
+
+#include "workerpool.h"
+#include "logger.h"
+
+namespace
+{
+    /// Pool of the current worker thread, nullptr if not a worker thread
+    thread_local WorkerPool* current_pool = nullptr;
+    /// Index of the current worker thread in its pool
+    thread_local unsigned int current_worker = 0;
+}
+
+WorkerPool::WorkerPool (unsigned int num_threads, const std::array<unsigned int, NUM_JOB_PRIORITIES>& lane_limits)
+    : lane_limits_(lane_limits)
+{
+    assert (num_threads);
+
+    loginf << "WorkerPool: constructor: starting " << num_threads << " threads";
+
+    for (size_t lane=0; lane < NUM_JOB_PRIORITIES; ++lane)
+    {
+        running_counts_[lane] = 0;
+        queued_counts_[lane] = 0;
+
+        if (!lane_limits_[lane] || lane_limits_[lane] > num_threads)
+            lane_limits_[lane] = num_threads;
+    }
+
+    for (unsigned int cnt=0; cnt < num_threads; ++cnt)
+        workers_.push_back(std::unique_ptr<Worker> (new Worker()));
+
+    // start after all workers exist, as they steal from each other
+    for (unsigned int cnt=0; cnt < num_threads; ++cnt)
+        workers_.at(cnt)->thread_ = std::thread (&WorkerPool::work, this, cnt);
+}
+
+WorkerPool::~WorkerPool ()
+{
+    stop();
+}
+
+void WorkerPool::start (QRunnable* runnable, JobPriority priority)
+{
+    assert (runnable);
+
+    size_t lane = laneIndex(priority);
+    unsigned int worker_index;
+
+    if (current_pool == this) // keep work local
+        worker_index = current_worker;
+    else
+        worker_index = next_worker_++ % workers_.size();
+
+    Worker& worker = *workers_.at(worker_index);
+
+    ++queued_counts_[lane]; // before queueing, so count never falls below the number of queued ones
+
+    {
+        std::lock_guard<std::mutex> lock (worker.mutex_);
+        worker.lanes_.at(lane).push_back(runnable);
+    }
+
+    wake(false);
+}
+
+void WorkerPool::stop ()
+{
+    {
+        std::lock_guard<std::mutex> lock (wake_mutex_);
+
+        if (stop_requested_)
+            return;
+
+        stop_requested_ = true;
+    }
+
+    logdbg << "WorkerPool: stop: waiting on workers";
+
+    wake_condition_.notify_all();
+
+    for (auto& worker_it : workers_)
+    {
+        if (worker_it->thread_.joinable())
+            worker_it->thread_.join();
+    }
+
+    loginf << "WorkerPool: stop: done";
+}
+
+void WorkerPool::work (unsigned int worker_index)
+{
+    current_pool = this;
+    current_worker = worker_index;
+
+    while (1)
+    {
+        unsigned long generation;
+        {
+            std::lock_guard<std::mutex> lock (wake_mutex_);
+            generation = generation_;
+        }
+
+        size_t lane;
+        QRunnable* runnable = take (worker_index, lane);
+
+        if (runnable)
+        {
+            ++active_count_;
+
+            bool auto_delete = runnable->autoDelete();
+            runnable->run();
+
+            if (auto_delete)
+                delete runnable;
+
+            --active_count_;
+
+            // if lane was full, runnables held back by the limit may be taken now
+            if (running_counts_[lane]-- >= lane_limits_[lane] && queued_counts_[lane])
+                wake(true);
+
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock (wake_mutex_);
+
+        if (stop_requested_ && !queued())
+            break;
+
+        wake_condition_.wait (lock, [this, generation] {
+            return generation_ != generation || (stop_requested_ && !queued()); });
+    }
+
+    current_pool = nullptr;
+}
+
+QRunnable* WorkerPool::take (unsigned int worker_index, size_t& lane)
+{
+    unsigned int num_workers = workers_.size();
+
+    for (lane=0; lane < NUM_JOB_PRIORITIES; ++lane)
+    {
+        if (!queued_counts_[lane])
+            continue;
+
+        // reserve slot in lane
+        unsigned int running = running_counts_[lane];
+        do
+        {
+            if (running >= lane_limits_[lane])
+                break;
+        } while (!running_counts_[lane].compare_exchange_weak(running, running+1));
+
+        if (running >= lane_limits_[lane])
+            continue;
+
+        for (unsigned int cnt=0; cnt < num_workers; ++cnt)
+        {
+            unsigned int victim_index = (worker_index + cnt) % num_workers;
+
+            QRunnable* runnable = pop (*workers_.at(victim_index), lane);
+
+            if (runnable)
+            {
+                --queued_counts_[lane];
+                return runnable;
+            }
+        }
+
+        --running_counts_[lane]; // nothing found, release slot
+    }
+
+    return nullptr;
+}
+
+QRunnable* WorkerPool::pop (Worker& worker, size_t lane)
+{
+    std::lock_guard<std::mutex> lock (worker.mutex_);
+
+    std::deque<QRunnable*>& queue = worker.lanes_.at(lane);
+
+    if (queue.empty())
+        return nullptr;
+
+    QRunnable* runnable = queue.front();
+    queue.pop_front();
+
+    return runnable;
+}
+
+bool WorkerPool::queued () const
+{
+    for (auto& count_it : queued_counts_)
+    {
+        if (count_it)
+            return true;
+    }
+
+    return false;
+}
+
+void WorkerPool::wake (bool all)
+{
+    {
+        std::lock_guard<std::mutex> lock (wake_mutex_);
+        ++generation_;
+    }
+
+    if (all)
+        wake_condition_.notify_all();
+    else
+        wake_condition_.notify_one();
+}
@@ -0,0 +1,104 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WORKERPOOL_H_
+#define WORKERPOOL_H_
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "job.h"
+
+/**
+ * @brief Pool of worker threads with priority lanes and work stealing
+ *
+ * Each worker has its own queue per lane. Runnables started from a worker thread are queued at that worker,
+ * others are distributed round-robin. Idle workers take from their own queues first and steal from the others
+ * otherwise, always the oldest runnable, as the JobManager flushes jobs in order of addition. Lanes are served in
+ * order of priority, and the number of threads running runnables of a lane can be limited per lane.
+ *
+ * Runnables with autoDelete() set are deleted after running, as in QThreadPool.
+ */
+class WorkerPool
+{
+public:
+    /// @brief Constructor, starts num_threads workers, lane limits of 0 for no limit
+    WorkerPool (unsigned int num_threads, const std::array<unsigned int, NUM_JOB_PRIORITIES>& lane_limits);
+    /// @brief Destructor, stops the workers
+    virtual ~WorkerPool ();
+
+    /// @brief Queues runnable in lane of priority
+    void start (QRunnable* runnable, JobPriority priority);
+    /// @brief Waits until all queued runnables were run and stops the workers
+    void stop ();
+
+    unsigned int numThreads () const { return workers_.size(); }
+    /// @brief Returns number of threads currently running a runnable
+    unsigned int activeThreadCount () const { return active_count_; }
+    /// @brief Returns number of queued runnables of a lane, excluding running ones
+    unsigned int queuedCount (JobPriority priority) const { return queued_counts_.at(laneIndex(priority)); }
+    /// @brief Returns number of running runnables of a lane
+    unsigned int runningCount (JobPriority priority) const { return running_counts_.at(laneIndex(priority)); }
+
+protected:
+    struct Worker
+    {
+        std::mutex mutex_;
+        std::array<std::deque<QRunnable*>, NUM_JOB_PRIORITIES> lanes_;
+        std::thread thread_;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    std::array<unsigned int, NUM_JOB_PRIORITIES> lane_limits_;
+    std::array<std::atomic<unsigned int>, NUM_JOB_PRIORITIES> running_counts_;
+    std::array<std::atomic<unsigned int>, NUM_JOB_PRIORITIES> queued_counts_;
+    std::atomic<unsigned int> active_count_ {0};
+    std::atomic<unsigned int> next_worker_ {0};
+
+    /// Guards generation_ and stop_requested_
+    std::mutex wake_mutex_;
+    std::condition_variable wake_condition_;
+    /// Incremented on every start and finish, to detect changes while looking for work
+    unsigned long generation_ {0};
+    bool stop_requested_ {false};
+
+    static size_t laneIndex (JobPriority priority) { return static_cast<size_t> (priority); }
+
+    /// @brief Worker thread function
+    void work (unsigned int worker_index);
+    /// @brief Takes next runnable for worker and reserves its lane, nullptr if none can be run
+    QRunnable* take (unsigned int worker_index, size_t& lane);
+    /// @brief Pops oldest runnable of lane from worker's queue, nullptr if empty
+    QRunnable* pop (Worker& worker, size_t lane);
+    /// @brief Returns if any runnable is queued
+    bool queued () const;
+    /// @brief Increases generation and wakes workers
+    void wake (bool all);
+
+private:
+    WorkerPool (const WorkerPool&) = delete;
+    void operator= (const WorkerPool&) = delete;
+};
+
+#endif /* WORKERPOOL_H_ */
@@ -44,9 +44,7 @@ JSONDataMapping::JSONDataMapping (const std::string& class_id, const std::string
     registerParameter("dimension", &dimension_, "");
     registerParameter("unit", &unit_, "");
 
-    sub_keys_ = Utils::String::split(json_key_, '.');
-    has_sub_keys_ = sub_keys_.size() > 1;
-    num_sub_keys_ = sub_keys_.size();
+    splitKey();
 
     logdbg << "JSONDataMapping: ctor: key " << json_key_ << " num subkeys " << sub_keys_.size();
 
@@ -72,6 +70,7 @@ JSONDataMapping& JSONDataMapping::operator=(JSONDataMapping&& other)
     has_sub_keys_ = other.has_sub_keys_;
     sub_keys_ = std::move(other.sub_keys_);
     num_sub_keys_ = other.num_sub_keys_;
+    key_path_ = std::move(other.key_path_);
 
     other.configuration().updateParameterPointer ("active", &active_);
     other.configuration().updateParameterPointer ("json_key", &json_key_);
@@ -177,9 +176,16 @@ void JSONDataMapping::jsonKey(const std::string &json_key)
 
     json_key_ = json_key;
 
+    splitKey();
+}
+
+void JSONDataMapping::splitKey ()
+{
     sub_keys_ = Utils::String::split(json_key_, '.');
     has_sub_keys_ = sub_keys_.size() > 1;
     num_sub_keys_ = sub_keys_.size();
+
+    key_path_ = has_sub_keys_ ? sub_keys_ : std::vector<std::string> {json_key_};
 }
 
 //JSONDataMappingWidget* JSONDataMapping::widget ()
@@ -23,6 +23,7 @@
 #include "format.h"
 #include "nullablevector.h"
 #include "jsonutils.h"
+#include "jsontape.h"
 #include "configurable.h"
 #include "jsondatamappingwidget.h"
 
@@ -197,144 +198,113 @@ public:
     template<typename T>
     bool findAndSetValue(const nlohmann::json& j, NullableVector<T>& array_list, unsigned int row_cnt) const
     {
-        const nlohmann::json* val_ptr = &j;
+        return setValue (findValue(j), array_list, row_cnt);
+    }
+
+    /// @brief Finds and sets value of target report in tape as for nlohmann::json, returns bool mandatory missing
+    template<typename T>
+    bool findAndSetValue(const JSONTapeValue& tr, NullableVector<T>& array_list, unsigned int row_cnt) const
+    {
+        return setValue (findValue(tr), array_list, row_cnt);
+    }
+
+    /// @brief Returns value at key path in target report, nullptr if not found
+    const nlohmann::json* findValue (const nlohmann::json& j) const
+    {
+        const nlohmann::json* value = &j;
 
-        if (has_sub_keys_)
+        for (const std::string& key : key_path_)
         {
-            for (const std::string& sub_key : sub_keys_)
-            {
-                if (val_ptr->find (sub_key) != val_ptr->end())
-                {
-                    if (sub_key == sub_keys_.back()) // last found
-                    {
-                        val_ptr = &val_ptr->at(sub_key);
-                        break;
-                    }
-
-                    if (val_ptr->at(sub_key).is_object()) // not last, step in
-                        val_ptr = &val_ptr->at(sub_key);
-                    else // not last key, and not object
-                    {
-                        val_ptr = nullptr;
-                        break;
-                    }
-                }
-                else // not found
-                {
-                    val_ptr = nullptr;
-                    break;
-                }
-            }
+            if (!value->is_object())
+                return nullptr;
+
+            auto it = value->find(key);
+
+            if (it == value->end())
+                return nullptr;
+
+            value = &*it;
         }
-        else
+
+        return value;
+    }
+
+    /// @brief Returns node at key path in target report in tape, nullptr if not found
+    const JSONTape::Node* findValue (const JSONTapeValue& tr) const
+    {
+        size_t index = tr.index;
+
+        for (const std::string& key : key_path_) // not found if not object
         {
-            if (val_ptr->find (json_key_) != val_ptr->end())
-                val_ptr = &val_ptr->at(json_key_);
-            else
-                val_ptr = nullptr;
+            index = tr.tape.find (index, key);
+
+            if (index == JSONTape::npos)
+                return nullptr;
         }
 
-        if (val_ptr == nullptr || *val_ptr == nullptr)
+        return &tr.tape.node(index);
+    }
+
+    /// @brief Sets value found by findValue, nullptr if not found. Returns bool mandatory missing
+    template<typename T>
+    bool setValue(const nlohmann::json* value, NullableVector<T>& array_list, unsigned int row_cnt) const
+    {
+        if (value == nullptr || *value == nullptr)
+            return mandatory_;
+
+        try
         {
-            if (mandatory_)
-                return true;
+            if (json_value_format_ == "")
+                setValue(array_list, row_cnt, *value);
+            else
+                array_list.setFromFormat(row_cnt, json_value_format_, Utils::JSON::toString(*value));
 
-            //array_list.setNull(row_cnt);
-            return false;
+            logdbg << "JsonKey2DBOVariableMapping: setValue: key " << json_key_ << " json " << *value
+                   << " buffer " << array_list.get(row_cnt);
         }
-        else
+        catch (nlohmann::json::exception& e)
         {
-            try
-            {
-                //T tmp = *val_ptr;
-                if (json_value_format_ == "")
-                    array_list.set(row_cnt, *val_ptr);
-                else
-                    array_list.setFromFormat(row_cnt, json_value_format_, Utils::JSON::toString(*val_ptr));
-
-                logdbg << "JsonKey2DBOVariableMapping: setValue: key " << json_key_ << " json " << *val_ptr
-                       << " buffer " << array_list.get(row_cnt);
-            }
-            catch (nlohmann::json::exception& e)
-            {
-                logerr  <<  "JsonKey2DBOVariableMapping: setValue: key " << json_key_ << " json exception " << e.what();
-                array_list.setNull(row_cnt);
-            }
+            logerr  <<  "JsonKey2DBOVariableMapping: setValue: key " << json_key_ << " json exception " << e.what();
+            array_list.setNull(row_cnt);
         }
 
         return false; // everything ok
     }
 
-    bool findAndSetValue(const nlohmann::json& j, NullableVector<char>& array_list, unsigned int row_cnt) const
+    /**
+     * @brief Sets value given as node as by findAndSetValue, nullptr if not found. Returns bool mandatory missing
+     *
+     * Used if the value was found otherwise, e.g. by a JSONExtractionPlan. For containers, the node has to span
+     * their text.
+     */
+    template<typename T>
+    bool setValue(const JSONTape::Node* value, NullableVector<T>& array_list, unsigned int row_cnt) const
     {
-        const nlohmann::json* val_ptr = &j;
+        if (value == nullptr || value->type == JSONTape::Type::NULL_VALUE)
+            return mandatory_;
 
-        if (has_sub_keys_)
+        try
         {
-            for (const std::string& sub_key : sub_keys_)
-            {
-                if (val_ptr->find (sub_key) != val_ptr->end())
-                {
-                    if (sub_key == sub_keys_.back()) // last found
-                    {
-                        val_ptr = &val_ptr->at(sub_key);
-                        break;
-                    }
-
-                    if (val_ptr->at(sub_key).is_object()) // not last, step in
-                        val_ptr = &val_ptr->at(sub_key);
-                    else // not last key, and not object
-                    {
-                        val_ptr = nullptr;
-                        break;
-                    }
-                }
-                else // not found
-                {
-                    val_ptr = nullptr;
-                    break;
-                }
-            }
-        }
-        else
-        {
-            if (val_ptr->find (json_key_) != val_ptr->end())
-                val_ptr = &val_ptr->at(json_key_);
+            if (json_value_format_ == "")
+                setNodeValue(array_list, row_cnt, *value);
             else
-                val_ptr = nullptr;
-        }
-
-        if (val_ptr == nullptr || *val_ptr == nullptr)
-        {
-            if (mandatory_)
-                return true;
+                array_list.setFromFormat(row_cnt, json_value_format_, JSONTape::toString(*value));
 
-            //array_list.setNull(row_cnt);
-            return false;
+            logdbg << "JsonKey2DBOVariableMapping: setValue: key " << json_key_ << " json "
+                   << JSONTape::toString(*value) << " buffer " << array_list.get(row_cnt);
         }
-        else
+        catch (JSONTape::Error& e)
         {
-            try
-            {
-                //char tmp = static_cast<int> (*val_ptr);
-                if (json_value_format_ == "")
-                    array_list.set(row_cnt, static_cast<int> (*val_ptr));
-                else
-                    array_list.setFromFormat(row_cnt, json_value_format_, Utils::JSON::toString(*val_ptr));
-
-                logdbg << "JsonKey2DBOVariableMapping: setValue: json " << *val_ptr
-                       << " buffer " << array_list.get(row_cnt);
-            }
-            catch (nlohmann::json::exception& e)
-            {
-                logerr  <<  "JsonKey2DBOVariableMapping: setValue: key " << json_key_ << " json exception " << e.what();
-                array_list.setNull(row_cnt);
-            }
+            logerr  <<  "JsonKey2DBOVariableMapping: setValue: key " << json_key_ << " json exception " << e.what();
+            array_list.setNull(row_cnt);
         }
 
         return false; // everything ok
     }
 
+    /// @brief Returns keys of the nested objects leading to the value, ending with its key
+    const std::vector<std::string>& keyPath () const { return key_path_; }
+
     bool hasDimension () const { return dimension_.size() > 0; }
     /// @brief Returns dimension contained in the column
     std::string& dimensionRef () { return dimension_; }
@@ -398,10 +368,53 @@ private:
     bool has_sub_keys_ {false};
     std::vector<std::string> sub_keys_;
     unsigned int num_sub_keys_;
+    /// Sub-keys, or json key if not having sub-keys
+    std::vector<std::string> key_path_;
 
     std::unique_ptr<JSONDataMappingWidget> widget_;
 
     void initialize ();
+    /// @brief Splits json key into sub-keys and key path
+    void splitKey ();
+
+    template<typename T>
+    static void setValue (NullableVector<T>& array_list, unsigned int row_cnt, const nlohmann::json& j)
+    {
+        array_list.set(row_cnt, j);
+    }
+
+    static void setValue (NullableVector<char>& array_list, unsigned int row_cnt, const nlohmann::json& j)
+    {
+        array_list.set(row_cnt, static_cast<int> (j));
+    }
+
+    /// @brief Sets string by reference into json, without temporary copy
+    static void setValue (NullableVector<std::string>& array_list, unsigned int row_cnt, const nlohmann::json& j)
+    {
+        const std::string& value = j.get_ref<const std::string&>(); // throws type_error if not a string
+        array_list.set(row_cnt, value.c_str(), value.size());
+    }
+
+    template<typename T>
+    static void setNodeValue (NullableVector<T>& array_list, unsigned int row_cnt, const JSONTape::Node& value)
+    {
+        array_list.set(row_cnt, JSONTape::getNumber<T>(value));
+    }
+
+    static void setNodeValue (NullableVector<bool>& array_list, unsigned int row_cnt, const JSONTape::Node& value)
+    {
+        array_list.set(row_cnt, JSONTape::getBool(value));
+    }
+
+    /// @brief Sets string from text if not escaped, without temporary copy
+    static void setNodeValue (NullableVector<std::string>& array_list, unsigned int row_cnt,
+                              const JSONTape::Node& value)
+    {
+        if (value.type == JSONTape::Type::STRING && !value.flag)
+            array_list.set(row_cnt, value.text, value.size);
+        else
+            array_list.set(row_cnt, JSONTape::getString(value)); // throws Error if not a string
+    }
 
 protected:
     virtual void checkSubConfigurables () {}
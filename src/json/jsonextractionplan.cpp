@@ -0,0 +1,440 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cassert>
+
+#include "jsonextractionplan.h"
+#include "jsonobjectparser.h"
+#include "jsondatamapping.h"
+#include "jsonscan.h"
+#include "dbobject.h"
+#include "logger.h"
+
+namespace
+{
+inline const char* skipWhitespace (const char* pos, const char* end)
+{
+    while (pos != end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t'))
+        ++pos;
+
+    return pos;
+}
+}
+
+JSONExtractionPlan::JSONExtractionPlan (const std::map <std::string, JSONObjectParser>& parsers,
+                                        const std::map<std::string, std::shared_ptr<Buffer>>& buffers)
+{
+    scopes_.emplace_back(); // top-level object
+
+    for (auto& parser_it : parsers)
+    {
+        const JSONObjectParser& parser = parser_it.second;
+        assert (parser.initialized());
+
+        Parser plan;
+        plan.parser = &parser;
+        plan.buffer = buffers.at(parser.dbObject().name());
+        assert (plan.buffer);
+
+        if (parser.JSONContainerKey().size())
+        {
+            size_t container = addKeyPath(0, {parser.JSONContainerKey()});
+
+            if (keys_.at(container).records == npos)
+            {
+                keys_.at(container).records = scopes_.size();
+                scopes_.emplace_back();
+            }
+
+            plan.scope = keys_.at(container).records;
+        }
+        else
+            plan.scope = 0;
+
+        if (parser.filtersKeyValue()) // key not split into sub-keys, as in JSONObjectParser::keyValueMatches
+        {
+            plan.key_slot = keys_.at(addKeyPath(plan.scope, {parser.JSONKey()})).slot;
+            plan.key_value = parser.JSONValue();
+        }
+
+        const std::vector<JSONObjectParser::CompiledMapping>& mappings = parser.compiledMappings();
+        std::vector<ColumnHandle> columns = parser.bindColumns(*plan.buffer);
+
+        for (size_t cnt=0; cnt < mappings.size(); ++cnt)
+        {
+            size_t key = addKeyPath(plan.scope, mappings[cnt].mapping->keyPath());
+            plan.columns.push_back({&mappings[cnt], keys_.at(key).slot, columns[cnt]});
+        }
+
+        scopes_.at(plan.scope).parsers.push_back(parsers_.size());
+        parsers_.push_back(std::move(plan));
+    }
+
+    logdbg << "JSONExtractionPlan: ctor: parsers " << parsers_.size() << " scopes " << scopes_.size()
+           << " keys " << keys_.size() << " slots " << slots_.size();
+}
+
+bool JSONExtractionPlan::extract (const char* begin, const char* end)
+{
+    for (auto& parser_it : parsers_)
+    {
+        parser_it.begin_size = parser_it.buffer->size();
+        parser_it.row = parser_it.begin_size;
+        parser_it.parsed_any = false;
+    }
+
+    for (auto& scope_it : scopes_)
+        scope_it.found = false;
+
+    for (size_t slot : scopes_.at(0).value_slots)
+        slots_[slot].text = nullptr;
+
+    try
+    {
+        const char* pos = skipWhitespace(begin, end);
+
+        if (pos == end || *pos != '{')
+            JSONTape::syntaxError(pos, end, "expected object");
+
+        pos = skipWhitespace(scanObject(pos, end, scopes_.at(0).keys), end);
+
+        if (pos != end)
+            JSONTape::syntaxError(pos, end, "unexpected text after object");
+    }
+    catch (JSONTape::Error&)
+    {
+        // remove records of containers written before the error
+        for (auto& parser_it : parsers_)
+        {
+            if (parser_it.buffer->size() > parser_it.begin_size)
+                parser_it.buffer->cutToSize(parser_it.begin_size);
+        }
+
+        throw;
+    }
+
+    writeRecord(0);
+
+    bool parsed_any = false;
+
+    for (auto& parser_it : parsers_)
+    {
+        if (parser_it.scope && !scopes_.at(parser_it.scope).found)
+            loginf << "JSONExtractionPlan: extract: found target report array but '"
+                   << parser_it.parser->JSONContainerKey()  << "' not found";
+
+        parsed_any |= parser_it.parsed_any;
+    }
+
+    return parsed_any;
+}
+
+size_t JSONExtractionPlan::addKeyPath (size_t scope, const std::vector<std::string>& path)
+{
+    assert (path.size());
+
+    size_t key = npos;
+
+    for (const std::string& name : path)
+    {
+        // not used after adding to keys_, which might reallocate
+        std::vector<size_t>& siblings = (key == npos) ? scopes_.at(scope).keys : keys_.at(key).children;
+        size_t child = npos;
+
+        for (size_t sibling : siblings)
+        {
+            if (keys_.at(sibling).name == name)
+            {
+                child = sibling;
+                break;
+            }
+        }
+
+        if (child == npos)
+        {
+            child = keys_.size();
+            siblings.push_back(child);
+
+            keys_.emplace_back();
+            keys_.back().name = name;
+            keys_.back().slot = slots_.size();
+
+            slots_.push_back({nullptr, 0, 0, JSONTape::Type::NULL_VALUE, false});
+            scopes_.at(scope).value_slots.push_back(keys_.back().slot);
+        }
+
+        key = child;
+    }
+
+    return key;
+}
+
+const char* JSONExtractionPlan::scanObject (const char* pos, const char* end, const std::vector<size_t>& keys)
+{
+    assert (pos != end && *pos == '{');
+
+    pos = skipWhitespace(pos+1, end);
+
+    if (pos != end && *pos == '}')
+        return pos+1;
+
+    JSONTape::Node name;
+
+    while (true)
+    {
+        if (pos == end || *pos != '"')
+            JSONTape::syntaxError(pos, end, "expected key");
+
+        pos = skipWhitespace(JSONTape::parseScalar(pos, end, name), end);
+
+        if (pos == end || *pos != ':')
+            JSONTape::syntaxError(pos, end, "expected ':'");
+
+        pos = skipWhitespace(pos+1, end);
+
+        size_t key = npos;
+
+        for (size_t key_it : keys)
+        {
+            if (JSONTape::equals(name, keys_[key_it].name))
+            {
+                key = key_it;
+                break;
+            }
+        }
+
+        if (key == npos)
+            pos = skipValue(pos, end);
+        else
+            pos = scanValue(pos, end, keys_[key]);
+
+        pos = skipWhitespace(pos, end);
+
+        if (pos == end)
+            JSONTape::syntaxError(pos, end, "unexpected end of text");
+
+        if (*pos == '}')
+            return pos+1;
+
+        if (*pos != ',')
+            JSONTape::syntaxError(pos, end, "expected ',' or '}'");
+
+        pos = skipWhitespace(pos+1, end);
+    }
+}
+
+const char* JSONExtractionPlan::scanValue (const char* pos, const char* end, const Key& key)
+{
+    if (pos == end)
+        JSONTape::syntaxError(pos, end, "unexpected end of text");
+
+    if (slots_[key.slot].text) // duplicate key, last one is used as in nlohmann::json
+        resetKey(key);
+
+    const char* begin = pos;
+    JSONTape::Type type;
+
+    if (*pos == '{')
+    {
+        type = JSONTape::Type::OBJECT;
+        pos = key.children.size() ? scanObject(pos, end, key.children) : skipContainer(pos, end);
+    }
+    else if (*pos == '[')
+    {
+        type = JSONTape::Type::ARRAY;
+        pos = (key.records != npos) ? scanRecords(pos, end, key.records) : skipContainer(pos, end);
+    }
+    else
+        return JSONTape::parseScalar(pos, end, slots_[key.slot]);
+
+    // node spans text of container
+    slots_[key.slot] = {begin, static_cast<size_t>(pos-begin), 0, type, false};
+
+    return pos;
+}
+
+void JSONExtractionPlan::resetKey (const Key& key)
+{
+    slots_[key.slot].text = nullptr;
+
+    for (size_t child : key.children)
+        resetKey(keys_[child]);
+
+    if (key.records != npos)
+    {
+        // remove records of previous array
+        scopes_.at(key.records).found = false;
+
+        for (size_t parser_index : scopes_.at(key.records).parsers)
+        {
+            Parser& parser = parsers_[parser_index];
+
+            if (parser.buffer->size() > parser.begin_size)
+                parser.buffer->cutToSize(parser.begin_size);
+
+            parser.row = parser.begin_size;
+            parser.parsed_any = false;
+        }
+    }
+}
+
+const char* JSONExtractionPlan::scanRecords (const char* pos, const char* end, size_t scope)
+{
+    assert (pos != end && *pos == '[');
+
+    const std::vector<size_t>& keys = scopes_.at(scope).keys;
+    const std::vector<size_t>& value_slots = scopes_.at(scope).value_slots;
+
+    scopes_.at(scope).found = true;
+
+    pos = skipWhitespace(pos+1, end);
+
+    if (pos != end && *pos == ']')
+        return pos+1;
+
+    while (true)
+    {
+        if (pos != end && *pos == '{')
+        {
+            for (size_t slot : value_slots)
+                slots_[slot].text = nullptr;
+
+            pos = scanObject(pos, end, keys);
+
+            writeRecord(scope);
+        }
+        else
+            pos = skipValue(pos, end); // not a target report
+
+        pos = skipWhitespace(pos, end);
+
+        if (pos == end)
+            JSONTape::syntaxError(pos, end, "unexpected end of text");
+
+        if (*pos == ']')
+            return pos+1;
+
+        if (*pos != ',')
+            JSONTape::syntaxError(pos, end, "expected ',' or ']'");
+
+        pos = skipWhitespace(pos+1, end);
+    }
+}
+
+void JSONExtractionPlan::writeRecord (size_t scope)
+{
+    for (size_t parser_index : scopes_.at(scope).parsers)
+    {
+        Parser& parser = parsers_[parser_index];
+
+        if (parser.key_slot != npos)
+        {
+            const JSONTape::Node& key_value = slots_[parser.key_slot];
+
+            if (key_value.text == nullptr)
+            {
+                logdbg << "JSONExtractionPlan: writeRecord: skipping because of missing key '"
+                       << parser.parser->JSONKey() << "'";
+                continue;
+            }
+
+            if (!JSONTape::equals(key_value, parser.key_value))
+            {
+                logdbg << "JSONExtractionPlan: writeRecord: skipping because of wrong key value "
+                       << JSONTape::toString(key_value);
+                continue;
+            }
+        }
+
+        bool mandatory_missing = false;
+
+        for (const auto& column_it : parser.columns)
+        {
+            const JSONTape::Node& value = slots_[column_it.slot];
+
+            if (column_it.mapping->set_node(*column_it.mapping->mapping, value.text ? &value : nullptr,
+                                            column_it.column, parser.row))
+            {
+                mandatory_missing = true;
+                break;
+            }
+        }
+
+        if (mandatory_missing)
+        {
+            // cleanup
+            if (parser.buffer->size() > parser.row)
+                parser.buffer->cutToSize(parser.row);
+        }
+        else
+        {
+            ++parser.row;
+            parser.parsed_any = true;
+        }
+    }
+}
+
+const char* JSONExtractionPlan::skipValue (const char* pos, const char* end)
+{
+    if (pos != end && (*pos == '{' || *pos == '['))
+        return skipContainer(pos, end);
+
+    JSONTape::Node value;
+    return JSONTape::parseScalar(pos, end, value);
+}
+
+const char* JSONExtractionPlan::skipContainer (const char* pos, const char* end)
+{
+    size_t depth = 0;
+
+    while (true)
+    {
+        pos = Utils::JSONScan::findBracketOrQuote(pos, end);
+
+        if (pos == end)
+            JSONTape::syntaxError(pos, end, "unexpected end of text");
+
+        if (*pos == '"')
+        {
+            pos = skipString(pos+1, end);
+            continue;
+        }
+
+        if ((*pos | 0x20) == '{') // opening brace or bracket
+            ++depth;
+        else if (!--depth)
+            return pos+1;
+
+        ++pos;
+    }
+}
+
+const char* JSONExtractionPlan::skipString (const char* pos, const char* end)
+{
+    while (true)
+    {
+        pos = Utils::JSONScan::findAny(pos, end, '"', '\\', '\\');
+
+        if (pos == end || (*pos == '\\' && pos+1 == end))
+            JSONTape::syntaxError(pos, end, "unterminated string");
+
+        if (*pos == '"')
+            return pos+1;
+
+        pos += 2; // escaped character
+    }
+}
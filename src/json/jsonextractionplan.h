@@ -0,0 +1,136 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSONEXTRACTIONPLAN_H
+#define JSONEXTRACTIONPLAN_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer.h"
+#include "jsontape.h"
+#include "jsonobjectparser.h"
+
+/**
+ * @brief Extracts the mapped values of JSON objects directly into the buffers of their parsers, without a DOM
+ *
+ * The key paths of all active mappings, key filters and container keys of the parsers are merged into one key tree
+ * per scope: the top-level object, and the objects in the array of each container key. Each object is scanned once,
+ * only descending into values on a key path. Values of keys in the tree are kept as JSONTape::Node in a slot, all
+ * other values are skipped by scanning for brackets and quotes only. After each record of a scope, the slots are
+ * written into the bound buffer columns of the scope's parsers by their compiled mappings, with the same semantics
+ * as JSONObjectParser::parseJSON.
+ *
+ * The plan references the parsers, buffers and (while extracting) the object text, and is not thread-safe.
+ * Skipped values are only checked for balanced brackets, so syntax errors in unmapped values might not be found.
+ */
+class JSONExtractionPlan
+{
+public:
+    /// @brief Constructor, parsers have to be initialized, buffers are given by database object name
+    JSONExtractionPlan (const std::map <std::string, JSONObjectParser>& parsers,
+                        const std::map<std::string, std::shared_ptr<Buffer>>& buffers);
+
+    /**
+     * @brief Extracts object text [begin, end) into the buffers, returns true if any parser mapped it
+     *
+     * Throws JSONTape::Error on syntax errors, in which case rows added for the object are removed.
+     */
+    bool extract (const char* begin, const char* end);
+
+protected:
+    static const size_t npos = static_cast<size_t> (-1);
+
+    /// @brief Key of an object in the key tree
+    struct Key
+    {
+        std::string name;
+        /// Slot of value
+        size_t slot {npos};
+        /// Scope of the objects in the array value, npos if not a container key
+        size_t records {npos};
+        /// Keys needed in the object value
+        std::vector<size_t> children;
+    };
+
+    /// @brief Objects from which records are extracted
+    struct Scope
+    {
+        /// Keys needed in the objects
+        std::vector<size_t> keys;
+        /// Slots of all keys in the scope, reset for each object
+        std::vector<size_t> value_slots;
+        std::vector<size_t> parsers;
+        /// Flag indicating if the container array was found in the current object
+        bool found {false};
+    };
+
+    /// @brief Compiled mapping bound to slot and buffer column
+    struct Column
+    {
+        const JSONObjectParser::CompiledMapping* mapping;
+        size_t slot;
+        ColumnHandle column;
+    };
+
+    /// @brief Parser bound to its buffer
+    struct Parser
+    {
+        const JSONObjectParser* parser;
+        std::shared_ptr<Buffer> buffer;
+        size_t scope;
+        /// Slot of the key filter value, npos if all records are parsed
+        size_t key_slot {npos};
+        std::string key_value;
+        std::vector<Column> columns;
+
+        /// Buffer size before the current object
+        size_t begin_size {0};
+        /// Row of the next record, counted as in JSONObjectParser::parseJSON
+        size_t row {0};
+        bool parsed_any {false};
+    };
+
+    std::vector<Key> keys_;
+    std::vector<Scope> scopes_;
+    std::vector<Parser> parsers_;
+    std::vector<JSONTape::Node> slots_;
+
+    /// @brief Adds key path to scope, returns index of last key
+    size_t addKeyPath (size_t scope, const std::vector<std::string>& path);
+
+    /// @brief Scans object at pos for keys, returns position after it
+    const char* scanObject (const char* pos, const char* end, const std::vector<size_t>& keys);
+    /// @brief Scans value of needed key, returns position after it
+    const char* scanValue (const char* pos, const char* end, const Key& key);
+    /// @brief Scans array at pos for records of scope, returns position after it
+    const char* scanRecords (const char* pos, const char* end, size_t scope);
+
+    /// @brief Resets slots of key and its children, and removes records of its array
+    void resetKey (const Key& key);
+
+    /// @brief Writes current record of scope for all its parsers
+    void writeRecord (size_t scope);
+
+    static const char* skipValue (const char* pos, const char* end);
+    static const char* skipContainer (const char* pos, const char* end);
+    static const char* skipString (const char* pos, const char* end);
+};
+
+#endif // JSONEXTRACTIONPLAN_H
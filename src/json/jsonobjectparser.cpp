@@ -28,6 +28,46 @@
 
 using namespace nlohmann;
 
+namespace
+{
+template<typename T>
+bool setJSONValue (const JSONDataMapping& mapping, const json& tr, const ColumnHandle& column, size_t row)
+{
+    return mapping.findAndSetValue(tr, column.get<T>(), row);
+}
+
+template<typename T>
+bool setTapeValue (const JSONDataMapping& mapping, const JSONTapeValue& tr, const ColumnHandle& column, size_t row)
+{
+    return mapping.findAndSetValue(tr, column.get<T>(), row);
+}
+
+template<typename T>
+bool setNodeValue (const JSONDataMapping& mapping, const JSONTape::Node* value, const ColumnHandle& column,
+                   size_t row)
+{
+    return mapping.setValue(value, column.get<T>(), row);
+}
+
+template<typename T>
+JSONObjectParser::CompiledMapping compileMapping (const JSONDataMapping& mapping)
+{
+    return {&mapping, mapping.variable().name(), &setJSONValue<T>, &setTapeValue<T>, &setNodeValue<T>};
+}
+
+inline bool setValue (const JSONObjectParser::CompiledMapping& compiled, const json& tr, const ColumnHandle& column,
+                      size_t row)
+{
+    return compiled.set_json(*compiled.mapping, tr, column, row);
+}
+
+inline bool setValue (const JSONObjectParser::CompiledMapping& compiled, const JSONTapeValue& tr,
+                      const ColumnHandle& column, size_t row)
+{
+    return compiled.set_tape(*compiled.mapping, tr, column, row);
+}
+}
+
 JSONObjectParser::JSONObjectParser (const std::string& class_id, const std::string& instance_id, Configurable* parent)
     :  Configurable (class_id, instance_id, parent)
 {
@@ -55,6 +95,7 @@ JSONObjectParser& JSONObjectParser::operator=(JSONObjectParser&& other)
     json_value_ = other.json_value_;
 
     data_mappings_ = std::move(other.data_mappings_);
+    compiled_mappings_ = std::move(other.compiled_mappings_); // mappings not reallocated by move
 
     var_list_ = other.var_list_;
 
@@ -85,6 +126,9 @@ void JSONObjectParser::generateSubConfigurable (const std::string& class_id, con
     if (class_id == "JSONDataMapping")
     {
         data_mappings_.emplace_back (class_id, instance_id, *this);
+
+        if (initialized_) // might have been reallocated
+            compileMappings();
     }
     else
         throw std::runtime_error ("DBObject: generateSubConfigurable: unknown class_id "+class_id );
@@ -187,10 +231,85 @@ void JSONObjectParser::initialize ()
 
         not_parse_all_ = (json_key_ != "*") && (json_value_ != "*");
 
+        compileMappings();
+
         initialized_ = true;
     }
 }
 
+void JSONObjectParser::compileMappings ()
+{
+    compiled_mappings_.clear();
+
+    for (const auto& mapping : data_mappings_)
+    {
+        if (!mapping.active())
+        {
+            assert (!mapping.mandatory());
+            continue;
+        }
+
+        PropertyDataType data_type = mapping.variable().dataType();
+
+        switch (data_type)
+        {
+        case PropertyDataType::BOOL:
+            compiled_mappings_.push_back(compileMapping<bool>(mapping));
+            break;
+        case PropertyDataType::CHAR:
+            compiled_mappings_.push_back(compileMapping<char>(mapping));
+            break;
+        case PropertyDataType::UCHAR:
+            compiled_mappings_.push_back(compileMapping<unsigned char>(mapping));
+            break;
+        case PropertyDataType::INT:
+            compiled_mappings_.push_back(compileMapping<int>(mapping));
+            break;
+        case PropertyDataType::UINT:
+            compiled_mappings_.push_back(compileMapping<unsigned int>(mapping));
+            break;
+        case PropertyDataType::LONGINT:
+            compiled_mappings_.push_back(compileMapping<long int>(mapping));
+            break;
+        case PropertyDataType::ULONGINT:
+            compiled_mappings_.push_back(compileMapping<unsigned long>(mapping));
+            break;
+        case PropertyDataType::FLOAT:
+            compiled_mappings_.push_back(compileMapping<float>(mapping));
+            break;
+        case PropertyDataType::DOUBLE:
+            compiled_mappings_.push_back(compileMapping<double>(mapping));
+            break;
+        case PropertyDataType::STRING:
+            compiled_mappings_.push_back(compileMapping<std::string>(mapping));
+            break;
+        default:
+            logerr  <<  "JSONObjectParser: compileMappings: impossible for property type "
+                     << Property::asString(data_type);
+            throw std::runtime_error ("JSONObjectParser: compileMappings: impossible property type "
+                                      + Property::asString(data_type));
+        }
+    }
+
+    logdbg << "JSONObjectParser: compileMappings: " << compiled_mappings_.size() << " active mappings";
+}
+
+std::vector<ColumnHandle> JSONObjectParser::bindColumns (Buffer& buffer) const
+{
+    assert (initialized_);
+
+    const PropertyList& properties = buffer.properties();
+    std::vector<ColumnHandle> columns;
+
+    for (const auto& compiled : compiled_mappings_)
+    {
+        assert (properties.hasProperty(compiled.variable_name));
+        columns.push_back(buffer.column(properties.get(compiled.variable_name)));
+    }
+
+    return columns;
+}
+
 std::shared_ptr<Buffer> JSONObjectParser::getNewBuffer () const
 {
     assert (initialized_);
@@ -198,7 +317,8 @@ std::shared_ptr<Buffer> JSONObjectParser::getNewBuffer () const
     return std::shared_ptr<Buffer> {new Buffer (list_, db_object_->name())};
 }
 
-bool JSONObjectParser::parseJSON (nlohmann::json& j, std::shared_ptr<Buffer> buffer) const
+bool JSONObjectParser::parseJSON (nlohmann::json& j, std::shared_ptr<Buffer> buffer,
+                                  const std::vector<ColumnHandle>& columns) const
 {
     assert (initialized_);
 
@@ -229,7 +349,7 @@ bool JSONObjectParser::parseJSON (nlohmann::json& j, std::shared_ptr<Buffer> buf
                 json& tr = tr_it.value();
                 assert (tr.is_object());
 
-                parsed = parseTargetReport (tr, buffer, row_cnt);
+                parsed = parseTargetReport (tr, buffer, columns, row_cnt);
 
                 if (parsed)
                     ++row_cnt;
@@ -248,7 +368,7 @@ bool JSONObjectParser::parseJSON (nlohmann::json& j, std::shared_ptr<Buffer> buf
         //loginf << "found single target report";
         assert (j.is_object());
 
-        parsed_any = parseTargetReport (j, buffer, row_cnt);
+        parsed_any = parseTargetReport (j, buffer, columns, row_cnt);
 
 //        if (!skipped)
 //            ++row_cnt;
@@ -257,137 +377,113 @@ bool JSONObjectParser::parseJSON (nlohmann::json& j, std::shared_ptr<Buffer> buf
     return parsed_any;
 }
 
-bool JSONObjectParser::parseTargetReport (const nlohmann::json& tr, std::shared_ptr<Buffer> buffer,
-                                          size_t row_cnt) const
+bool JSONObjectParser::parseJSON (const JSONTapeValue& j, std::shared_ptr<Buffer> buffer,
+                                  const std::vector<ColumnHandle>& columns) const
 {
-    // check key match
-    if (not_parse_all_)
+    assert (initialized_);
+
+    assert (buffer != nullptr);
+
+    const JSONTape& tape = j.tape;
+
+    size_t row_cnt = buffer->size();
+    bool parsed_any = false;
+
+    if (json_container_key_.size())
     {
-        if (tr.find (json_key_) != tr.end())
+        bool parsed = false;
+        size_t ac_list = tape.find(j.index, json_container_key_);
+
+        if (ac_list != JSONTape::npos)
         {
-            if (tr.at(json_key_) != json_value_)
+            assert (tape.isArray(ac_list));
+
+            for (size_t tr = tape.begin(ac_list); tr != tape.end(ac_list); tr = tape.next(tr))
             {
-                logdbg << "JsonMapping: parseTargetReport: skipping because of wrong key value " << tr.at(json_key_);
-                return false;
+                assert (tape.isObject(tr));
+
+                parsed = parseTargetReport (JSONTapeValue {tape, tr}, buffer, columns, row_cnt);
+
+                if (parsed)
+                    ++row_cnt;
+
+                parsed_any |= parsed;
             }
-            else
-                logdbg << "JsonMapping: parseTargetReport: parsing with correct key and value";
-        }
-        else
-        {
-            logdbg << "JsonMapping: parseTargetReport: skipping because of missing key '" << json_key_ << "'";
-            return false;
         }
+        else // parsed stays false
+            loginf << "JSONObjectParser: parseJSON: found target report array but '"
+                   << json_container_key_  << "' not found";
     }
+    else
+    {
+        assert (tape.isObject(j.index));
 
-    PropertyDataType data_type;
-    std::string current_var_name;
+        parsed_any = parseTargetReport (j, buffer, columns, row_cnt);
+    }
 
-    bool mandatory_missing;
+    return parsed_any;
+}
 
-    for (const auto& map_it : data_mappings_)
+bool JSONObjectParser::keyValueMatches (const nlohmann::json& tr) const
+{
+    if (tr.find (json_key_) != tr.end())
     {
-        if (!map_it.active())
+        if (tr.at(json_key_) != json_value_)
         {
-            assert (!map_it.mandatory());
-            continue;
+            logdbg << "JsonMapping: parseTargetReport: skipping because of wrong key value " << tr.at(json_key_);
+            return false;
         }
+        else
+            logdbg << "JsonMapping: parseTargetReport: parsing with correct key and value";
+    }
+    else
+    {
+        logdbg << "JsonMapping: parseTargetReport: skipping because of missing key '" << json_key_ << "'";
+        return false;
+    }
 
-        //logdbg << "setting data mapping key " << data_it.jsonKey();
-
-        data_type = map_it.variable().dataType();
-        current_var_name = map_it.variable().name();
-
-        switch (data_type)
-        {
-        case PropertyDataType::BOOL:
-        {
-            logdbg << "bool " << current_var_name << " format '" << map_it.jsonValueFormat() << "'";
-            assert (buffer->has<bool>(current_var_name));
-            mandatory_missing = map_it.findAndSetValue (tr, buffer->get<bool> (current_var_name), row_cnt);
+    return true;
+}
 
-            break;
-        }
-        case PropertyDataType::CHAR:
-        {
-            logdbg << "char " << current_var_name << " format '" << map_it.jsonValueFormat() << "'";
-            assert (buffer->has<char>(current_var_name));
-            mandatory_missing = map_it.findAndSetValue (tr, buffer->get<char> (current_var_name), row_cnt);
+bool JSONObjectParser::keyValueMatches (const JSONTapeValue& tr) const
+{
+    size_t value = tr.tape.find(tr.index, json_key_);
 
-            break;
-        }
-        case PropertyDataType::UCHAR:
-        {
-            logdbg << "uchar " << current_var_name << " format '" << map_it.jsonValueFormat() << "'";
-            assert (buffer->has<unsigned char>(current_var_name));
-            mandatory_missing = map_it.findAndSetValue (tr, buffer->get<unsigned char> (current_var_name), row_cnt);
+    if (value == JSONTape::npos)
+    {
+        logdbg << "JsonMapping: parseTargetReport: skipping because of missing key '" << json_key_ << "'";
+        return false;
+    }
 
-            break;
-        }
-        case PropertyDataType::INT:
-        {
-            logdbg << "int " << current_var_name << " format '" << map_it.jsonValueFormat() << "'";
-            assert (buffer->has<int>(current_var_name));
-            mandatory_missing = map_it.findAndSetValue (tr, buffer->get<int> (current_var_name), row_cnt);
+    if (!tr.tape.equals(value, json_value_))
+    {
+        logdbg << "JsonMapping: parseTargetReport: skipping because of wrong key value " << tr.tape.toString(value);
+        return false;
+    }
 
-            break;
-        }
-        case PropertyDataType::UINT:
-        {
-            logdbg << "uint " << current_var_name << " format '" << map_it.jsonValueFormat() << "'";
-            assert (buffer->has<unsigned int>(current_var_name));
-            mandatory_missing = map_it.findAndSetValue (tr, buffer->get<unsigned int> (current_var_name), row_cnt);
+    return true;
+}
 
-            break;
-        }
-        case PropertyDataType::LONGINT:
-        {
-            logdbg << "long " << current_var_name << " format '" << map_it.jsonValueFormat() << "'";
-            assert (buffer->has<long int>(current_var_name));
-            mandatory_missing = map_it.findAndSetValue (tr, buffer->get<long int> (current_var_name), row_cnt);
+template <typename Record>
+bool JSONObjectParser::parseTargetReport (const Record& tr, std::shared_ptr<Buffer> buffer,
+                                          const std::vector<ColumnHandle>& columns, size_t row_cnt) const
+{
+    assert (columns.size() == compiled_mappings_.size());
 
-            break;
-        }
-        case PropertyDataType::ULONGINT:
-        {
-            logdbg << "ulong " << current_var_name << " format '" << map_it.jsonValueFormat() << "'";
-            assert (buffer->has<unsigned long>(current_var_name));
-            mandatory_missing = map_it.findAndSetValue (tr, buffer->get<unsigned long> (current_var_name), row_cnt);
+    // check key match
+    if (not_parse_all_ && !keyValueMatches(tr))
+        return false;
 
-            break;
-        }
-        case PropertyDataType::FLOAT:
-        {
-            logdbg << "float " << current_var_name << " format '" << map_it.jsonValueFormat() << "'";
-            assert (buffer->has<float>(current_var_name));
-            mandatory_missing = map_it.findAndSetValue (tr, buffer->get<float> (current_var_name), row_cnt);
-            break;
-        }
-        case PropertyDataType::DOUBLE:
-        {
-            logdbg << "double " << current_var_name << " format '" << map_it.jsonValueFormat() << "'";
-            assert (buffer->has<double>(current_var_name));
-            mandatory_missing = map_it.findAndSetValue (tr, buffer->get<double> (current_var_name), row_cnt);
+    bool mandatory_missing = false;
+    size_t num_mappings = compiled_mappings_.size();
 
-            break;
-        }
-        case PropertyDataType::STRING:
+    for (size_t cnt=0; cnt < num_mappings; ++cnt)
+    {
+        if (setValue(compiled_mappings_[cnt], tr, columns[cnt], row_cnt))
         {
-            logdbg << "string " << current_var_name << " format '" << map_it.jsonValueFormat() << "'";
-            assert (buffer->has<std::string>(current_var_name));
-            mandatory_missing = map_it.findAndSetValue (tr, buffer->get<std::string> (current_var_name), row_cnt);
-
+            mandatory_missing = true;
             break;
         }
-        default:
-            logerr  <<  "JsonMapping: parseTargetReport: impossible for property type "
-                     << Property::asString(data_type);
-            throw std::runtime_error ("JsonMapping: parseTargetReport: impossible property type "
-                                      + Property::asString(data_type));
-        }
-
-        if (mandatory_missing)
-            break;
     }
 
     if (mandatory_missing)
@@ -417,6 +513,9 @@ void JSONObjectParser::removeMapping (unsigned int index)
     }
 
     data_mappings_.erase(data_mappings_.begin()+index);
+
+    if (initialized_)
+        compileMappings();
 }
 
 void JSONObjectParser::transformBuffer (std::shared_ptr<Buffer> buffer, long key_begin) const
@@ -633,6 +732,9 @@ void JSONObjectParser::setMappingActive (JSONDataMapping& mapping, bool active)
     }
 
     mapping.active(active);
+
+    if (initialized_)
+        compileMappings();
 }
 
 
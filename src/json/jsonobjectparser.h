@@ -33,11 +33,31 @@
 class DBObject;
 class DBOVariable;
 class Buffer;
+class ColumnHandle;
 
 class JSONObjectParser : public Configurable
 {
     using MappingIterator = std::vector<JSONDataMapping>::iterator;
 public:
+    /**
+     * @brief Active mapping compiled for parsing, with setters of the data type of its variable
+     *
+     * Setters find the value at the key path of the mapping, set it in the column and return mandatory missing.
+     */
+    struct CompiledMapping
+    {
+        const JSONDataMapping* mapping;
+        std::string variable_name;
+
+        bool (*set_json) (const JSONDataMapping& mapping, const nlohmann::json& tr, const ColumnHandle& column,
+                          size_t row);
+        bool (*set_tape) (const JSONDataMapping& mapping, const JSONTapeValue& tr, const ColumnHandle& column,
+                          size_t row);
+        /// Sets value found otherwise, nullptr if not found
+        bool (*set_node) (const JSONDataMapping& mapping, const JSONTape::Node* value, const ColumnHandle& column,
+                          size_t row);
+    };
+
     JSONObjectParser (const std::string& class_id, const std::string& instance_id, Configurable* parent);
     JSONObjectParser() = default;
     JSONObjectParser(JSONObjectParser&& other) { *this = std::move(other); }
@@ -58,13 +78,22 @@ public:
 
     MappingIterator begin() { return data_mappings_.begin(); }
     MappingIterator end() { return data_mappings_.end(); }
+    const std::vector<JSONDataMapping>& dataMappings() const { return data_mappings_; }
     bool hasMapping (unsigned int index) const;
     void removeMapping (unsigned int index);
 
     void transformBuffer (std::shared_ptr<Buffer> buffer, long key_begin=-1) const;
 
-    // returs true on successful parse
-    bool parseJSON (nlohmann::json& j, std::shared_ptr<Buffer> buffer) const;
+    /// @brief Returns compiled active mappings, updated when mappings are added, removed or (de)activated
+    const std::vector<CompiledMapping>& compiledMappings() const { return compiled_mappings_; }
+    /// @brief Returns columns of buffer from getNewBuffer for compiled mappings, to be bound once for parsing
+    std::vector<ColumnHandle> bindColumns (Buffer& buffer) const;
+
+    // returs true on successful parse, columns from bindColumns
+    bool parseJSON (nlohmann::json& j, std::shared_ptr<Buffer> buffer, const std::vector<ColumnHandle>& columns) const;
+    /// @brief Parses document in tape as parseJSON for nlohmann::json, returns true on successful parse
+    bool parseJSON (const JSONTapeValue& j, std::shared_ptr<Buffer> buffer,
+                    const std::vector<ColumnHandle>& columns) const;
 
     const DBOVariableSet& variableList() const;
 
@@ -74,6 +103,9 @@ public:
     std::string dataSourceVariableName() const;
     void dataSourceVariableName(const std::string& name);
 
+    /// @brief Returns flag indicating if only target reports with the JSON key and value are parsed
+    bool filtersKeyValue() const { return not_parse_all_; }
+
     bool initialized() const { return initialized_; }
     void initialize ();
 
@@ -109,9 +141,19 @@ private:
     std::unique_ptr<JSONObjectParserWidget> widget_;
 
     std::vector <JSONDataMapping> data_mappings_;
+    std::vector <CompiledMapping> compiled_mappings_;
+
+    /// @brief Compiles active mappings, required after changes of data_mappings_
+    void compileMappings ();
+
+    // returns true on successful parse, for nlohmann::json or JSONTapeValue
+    template <typename Record>
+    bool parseTargetReport (const Record& tr, std::shared_ptr<Buffer> buffer, const std::vector<ColumnHandle>& columns,
+                            size_t row_cnt) const;
 
-    // returns true on successful parse
-    bool parseTargetReport (const nlohmann::json& tr, std::shared_ptr<Buffer> buffer, size_t row_cnt) const;
+    /// @brief Returns flag indicating if target report has json_key_ with value json_value_
+    bool keyValueMatches (const nlohmann::json& tr) const;
+    bool keyValueMatches (const JSONTapeValue& tr) const;
 
 protected:
     virtual void checkSubConfigurables () {}
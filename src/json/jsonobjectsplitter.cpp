@@ -0,0 +1,136 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cassert>
+
+#include "jsonobjectsplitter.h"
+#include "jsonscan.h"
+#include "logger.h"
+
+using namespace Utils;
+
+JSONObjectSplitter::JSONObjectSplitter ()
+    : block_(new JSONObjectBlock())
+{
+}
+
+void JSONObjectSplitter::add (const char* data, size_t size)
+{
+    block_->text_.append(data, size);
+    scan();
+}
+
+size_t JSONObjectSplitter::read (std::istream& stream, size_t max_size)
+{
+    std::string& text = block_->text_;
+    size_t old_size = text.size();
+
+    text.resize(old_size + max_size);
+    stream.read(&text[old_size], max_size);
+
+    size_t read_size = stream.gcount();
+    text.resize(old_size + read_size);
+
+    scan();
+
+    return read_size;
+}
+
+std::shared_ptr<JSONObjectBlock> JSONObjectSplitter::takeBlock ()
+{
+    std::shared_ptr<JSONObjectBlock> block = block_;
+    block_.reset(new JSONObjectBlock());
+
+    if (depth_) // move incomplete object
+    {
+        assert (object_start_ < block->text_.size());
+
+        block_->text_.assign(block->text_, object_start_, std::string::npos);
+        block->text_.resize(object_start_);
+
+        scan_pos_ -= object_start_;
+        object_start_ = 0;
+    }
+    else
+        scan_pos_ = 0;
+
+    logdbg << "JSONObjectSplitter: takeBlock: objects " << block->objects_.size() << " text " << block->text_.size()
+           << " kept " << block_->text_.size();
+
+    return block;
+}
+
+void JSONObjectSplitter::scan ()
+{
+    const char* text = block_->text_.data();
+    const char* pos = text + scan_pos_;
+    const char* end = text + block_->text_.size();
+
+    while (pos != end)
+    {
+        if (in_string_)
+        {
+            if (escaped_) // escaped character
+            {
+                escaped_ = false;
+                ++pos;
+                continue;
+            }
+
+            pos = JSONScan::findAny (pos, end, '"', '\\', '\\');
+
+            if (pos == end)
+                break;
+
+            if (*pos == '\\')
+                escaped_ = true;
+            else
+                in_string_ = false;
+
+            ++pos;
+            continue;
+        }
+
+        pos = JSONScan::findAny (pos, end, '{', '}', '"');
+
+        if (pos == end)
+            break;
+
+        if (*pos == '"')
+            in_string_ = true;
+        else if (*pos == '{')
+        {
+            if (!depth_)
+                object_start_ = pos - text;
+
+            ++depth_;
+        }
+        else if (depth_) // closing brace
+        {
+            --depth_;
+
+            if (!depth_)
+                block_->objects_.push_back({object_start_, pos + 1 - text - object_start_});
+        }
+        else
+            logwrn << "JSONObjectSplitter: scan: closing brace outside of object ignored";
+
+        ++pos;
+    }
+
+    scan_pos_ = pos - text;
+}
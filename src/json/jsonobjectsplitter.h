@@ -0,0 +1,105 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSONOBJECTSPLITTER_H
+#define JSONOBJECTSPLITTER_H
+
+#include <istream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Block of JSON text with the ranges of the complete top-level objects in it
+ *
+ * Objects are not copied, but referenced by offset and size in the shared text.
+ */
+class JSONObjectBlock
+{
+    friend class JSONObjectSplitter;
+
+public:
+    /// @brief Returns number of objects
+    size_t size () const { return objects_.size(); }
+    bool empty () const { return objects_.empty(); }
+
+    /// @brief Returns pointer to first character of object
+    const char* objectBegin (size_t index) const { return text_.data() + objects_.at(index).first; }
+    /// @brief Returns pointer after last character of object
+    const char* objectEnd (size_t index) const { return objectBegin(index) + objects_.at(index).second; }
+    /// @brief Returns copy of object text, e.g. for error messages
+    std::string object (size_t index) const { return std::string (objectBegin(index), objectEnd(index)); }
+
+    /// @brief Returns number of text bytes
+    size_t textSize () const { return text_.size(); }
+
+protected:
+    std::string text_;
+    /// Offset and size of each object in text_
+    std::vector<std::pair<size_t, size_t>> objects_;
+};
+
+/**
+ * @brief Splits JSON text given in blocks of arbitrary size into top-level objects
+ *
+ * Text is appended to the current block once and scanned for object boundaries, skipping to the next brace or
+ * quote several bytes at a time. Braces in strings (including escaped quotes) are handled, text outside of objects
+ * (e.g. commas, newlines, enclosing array brackets) is ignored. Complete objects are taken as JSONObjectBlock, an
+ * incomplete last object is moved into the next block.
+ */
+class JSONObjectSplitter
+{
+public:
+    /// @brief Constructor
+    JSONObjectSplitter ();
+
+    /// @brief Appends and scans text
+    void add (const char* data, size_t size);
+    /// @brief Reads up to max_size bytes from stream directly into the block and scans them, returns number read
+    size_t read (std::istream& stream, size_t max_size);
+
+    /// @brief Returns number of complete objects in current block
+    size_t numObjects () const { return block_->objects_.size(); }
+    /// @brief Returns number of text bytes in current block
+    size_t textSize () const { return block_->text_.size(); }
+    /// @brief Returns flag indicating if an object was started but not completed
+    bool inObject () const { return depth_ > 0; }
+    /// @brief Returns flag indicating if scanned text ends outside of objects and strings
+    bool atTopLevel () const { return !depth_ && !in_string_; }
+
+    /// @brief Returns block with all complete objects, continues with the incomplete rest in a new block
+    std::shared_ptr<JSONObjectBlock> takeBlock ();
+
+protected:
+    std::shared_ptr<JSONObjectBlock> block_;
+
+    /// Position in block text up to which was scanned
+    size_t scan_pos_ {0};
+    /// Start of current object in block text, only valid if depth_ > 0
+    size_t object_start_ {0};
+    /// Number of open braces
+    size_t depth_ {0};
+    bool in_string_ {false};
+    /// Flag indicating that the last scanned character was an escape in a string
+    bool escaped_ {false};
+
+    /// @brief Scans block text after scan_pos_
+    void scan ();
+};
+
+#endif // JSONOBJECTSPLITTER_H
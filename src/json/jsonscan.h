@@ -0,0 +1,137 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSONSCAN_H
+#define JSONSCAN_H
+
+#include <cstdint>
+#include <cstring>
+
+namespace Utils
+{
+
+/// @brief Helpers for scanning JSON text 8 bytes at a time, using one 64-bit word per step
+namespace JSONScan
+{
+
+const uint64_t LOW_BITS = 0x0101010101010101ULL;
+const uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+/// @brief Returns word with all bytes set to c
+inline uint64_t broadcast (char c)
+{
+    return LOW_BITS * static_cast<unsigned char> (c);
+}
+
+/// @brief Returns non-zero if any byte of word equals the byte in pattern (as by broadcast)
+inline uint64_t hasByte (uint64_t word, uint64_t pattern)
+{
+    uint64_t value = word ^ pattern;
+    return (value - LOW_BITS) & ~value & HIGH_BITS;
+}
+
+/// @brief Returns non-zero if any byte of word is below 0x20, i.e. a control character
+inline uint64_t hasControl (uint64_t word)
+{
+    return (word - broadcast(0x20)) & ~word & HIGH_BITS;
+}
+
+/// @brief Returns first position of one of the characters in [begin, end), or end
+inline const char* findAny (const char* begin, const char* end, char first, char second, char third)
+{
+    uint64_t first_pattern = broadcast(first);
+    uint64_t second_pattern = broadcast(second);
+    uint64_t third_pattern = broadcast(third);
+
+    uint64_t word;
+
+    while (end - begin >= 8)
+    {
+        std::memcpy (&word, begin, 8);
+
+        if (hasByte(word, first_pattern) | hasByte(word, second_pattern) | hasByte(word, third_pattern))
+            break; // found in this word
+
+        begin += 8;
+    }
+
+    while (begin != end && *begin != first && *begin != second && *begin != third)
+        ++begin;
+
+    return begin;
+}
+
+/// @brief Returns first position of a quote, backslash or control character in [begin, end), or end
+inline const char* findStringSpecial (const char* begin, const char* end)
+{
+    uint64_t quote_pattern = broadcast('"');
+    uint64_t backslash_pattern = broadcast('\\');
+
+    uint64_t word;
+
+    while (end - begin >= 8)
+    {
+        std::memcpy (&word, begin, 8);
+
+        if (hasByte(word, quote_pattern) | hasByte(word, backslash_pattern) | hasControl(word))
+            break; // found in this word
+
+        begin += 8;
+    }
+
+    while (begin != end && *begin != '"' && *begin != '\\' && static_cast<unsigned char>(*begin) >= 0x20)
+        ++begin;
+
+    return begin;
+}
+
+/**
+ * @brief Returns first position of a brace, bracket or quote in [begin, end), or end
+ *
+ * Setting bit 0x20 maps brackets to braces and no other character onto them, so only two patterns are checked.
+ */
+inline const char* findBracketOrQuote (const char* begin, const char* end)
+{
+    uint64_t case_bits = broadcast(0x20);
+    uint64_t open_pattern = broadcast('{');
+    uint64_t close_pattern = broadcast('}');
+    uint64_t quote_pattern = broadcast('"');
+
+    uint64_t word;
+
+    while (end - begin >= 8)
+    {
+        std::memcpy (&word, begin, 8);
+
+        if (hasByte(word | case_bits, open_pattern) | hasByte(word | case_bits, close_pattern)
+                | hasByte(word, quote_pattern))
+            break; // found in this word
+
+        begin += 8;
+    }
+
+    while (begin != end && (*begin | 0x20) != '{' && (*begin | 0x20) != '}' && *begin != '"')
+        ++begin;
+
+    return begin;
+}
+
+}
+
+}
+
+#endif // JSONSCAN_H
@@ -0,0 +1,554 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
+
+#include "jsontape.h"
+#include "jsonscan.h"
+
+using namespace Utils;
+
+namespace
+{
+/// Maximum nesting depth of containers, to limit recursion
+const unsigned int JSON_TAPE_MAX_DEPTH=512;
+
+inline const char* skipWhitespace (const char* pos, const char* end)
+{
+    while (pos != end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t'))
+        ++pos;
+
+    return pos;
+}
+
+inline bool isDigit (char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/// @brief Returns value of hex digit, or -1
+inline int hexValue (char c)
+{
+    if (c >= '0' && c <= '9')
+        return c-'0';
+    if (c >= 'a' && c <= 'f')
+        return c-'a'+10;
+    if (c >= 'A' && c <= 'F')
+        return c-'A'+10;
+    return -1;
+}
+
+/// @brief Reads 4 hex digits at pos, returns -1 if invalid
+inline long readCodeUnit (const char* pos, const char* end)
+{
+    if (end-pos < 4)
+        return -1;
+
+    long value = 0;
+
+    for (unsigned int cnt=0; cnt < 4; ++cnt)
+    {
+        int digit = hexValue(pos[cnt]);
+
+        if (digit < 0)
+            return -1;
+
+        value = value*16+digit;
+    }
+
+    return value;
+}
+
+inline void appendUTF8 (std::string& text, unsigned long code_point)
+{
+    if (code_point < 0x80)
+        text += static_cast<char> (code_point);
+    else if (code_point < 0x800)
+    {
+        text += static_cast<char> (0xC0 | (code_point >> 6));
+        text += static_cast<char> (0x80 | (code_point & 0x3F));
+    }
+    else if (code_point < 0x10000)
+    {
+        text += static_cast<char> (0xE0 | (code_point >> 12));
+        text += static_cast<char> (0x80 | ((code_point >> 6) & 0x3F));
+        text += static_cast<char> (0x80 | (code_point & 0x3F));
+    }
+    else
+    {
+        text += static_cast<char> (0xF0 | (code_point >> 18));
+        text += static_cast<char> (0x80 | ((code_point >> 12) & 0x3F));
+        text += static_cast<char> (0x80 | ((code_point >> 6) & 0x3F));
+        text += static_cast<char> (0x80 | (code_point & 0x3F));
+    }
+}
+}
+
+size_t JSONTape::parse (const char* begin, const char* end)
+{
+    assert (begin <= end);
+
+    size_t root = nodes_.size();
+
+    try
+    {
+        const char* pos = skipWhitespace(begin, end);
+
+        pos = parseValue(pos, end, 0);
+        pos = skipWhitespace(pos, end);
+
+        if (pos != end)
+            syntaxError(pos, end, "unexpected text after value");
+    }
+    catch (Error&)
+    {
+        nodes_.resize(root);
+        throw;
+    }
+
+    roots_.push_back(root);
+
+    return root;
+}
+
+const char* JSONTape::parseValue (const char* pos, const char* end, unsigned int depth)
+{
+    if (pos == end)
+        syntaxError(pos, end, "unexpected end of text");
+
+    switch (*pos)
+    {
+    case '{':
+    case '[':
+    {
+        if (depth == JSON_TAPE_MAX_DEPTH)
+            syntaxError(pos, end, "nesting too deep");
+
+        bool object = *pos == '{';
+        char closing = object ? '}' : ']';
+
+        size_t index = nodes_.size();
+        nodes_.push_back({pos, 0, 0, object ? Type::OBJECT : Type::ARRAY, false});
+
+        const char* begin = pos;
+        pos = skipWhitespace(pos+1, end);
+
+        if (pos != end && *pos == closing)
+            ++pos;
+        else
+        {
+            while (true)
+            {
+                if (object)
+                {
+                    if (pos == end || *pos != '"')
+                        syntaxError(pos, end, "expected member key");
+
+                    Node key;
+                    pos = parseString(pos, end, key);
+
+                    key.end = nodes_.size()+1;
+                    nodes_.push_back(key);
+
+                    pos = skipWhitespace(pos, end);
+
+                    if (pos == end || *pos != ':')
+                        syntaxError(pos, end, "expected ':'");
+
+                    pos = skipWhitespace(pos+1, end);
+                }
+
+                pos = parseValue(pos, end, depth+1);
+                pos = skipWhitespace(pos, end);
+
+                if (pos == end)
+                    syntaxError(pos, end, "unexpected end of text in container");
+
+                if (*pos == ',')
+                {
+                    pos = skipWhitespace(pos+1, end);
+                    continue;
+                }
+
+                if (*pos != closing)
+                    syntaxError(pos, end, object ? "expected ',' or '}'" : "expected ',' or ']'");
+
+                ++pos;
+                break;
+            }
+        }
+
+        Node& container = nodes_[index];
+        container.size = pos-begin;
+        container.end = nodes_.size();
+
+        return pos;
+    }
+    default:
+    {
+        Node value;
+        pos = parseScalar(pos, end, value);
+
+        value.end = nodes_.size()+1;
+        nodes_.push_back(value);
+
+        return pos;
+    }
+    }
+}
+
+const char* JSONTape::parseScalar (const char* pos, const char* end, Node& value)
+{
+    if (pos == end)
+        syntaxError(pos, end, "unexpected end of text");
+
+    switch (*pos)
+    {
+    case '"':
+        return parseString(pos, end, value);
+    case 't':
+        return parseLiteral(pos, end, "true", Type::TRUE_VALUE, value);
+    case 'f':
+        return parseLiteral(pos, end, "false", Type::FALSE_VALUE, value);
+    case 'n':
+        return parseLiteral(pos, end, "null", Type::NULL_VALUE, value);
+    default:
+        return parseNumber(pos, end, value);
+    }
+}
+
+const char* JSONTape::parseString (const char* pos, const char* end, Node& value)
+{
+    assert (pos != end && *pos == '"');
+
+    const char* begin = ++pos;
+    bool escaped = false;
+
+    while (true)
+    {
+        pos = JSONScan::findStringSpecial(pos, end);
+
+        if (pos == end)
+            syntaxError(pos, end, "unterminated string");
+
+        if (*pos == '"')
+            break;
+
+        if (*pos != '\\')
+            syntaxError(pos, end, "control character in string");
+
+        escaped = true;
+
+        if (++pos == end)
+            syntaxError(pos, end, "unterminated string");
+
+        switch (*pos)
+        {
+        case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+            ++pos;
+            break;
+        case 'u':
+        {
+            long code_unit = readCodeUnit(pos+1, end);
+
+            if (code_unit < 0)
+                syntaxError(pos, end, "invalid unicode escape");
+
+            pos += 5;
+
+            // surrogates only as pair, as in nlohmann::json
+            if (code_unit >= 0xDC00 && code_unit <= 0xDFFF)
+                syntaxError(pos, end, "invalid unicode surrogate");
+
+            if (code_unit >= 0xD800 && code_unit <= 0xDBFF)
+            {
+                if (end-pos < 6 || pos[0] != '\\' || pos[1] != 'u')
+                    syntaxError(pos, end, "invalid unicode surrogate");
+
+                long low = readCodeUnit(pos+2, end);
+
+                if (low < 0xDC00 || low > 0xDFFF)
+                    syntaxError(pos, end, "invalid unicode surrogate");
+
+                pos += 6;
+            }
+            break;
+        }
+        default:
+            syntaxError(pos, end, "invalid escape");
+        }
+    }
+
+    value = {begin, static_cast<size_t>(pos-begin), 0, Type::STRING, escaped};
+
+    return pos+1;
+}
+
+const char* JSONTape::parseNumber (const char* pos, const char* end, Node& value)
+{
+    const char* begin = pos;
+    bool fractional = false;
+
+    if (pos != end && *pos == '-')
+        ++pos;
+
+    if (pos == end || !isDigit(*pos))
+        syntaxError(pos, end, "invalid value");
+
+    if (*pos == '0')
+        ++pos;
+    else
+    {
+        while (pos != end && isDigit(*pos))
+            ++pos;
+    }
+
+    if (pos != end && *pos == '.')
+    {
+        fractional = true;
+        ++pos;
+
+        if (pos == end || !isDigit(*pos))
+            syntaxError(pos, end, "invalid number fraction");
+
+        while (pos != end && isDigit(*pos))
+            ++pos;
+    }
+
+    if (pos != end && (*pos == 'e' || *pos == 'E'))
+    {
+        fractional = true;
+        ++pos;
+
+        if (pos != end && (*pos == '+' || *pos == '-'))
+            ++pos;
+
+        if (pos == end || !isDigit(*pos))
+            syntaxError(pos, end, "invalid number exponent");
+
+        while (pos != end && isDigit(*pos))
+            ++pos;
+    }
+
+    value = {begin, static_cast<size_t>(pos-begin), 0, Type::NUMBER, fractional};
+
+    return pos;
+}
+
+const char* JSONTape::parseLiteral (const char* pos, const char* end, const char* literal, Type type,
+                                    Node& value)
+{
+    size_t size = std::strlen(literal);
+
+    if (static_cast<size_t>(end-pos) < size || std::memcmp(pos, literal, size) != 0)
+        syntaxError(pos, end, "invalid literal");
+
+    value = {pos, size, 0, type, false};
+
+    return pos+size;
+}
+
+void JSONTape::syntaxError (const char* pos, const char* end, const std::string& message)
+{
+    std::string context (pos, std::min<size_t>(end-pos, 20));
+
+    throw Error ("JSONTape: parse: "+message+" before '"+context+"'");
+}
+
+size_t JSONTape::find (size_t object, const std::string& key) const
+{
+    if (nodes_[object].type != Type::OBJECT)
+        return npos;
+
+    size_t end = nodes_[object].end;
+    size_t index = object+1;
+    size_t value = npos;
+
+    while (index != end) // all members checked, the last of duplicate keys is found as in nlohmann::json
+    {
+        const Node& key_node = nodes_[index];
+
+        if (key_node.size == key.size() && !key_node.flag && std::memcmp(key_node.text, key.data(), key.size()) == 0)
+            value = index+1;
+        else if (key_node.flag && getString(key_node) == key) // escaped key
+            value = index+1;
+
+        index = nodes_[index+1].end; // skip value
+    }
+
+    return value;
+}
+
+bool JSONTape::equals (const Node& value, const std::string& text)
+{
+    if (value.type != Type::STRING)
+        return false;
+
+    if (value.flag)
+        return getString(value) == text;
+
+    return value.size == text.size() && std::memcmp(value.text, text.data(), text.size()) == 0;
+}
+
+bool JSONTape::getBool (const Node& value)
+{
+    if (value.type == Type::TRUE_VALUE)
+        return true;
+    if (value.type == Type::FALSE_VALUE)
+        return false;
+
+    throw Error ("JSONTape: getBool: value '"+std::string(value.text, value.size)+"' is not a boolean");
+}
+
+std::string JSONTape::getString (const Node& value)
+{
+    if (value.type != Type::STRING)
+        throw Error ("JSONTape: getString: value '"+std::string(value.text, value.size)+"' is not a string");
+
+    if (!value.flag)
+        return std::string (value.text, value.size);
+
+    std::string text;
+    text.reserve(value.size);
+
+    const char* pos = value.text;
+    const char* end = value.text+value.size;
+
+    while (pos != end)
+    {
+        if (*pos != '\\')
+        {
+            text += *pos++;
+            continue;
+        }
+
+        ++pos; // escape checked when parsing
+
+        switch (*pos++)
+        {
+        case '"': text += '"'; break;
+        case '\\': text += '\\'; break;
+        case '/': text += '/'; break;
+        case 'b': text += '\b'; break;
+        case 'f': text += '\f'; break;
+        case 'n': text += '\n'; break;
+        case 'r': text += '\r'; break;
+        case 't': text += '\t'; break;
+        case 'u':
+        {
+            unsigned long code_point = readCodeUnit(pos, end);
+            pos += 4;
+
+            // combine surrogate pair, checked when parsing
+            if (code_point >= 0xD800 && code_point <= 0xDBFF)
+            {
+                long low = readCodeUnit(pos+2, end);
+                code_point = 0x10000 + ((code_point-0xD800) << 10) + (low-0xDC00);
+                pos += 6;
+            }
+
+            appendUTF8(text, code_point);
+            break;
+        }
+        default:
+            assert (false);
+        }
+    }
+
+    return text;
+}
+
+std::string JSONTape::toString (const Node& value)
+{
+    if (value.type == Type::STRING)
+        return getString(value);
+
+    return std::string (value.text, value.size);
+}
+
+double JSONTape::parseDouble (const Node& value)
+{
+    // copy for terminating zero and locale dependent decimal point, as nlohmann::json
+    char buffer[64];
+    std::string long_buffer;
+    char* text = buffer;
+
+    if (value.size >= sizeof(buffer))
+    {
+        long_buffer.assign(value.text, value.size);
+        text = &long_buffer[0];
+    }
+    else
+    {
+        std::memcpy(buffer, value.text, value.size);
+        buffer[value.size] = '\0';
+    }
+
+    char decimal_point = std::localeconv()->decimal_point[0];
+
+    if (decimal_point != '.')
+    {
+        char* point = std::strchr(text, '.');
+
+        if (point)
+            *point = decimal_point;
+    }
+
+    return std::strtod(text, nullptr);
+}
+
+bool JSONTape::parseInteger (const Node& value, int64_t& result)
+{
+    assert (value.size && *value.text == '-');
+
+    const int64_t minimum = std::numeric_limits<int64_t>::min();
+    result = 0;
+
+    for (const char* pos = value.text+1; pos != value.text+value.size; ++pos)
+    {
+        int digit = *pos-'0';
+
+        if (result < (minimum+digit)/10) // result*10-digit < minimum
+            return false;
+
+        result = result*10 - digit;
+    }
+
+    return true;
+}
+
+bool JSONTape::parseUnsigned (const Node& value, uint64_t& result)
+{
+    const uint64_t maximum = std::numeric_limits<uint64_t>::max();
+    result = 0;
+
+    for (const char* pos = value.text; pos != value.text+value.size; ++pos)
+    {
+        unsigned int digit = *pos-'0';
+
+        if (result > (maximum-digit)/10) // result*10+digit > maximum
+            return false;
+
+        result = result*10 + digit;
+    }
+
+    return true;
+}
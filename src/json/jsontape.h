@@ -0,0 +1,220 @@
+/*
+ * This file is part of ATSDB.
+ *
+ * ATSDB is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ATSDB is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSONTAPE_H
+#define JSONTAPE_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Flat parse result of JSON texts, as lightweight alternative to the nlohmann::json DOM
+ *
+ * Parsing appends one node per value to a single vector, in document order, so no allocation per value is done.
+ * Object members are stored as key node followed by value node. Container nodes store the index after their last
+ * descendant, so lookups and iteration skip nested values. Several texts (documents) can be parsed into one tape,
+ * each given by its root node.
+ *
+ * Nodes reference the parsed text, which must outlive the tape. Numbers are converted on access, strings are
+ * unescaped on access only if they contain escapes.
+ */
+class JSONTape
+{
+public:
+    enum class Type : unsigned char { NULL_VALUE, FALSE_VALUE, TRUE_VALUE, NUMBER, STRING, ARRAY, OBJECT };
+
+    /// @brief Exception for syntax errors and invalid conversions
+    class Error : public std::runtime_error
+    {
+    public:
+        Error (const std::string& message) : std::runtime_error (message) {}
+    };
+
+    struct Node
+    {
+        /// Text of value, for strings without quotes
+        const char* text;
+        size_t size;
+        /// Index after last descendant, index+1 for non-containers
+        size_t end;
+        Type type;
+        /// For strings: flag indicating if text contains escapes, for numbers: if fraction or exponent exist
+        bool flag;
+    };
+
+    static const size_t npos = static_cast<size_t> (-1);
+
+    /// @brief Constructor
+    JSONTape () {}
+
+    /// @brief Reserves space for nodes, e.g. estimated from text size
+    void reserve (size_t num_nodes) { nodes_.reserve(num_nodes); }
+
+    /**
+     * @brief Parses text [begin, end) containing one JSON value as new document, returns index of root node
+     *
+     * Throws Error on syntax errors, in which case the tape is unchanged.
+     */
+    size_t parse (const char* begin, const char* end);
+
+    /// @brief Returns number of parsed documents
+    size_t numDocuments () const { return roots_.size(); }
+    /// @brief Returns index of root node of document
+    size_t root (size_t document) const { return roots_.at(document); }
+
+    size_t size () const { return nodes_.size(); }
+    const Node& node (size_t index) const { return nodes_[index]; }
+    Type type (size_t index) const { return nodes_[index].type; }
+
+    bool isNull (size_t index) const { return nodes_[index].type == Type::NULL_VALUE; }
+    bool isBool (size_t index) const
+    { return nodes_[index].type == Type::FALSE_VALUE || nodes_[index].type == Type::TRUE_VALUE; }
+    bool isNumber (size_t index) const { return nodes_[index].type == Type::NUMBER; }
+    bool isString (size_t index) const { return nodes_[index].type == Type::STRING; }
+    bool isArray (size_t index) const { return nodes_[index].type == Type::ARRAY; }
+    bool isObject (size_t index) const { return nodes_[index].type == Type::OBJECT; }
+
+    /// @brief Returns index of value of last member with key in object node, or npos if not found or not an object
+    size_t find (size_t object, const std::string& key) const;
+
+    /// @brief Returns index of first element of array, or of first key of object
+    size_t begin (size_t container) const { return container+1; }
+    /// @brief Returns index after last element of array or last member of object
+    size_t end (size_t container) const { return nodes_[container].end; }
+    /// @brief Returns index of next array element, or of key of next object member if given a member value
+    size_t next (size_t index) const { return nodes_[index].end; }
+
+    /// @brief Returns flag indicating if string node equals value, false for other types
+    bool equals (size_t index, const std::string& value) const { return equals(nodes_[index], value); }
+
+    /// @brief Returns boolean value, throws Error for other types
+    bool getBool (size_t index) const { return getBool(nodes_[index]); }
+    /**
+     * @brief Returns number (or boolean) value converted to T as static_cast, throws Error for other types
+     *
+     * Integers are converted exactly, only integers exceeding 64 bits are converted through double. Throws Error if
+     * a number with fraction, exponent or such size is out of range of integer type T.
+     */
+    template <typename T>
+    T getNumber (size_t index) const { return getNumber<T>(nodes_[index]); }
+    /// @brief Returns unescaped string value, throws Error for other types
+    std::string getString (size_t index) const { return getString(nodes_[index]); }
+    /// @brief Returns string value or the JSON text of other types, as Utils::JSON::toString
+    std::string toString (size_t index) const { return toString(nodes_[index]); }
+
+    /// @brief Conversions of a node, which does not have to be part of a tape
+    static bool equals (const Node& value, const std::string& text);
+    static bool getBool (const Node& value);
+    template <typename T>
+    static T getNumber (const Node& value)
+    {
+        if (value.type == Type::NUMBER)
+        {
+            if (!value.flag) // no fraction or exponent
+            {
+                if (*value.text == '-')
+                {
+                    int64_t integer;
+
+                    if (parseInteger(value, integer))
+                        return static_cast<T> (integer);
+                }
+                else
+                {
+                    uint64_t integer;
+
+                    if (parseUnsigned(value, integer))
+                        return static_cast<T> (integer);
+                }
+            }
+
+            // fraction, exponent or integer overflow
+            return convertDouble<T> (value, parseDouble(value),
+                                     std::integral_constant<bool, std::is_integral<T>::value
+                                                                  && !std::is_same<T, bool>::value>());
+        }
+
+        if (value.type == Type::TRUE_VALUE || value.type == Type::FALSE_VALUE)
+            return static_cast<T> (value.type == Type::TRUE_VALUE);
+
+        throw Error ("JSONTape: getNumber: value '"+std::string(value.text, value.size)+"' is not a number");
+    }
+    static std::string getString (const Node& value);
+    static std::string toString (const Node& value);
+
+    /**
+     * @brief Parses string, number or literal at pos into value, returns position after it
+     *
+     * Throws Error on syntax errors. The end index of the node is not set. Used to parse single values without
+     * a tape.
+     */
+    static const char* parseScalar (const char* pos, const char* end, Node& value);
+
+    /// @brief Throws Error with message and text at pos
+    [[noreturn]] static void syntaxError (const char* pos, const char* end, const std::string& message);
+
+protected:
+    std::vector<Node> nodes_;
+    std::vector<size_t> roots_;
+
+    const char* parseValue (const char* pos, const char* end, unsigned int depth);
+
+    static const char* parseString (const char* pos, const char* end, Node& value);
+    static const char* parseNumber (const char* pos, const char* end, Node& value);
+    static const char* parseLiteral (const char* pos, const char* end, const char* literal, Type type, Node& value);
+
+    static double parseDouble (const Node& value);
+    /// @brief Parses negative integer into result, returns false on overflow
+    static bool parseInteger (const Node& value, int64_t& result);
+    /// @brief Parses non-negative integer into result, returns false on overflow
+    static bool parseUnsigned (const Node& value, uint64_t& result);
+
+    template <typename T>
+    static T convertDouble (const Node&, double number, std::false_type)
+    {
+        return static_cast<T> (number);
+    }
+    /// @brief Converts to integer type T, throws Error if out of range, since the cast is undefined then
+    template <typename T>
+    static T convertDouble (const Node& value, double number, std::true_type)
+    {
+        double truncated = std::trunc(number);
+
+        // minimum and maximum+1 are 0 or powers of 2, so exact as double
+        double minimum = static_cast<double> (std::numeric_limits<T>::min());
+        double maximum_end = 2.0*static_cast<double> (std::numeric_limits<T>::max()/2+1);
+
+        if (!(truncated >= minimum && truncated < maximum_end)) // also for infinity
+            throw Error ("JSONTape: getNumber: value '"+std::string(value.text, value.size)+"' is out of range");
+
+        return static_cast<T> (number);
+    }
+};
+
+/// @brief Reference to a value in a JSONTape, e.g. a target report object
+struct JSONTapeValue
+{
+    const JSONTape& tape;
+    size_t index;
+};
+
+#endif // JSONTAPE_H
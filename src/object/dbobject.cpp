@@ -27,12 +27,12 @@
 #include "dbobjectmanager.h"
 #include "dbovariable.h"
 #include "buffer.h"
+#include "columnstatistics.h"
 #include "filtermanager.h"
 //#include "StructureDescriptionManager.h"
 #include "propertylist.h"
 #include "metadbtable.h"
 #include "dboreaddbjob.h"
-#include "finalizedboreadjob.h"
 #include "atsdb.h"
 #include "dbinterface.h"
 #include "jobmanager.h"
@@ -296,6 +296,21 @@ const DBODataSourceDefinition& DBObject::currentDataSourceDefinition () const
     return data_source_definitions_.at(ATSDB::instance().schemaManager().getCurrentSchema().name());
 }
 
+std::set<int> DBObject::dataSourceKeys (Buffer& buffer)
+{
+    std::set<int> keys;
+
+    if (!hasCurrentDataSourceDefinition() || !hasVariable(currentDataSourceDefinition().localKey()))
+        return keys;
+
+    const std::string& key_column = variable(currentDataSourceDefinition().localKey()).currentDBColumn().name();
+
+    if (buffer.has<int>(key_column))
+        ColumnStatistics::distinctValues(buffer.column(buffer.properties().get(key_column)), 0, buffer.size(), keys);
+
+    return keys;
+}
+
 void DBObject::deleteDataSourceDefinition (const std::string& schema)
 {
     assert (data_source_definitions_.count(schema) == 1);
@@ -729,8 +744,6 @@ std::string DBObject::status ()
                 return "Queued";
         }
     }
-    else if (finalize_jobs_.size() > 0)
-        return "Post-processing";
     else
         return "Idle";
 
@@ -842,11 +855,6 @@ void DBObject::load (DBOVariableSet& read_set, bool use_filters, bool use_order,
         JobManager::instance().cancelJob(read_job_);
         read_job_ = nullptr;
     }
-    read_job_data_.clear();
-
-    for (auto job_it : finalize_jobs_)
-        JobManager::instance().cancelJob(job_it);
-    finalize_jobs_.clear();
 
     clearData ();
 
@@ -861,6 +869,16 @@ void DBObject::load (DBOVariableSet& read_set, bool use_filters, bool use_order,
     for (auto& var_it : filtered_variables)
         assert (var_it->existsInDB());
 
+    filtering_loaded_data_ = false;
+
+    loaded_data_ = nullptr;
+    loaded_read_set_ = read_set;
+    loaded_use_order_ = use_order;
+    loaded_order_variable_ = order_variable;
+    loaded_use_order_ascending_ = use_order_ascending;
+    loaded_limit_str_ = limit_str;
+    loaded_predicate_ = use_filters ? ATSDB::instance().filterManager().getBufferPredicate (name_) : BufferPredicate();
+
     //    DBInterface &db_interface, DBObject &dbobject, DBOVariableSet read_list, std::string custom_filter_clause,
     //    DBOVariable *order, const std::string &limit_str
 
@@ -869,8 +887,7 @@ void DBObject::load (DBOVariableSet& read_set, bool use_filters, bool use_order,
                                                                  filtered_variables, use_order, order_variable,
                                                                  use_order_ascending, limit_str));
 
-    connect (read_job_.get(), SIGNAL(intermediateSignal(std::shared_ptr<Buffer>)),
-             this, SLOT(readJobIntermediateSlot(std::shared_ptr<Buffer>)), Qt::QueuedConnection);
+    connect (read_job_.get(), SIGNAL(progressSignal()), this, SLOT(readJobProgressSlot()), Qt::QueuedConnection);
     connect (read_job_.get(), SIGNAL(obsoleteSignal()), this, SLOT(readJobObsoleteSlot()), Qt::QueuedConnection);
     connect (read_job_.get(), SIGNAL(doneSignal()), this, SLOT(readJobDoneSlot()), Qt::QueuedConnection);
 
@@ -880,11 +897,60 @@ void DBObject::load (DBOVariableSet& read_set, bool use_filters, bool use_order,
     JobManager::instance().addDBJob(read_job_);
 }
 
+bool DBObject::filterLoadedData (DBOVariableSet& read_set, bool use_filters, bool use_order,
+                                 DBOVariable* order_variable, bool use_order_ascending, const std::string &limit_str)
+{
+    if (!loaded_data_ || read_job_)
+        return false;
+
+    // limits select rows by position in the full result
+    if (limit_str.size() || loaded_limit_str_.size())
+        return false;
+
+    if (use_order != loaded_use_order_ || (use_order && (order_variable != loaded_order_variable_
+                                                         || use_order_ascending != loaded_use_order_ascending_)))
+        return false;
+
+    for (auto& var_it : read_set.getSet())
+        if (!loaded_read_set_.hasVariable(*var_it))
+            return false;
+
+    BufferPredicate predicate;
+
+    if (use_filters)
+        predicate = ATSDB::instance().filterManager().getBufferPredicate (name_);
+
+    if (!predicate.narrows(loaded_predicate_) || !predicate.canEvaluate(*loaded_data_))
+    {
+        loginf << "DBObject: " << name_ << " filterLoadedData: filters not applicable to loaded data";
+        return false;
+    }
+
+    boost::posix_time::ptime start_time = boost::posix_time::microsec_clock::local_time();
+
+    data_ = loaded_data_->select(predicate.evaluate(*loaded_data_));
+
+    boost::posix_time::time_duration diff = boost::posix_time::microsec_clock::local_time() - start_time;
+
+    loginf << "DBObject: " << name_ << " filterLoadedData: selected " << data_->size() << " of "
+           << loaded_data_->size() << " rows in " << diff.total_milliseconds() << " ms";
+
+    filtering_loaded_data_ = true;
+
+    if (info_widget_)
+        info_widget_->updateSlot();
+
+    // signalled after return, as for loading jobs
+    QMetaObject::invokeMethod(this, "filterLoadedDataDoneSlot", Qt::QueuedConnection);
+
+    return true;
+}
+
 void DBObject::quitLoading ()
 {
     if (read_job_)
     {
-        read_job_->setObsolete();
+        JobManager::instance().cancelJob(read_job_);
     }
 }
 
@@ -900,6 +966,8 @@ void DBObject::insertData (DBOVariableSet& list, std::shared_ptr<Buffer> buffer,
 
     assert (!insert_job_);
 
+    loaded_data_ = nullptr; // content changes
+
     buffer->transformVariables(list, false); // back again
 
     insert_job_ = std::shared_ptr<InsertBufferDBJob> (new InsertBufferDBJob(ATSDB::instance().interface(),
@@ -909,7 +977,7 @@ void DBObject::insertData (DBOVariableSet& list, std::shared_ptr<Buffer> buffer,
     connect (insert_job_.get(), &InsertBufferDBJob::insertProgressSignal, this, &DBObject::insertProgressSlot,
              Qt::QueuedConnection);
 
-    JobManager::instance().addDBJob(insert_job_);
+    JobManager::instance().addDBJob(insert_job_, JobPriority::LOAD);
 
     logdbg << "DBObject: insertData: end";
 }
@@ -939,6 +1007,8 @@ void DBObject::updateData (DBOVariable &key_var, DBOVariableSet& list, std::shar
     assert (key_var.existsInDB());
     assert (ATSDB::instance().interface().checkUpdateBuffer(*this, key_var, list, buffer));
 
+    loaded_data_ = nullptr; // content changes, buffer might be loaded data
+
     buffer->transformVariables(list, false); // back again
 
     update_job_ = std::shared_ptr<UpdateBufferDBJob> (new UpdateBufferDBJob(ATSDB::instance().interface(),
@@ -948,7 +1018,7 @@ void DBObject::updateData (DBOVariable &key_var, DBOVariableSet& list, std::shar
     connect (update_job_.get(), &UpdateBufferDBJob::updateProgressSignal, this, &DBObject::updateProgressSlot,
              Qt::QueuedConnection);
 
-    JobManager::instance().addDBJob(update_job_);
+    JobManager::instance().addDBJob(update_job_, JobPriority::POSTPROCESSING);
 }
 
 void DBObject::updateProgressSlot (float percent)
@@ -999,9 +1069,11 @@ std::map<int, std::string> DBObject::loadLabelData (std::vector<int> rec_nums, i
 
     DBInterface& db_interface = ATSDB::instance().interface ();
 
-    db_interface.prepareRead (*this, read_list, custom_filter_clause, {}, false, nullptr, false, "");
-    std::shared_ptr<Buffer> buffer = db_interface.readDataChunk(*this);
-    db_interface.finalizeReadStatement(*this);
+    DBConnection* connection = db_interface.prepareRead (*this, read_list, custom_filter_clause, {}, false, nullptr,
+                                                         false, "");
+    // one more than expected, to detect surplus rows
+    std::shared_ptr<Buffer> buffer = db_interface.readDataChunk(connection, *this, rec_nums.size()+1);
+    db_interface.finalizeReadStatement(connection, *this);
 
     if (buffer->size() != rec_nums.size())
         throw std::runtime_error ("DBObject "+name_+": loadLabelData: failed to load label for "+custom_filter_clause);
@@ -1020,53 +1092,23 @@ std::map<int, std::string> DBObject::loadLabelData (std::vector<int> rec_nums, i
     return labels;
 }
 
-void DBObject::readJobIntermediateSlot (std::shared_ptr<Buffer> buffer)
+void DBObject::readJobProgressSlot ()
 {
-    assert (buffer);
-    logdbg << "DBObject: " << name_ << " readJobIntermediateSlot: buffer size " << buffer->size();
-
-    DBOReadDBJob* sender = dynamic_cast <DBOReadDBJob*> (QObject::sender());
-
-    if (!sender)
-    {
-        logwrn << "DBObject: readJobIntermediateSlot: null sender, event on the loose";
+    if (QObject::sender() != read_job_.get()) // from cancelled job
         return;
-    }
-    assert (sender == read_job_.get());
-
-    std::vector <DBOVariable*>& variables = sender->readList().getSet ();
-    const PropertyList &properties = buffer->properties();
-
-    for (auto var_it : variables)
-    {
-        const DBTableColumn &column = var_it->currentDBColumn ();
-        assert (properties.hasProperty(column.name()));
-        const Property &property = properties.get(column.name());
-        assert (property.dataType() == var_it->dataType());
-    }
-
-    logdbg << "DBObject: " << name_ << " readJobIntermediateSlot: got buffer with size " << buffer->size();
 
-    read_job_data_.push_back(buffer);
-
-    FinalizeDBOReadJob* job = new FinalizeDBOReadJob (*this, sender->readList(), buffer);
-
-    std::shared_ptr<FinalizeDBOReadJob> job_ptr = std::shared_ptr<FinalizeDBOReadJob> (job);
-    connect (job, SIGNAL(doneSignal()), this, SLOT(finalizeReadJobDoneSlot()), Qt::QueuedConnection);
-    finalize_jobs_.push_back(job_ptr);
-
-    JobManager::instance().addJob(job_ptr);
+    logdbg << "DBObject: " << name_ << " readJobProgressSlot: loaded " << read_job_->rowCount();
 
     if (info_widget_)
         info_widget_->updateSlot();
 
+    emit loadingProgressSignal(*this);
 }
 
 void DBObject::readJobObsoleteSlot ()
 {
     logdbg << "DBObject: " << name_ << " readJobObsoleteSlot";
     read_job_ = nullptr;
-    read_job_data_.clear();
 
     if (info_widget_)
         info_widget_->updateSlot();
@@ -1077,68 +1119,78 @@ void DBObject::readJobObsoleteSlot ()
 void DBObject::readJobDoneSlot()
 {
     loginf << "DBObject: " << name_ << " readJobDoneSlot";
-    read_job_ = nullptr;
 
-    if (info_widget_)
-        info_widget_->updateSlot();
+    DBOReadDBJob* sender = dynamic_cast <DBOReadDBJob*> (QObject::sender());
 
-    if (!isLoading())
+    if (!sender)
     {
-        loginf << "DBObject: " << name_ << " readJobDoneSlot: no jobs left, done";
-        emit loadingDoneSignal(*this);
+        logwrn << "DBObject: readJobDoneSlot: null sender, event on the loose";
+        return;
     }
-}
-
-void DBObject::finalizeReadJobDoneSlot()
-{
-    logdbg << "DBObject: " << name_ << " finalizeReadJobDoneSlot";
 
-    FinalizeDBOReadJob* sender = dynamic_cast <FinalizeDBOReadJob*> (QObject::sender());
-
-    if (!sender)
+    if (sender != read_job_.get()) // cancelled job, already replaced or reset
     {
-        logwrn << "DBObject: finalizeReadJobDoneSlot: null sender, event on the loose";
+        logdbg << "DBObject: " << name_ << " readJobDoneSlot: ignoring cancelled job";
         return;
     }
 
-    std::shared_ptr<Buffer> buffer = sender->buffer();
+    std::shared_ptr<Buffer> buffer = read_job_->buffer();
 
-    bool found=false;
-    for (auto final_it : finalize_jobs_)
+    if (buffer)
     {
-        if (final_it.get() == sender)
+        std::vector <DBOVariable*>& variables = read_job_->readList().getSet ();
+        const PropertyList &properties = buffer->properties();
+
+        for (auto var_it : variables)
         {
-            finalize_jobs_.erase(std::find(finalize_jobs_.begin(), finalize_jobs_.end(), final_it));
-            found=true;
-            break;
+            const DBTableColumn &column = var_it->currentDBColumn ();
+            assert (properties.hasProperty(column.name()));
+            const Property &property = properties.get(column.name());
+            assert (property.dataType() == var_it->dataType());
         }
-    }
-    assert (found);
 
-    if (!data_)
+        logdbg << "DBObject: " << name_ << " readJobDoneSlot: got buffer with size " << buffer->size();
+
         data_ = buffer;
-    else
-        data_->seizeBuffer (*buffer.get());
+        loaded_data_ = buffer;
+    }
 
-    logdbg << "DBObject: " << name_ << " finalizeReadJobDoneSlot: got buffer with size " << data_->size();
+    read_job_ = nullptr;
 
     if (info_widget_)
         info_widget_->updateSlot();
 
-    emit newDataSignal(*this);
+    if (data_)
+        emit newDataSignal(*this);
 
-    if (!isLoading())
-    {
-        loginf << "DBObject: " << name_ << " finalizeReadJobDoneSlot: no jobs left, done";
-        emit loadingDoneSignal(*this);
-    }
+    loginf << "DBObject: " << name_ << " readJobDoneSlot: done";
+    emit loadingDoneSignal(*this);
 }
 
+void DBObject::filterLoadedDataDoneSlot ()
+{
+    if (!filtering_loaded_data_) // replaced by loading
+        return;
+
+    loginf << "DBObject: " << name_ << " filterLoadedDataDoneSlot";
+
+    filtering_loaded_data_ = false;
+
+    if (info_widget_)
+        info_widget_->updateSlot();
+
+    if (data_)
+        emit newDataSignal(*this);
+
+    emit loadingDoneSignal(*this);
+}
 
 void DBObject::databaseContentChangedSlot ()
 {
     logdbg << "DBObject: databaseContentChangedSlot";
 
+    loaded_data_ = nullptr;
+
     if (!current_meta_table_)
     {
         logdbg << "DBObject: databaseContentChangedSlot: object " << name_ << " has no current meta table";
@@ -1169,7 +1221,7 @@ void DBObject::databaseContentChangedSlot ()
 
 bool DBObject::isLoading ()
 {
-    return read_job_ || finalize_jobs_.size();
+    return read_job_ != nullptr || filtering_loaded_data_;
 }
 
 bool DBObject::hasData ()
@@ -1184,7 +1236,9 @@ size_t DBObject::count ()
 
 size_t DBObject::loadedCount ()
 {
-    if (data_)
+    if (read_job_)
+        return read_job_->rowCount();
+    else if (data_)
         return data_->size();
     else
         return 0;
@@ -30,6 +30,7 @@
 #include "dboeditdatasourceactionoptions.h"
 #include "configurable.h"
 #include "dbovariable.h"
+#include "bufferpredicate.h"
 
 class PropertyList;
 class MetaDBTable;
@@ -72,7 +73,6 @@ class Job;
 class DBOReadDBJob;
 class InsertBufferDBJob;
 class UpdateBufferDBJob;
-class FinalizeDBOReadJob;
 class DBOVariableSet;
 class DBOLabelDefinition;
 class DBOLabelDefinitionWidget;
@@ -111,6 +111,8 @@ class DBObject : public QObject, public Configurable
     Q_OBJECT
 signals:
     void newDataSignal (DBObject& object);
+    /// @brief Emitted while loading, with loadedCount updated
+    void loadingProgressSignal (DBObject& object);
     void loadingDoneSignal (DBObject& object);
 
     void insertProgressSignal (float percent);
@@ -124,10 +126,10 @@ signals:
 public slots:
     void schemaChangedSlot ();
 
-    void readJobIntermediateSlot (std::shared_ptr<Buffer> buffer);
+    void readJobProgressSlot ();
     void readJobObsoleteSlot ();
     void readJobDoneSlot();
-    void finalizeReadJobDoneSlot();
+    void filterLoadedDataDoneSlot ();
 
     void insertProgressSlot (float percent);
     void insertDoneSlot ();
@@ -179,6 +181,15 @@ public:
 
     void load (DBOVariableSet& read_set, bool use_filters, bool use_order, DBOVariable* order_variable,
                bool use_order_ascending, const std::string& limit_str="");
+    /**
+     * @brief Applies the current filters to the data of the last load in memory, without reading from the database
+     *
+     * Only possible if the filters narrow the ones used for loading, the read set is contained in the loaded one and
+     * order and limit are unchanged. Returns false if loading is required. The data is signalled asynchronously,
+     * as after loading.
+     */
+    bool filterLoadedData (DBOVariableSet& read_set, bool use_filters, bool use_order, DBOVariable* order_variable,
+                           bool use_order_ascending, const std::string& limit_str="");
     void quitLoading ();
     void clearData ();
 
@@ -214,6 +225,8 @@ public:
     bool hasCurrentDataSourceDefinition () const;
     /// @brief Returns current data source definition
     const DBODataSourceDefinition& currentDataSourceDefinition () const;
+    /// @brief Returns distinct data source keys in buffer, empty if buffer does not contain the local key column
+    std::set<int> dataSourceKeys (Buffer& buffer);
     bool hasDataSourceDefinition (const std::string& schema) { return data_source_definitions_.count(schema); }
     void deleteDataSourceDefinition (const std::string& schema);
     /// @brief Returns container with all data source definitions
@@ -291,14 +304,24 @@ protected:
     std::unique_ptr<DBOLabelDefinition> label_definition_;
 
     std::shared_ptr <DBOReadDBJob> read_job_ {nullptr};
-    std::vector <std::shared_ptr<Buffer>> read_job_data_;
-    std::vector <std::shared_ptr <FinalizeDBOReadJob>> finalize_jobs_;
 
     std::shared_ptr <InsertBufferDBJob> insert_job_ {nullptr};
     std::shared_ptr <UpdateBufferDBJob> update_job_ {nullptr};
 
     std::shared_ptr<Buffer> data_;
 
+    /// Complete result of the last load, to which narrowing filters can be applied in memory
+    std::shared_ptr<Buffer> loaded_data_;
+    /// Parameters and filters of the last load
+    DBOVariableSet loaded_read_set_;
+    bool loaded_use_order_ {false};
+    DBOVariable* loaded_order_variable_ {nullptr};
+    bool loaded_use_order_ascending_ {false};
+    std::string loaded_limit_str_;
+    BufferPredicate loaded_predicate_;
+    /// Flag indicating that data filtered in memory has not been signalled yet
+    bool filtering_loaded_data_ {false};
+
     bool locked_ {false};
 
     /// Container with all DBOSchemaMetaTableDefinitions
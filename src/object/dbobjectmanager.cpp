@@ -381,7 +381,11 @@ void DBObjectManager::loadSlot ()
 
             // load (DBOVariableSet &read_set, bool use_filters, bool use_order, DBOVariable *order_variable,
             // bool use_order_ascending, const std::string &limit_str="")
-            object.second->load(read_set, use_filters_, use_order_, variable, use_order_ascending_, limit_str);
+            if (object.second->filterLoadedData(read_set, use_filters_, use_order_, variable, use_order_ascending_,
+                                                limit_str))
+                loginf << "DBObjectManager: loadSlot: filtered loaded data of object " << object.first;
+            else
+                object.second->load(read_set, use_filters_, use_order_, variable, use_order_ascending_, limit_str);
 
             load_job_created = true;
         }
@@ -16,6 +16,7 @@
  */
 
 #include <limits>
+#include <stdexcept>
 #include <boost/assign/list_of.hpp>
 
 #include "property.h"
@@ -57,6 +58,33 @@ const std::string &Property::asString (PropertyDataType type)
     return data_types_2_strings_.at(type);
 }
 
+unsigned int Property::sizeInBytes (PropertyDataType type)
+{
+    switch (type)
+    {
+        case PropertyDataType::BOOL:
+            return sizeof(bool);
+        case PropertyDataType::CHAR:
+        case PropertyDataType::UCHAR:
+            return sizeof(char);
+        case PropertyDataType::INT:
+        case PropertyDataType::UINT:
+            return sizeof(int);
+        case PropertyDataType::LONGINT:
+        case PropertyDataType::ULONGINT:
+            return sizeof(long int);
+        case PropertyDataType::FLOAT:
+            return sizeof(float);
+        case PropertyDataType::DOUBLE:
+            return sizeof(double);
+        case PropertyDataType::STRING:
+            return PROPERTY_STRING_SIZE_ESTIMATE;
+        default:
+            logerr << "Property: sizeInBytes: unknown property type " << Property::asString(type);
+            throw std::runtime_error ("Property: sizeInBytes: unknown property type "+Property::asString(type));
+    }
+}
+
 PropertyDataType &Property::asDataType (const std::string &type)
 {
     logdbg << "Property: asDataType: " << type;
@@ -24,6 +24,23 @@
 enum class PropertyDataType { BOOL, CHAR, UCHAR, INT, UINT, LONGINT, ULONGINT,
     FLOAT, DOUBLE, STRING }; // P_TYPE_POINTER and SENTINEL removed
 
+/// @brief Maps a C++ type to its PropertyDataType, undefined for unsupported types
+template <typename T> struct PropertyDataTypeOf;
+template <> struct PropertyDataTypeOf<bool> { static const PropertyDataType value = PropertyDataType::BOOL; };
+template <> struct PropertyDataTypeOf<char> { static const PropertyDataType value = PropertyDataType::CHAR; };
+template <> struct PropertyDataTypeOf<unsigned char> { static const PropertyDataType value = PropertyDataType::UCHAR; };
+template <> struct PropertyDataTypeOf<int> { static const PropertyDataType value = PropertyDataType::INT; };
+template <> struct PropertyDataTypeOf<unsigned int> { static const PropertyDataType value = PropertyDataType::UINT; };
+template <> struct PropertyDataTypeOf<long int> { static const PropertyDataType value = PropertyDataType::LONGINT; };
+template <> struct PropertyDataTypeOf<unsigned long int>
+{ static const PropertyDataType value = PropertyDataType::ULONGINT; };
+template <> struct PropertyDataTypeOf<float> { static const PropertyDataType value = PropertyDataType::FLOAT; };
+template <> struct PropertyDataTypeOf<double> { static const PropertyDataType value = PropertyDataType::DOUBLE; };
+template <> struct PropertyDataTypeOf<std::string> { static const PropertyDataType value = PropertyDataType::STRING; };
+
+/// Estimated average size of a string value in bytes
+const unsigned int PROPERTY_STRING_SIZE_ESTIMATE=16;
+
 /**
  * @brief Base class for a data item identifier
  *
@@ -49,6 +66,8 @@ public:
   const std::string &name() const { return name_; }
 
   static const std::string &asString (PropertyDataType type);
+  /// @brief Returns size of a value in bytes, estimated for strings
+  static unsigned int sizeInBytes (PropertyDataType type);
   static PropertyDataType &asDataType (const std::string &type);
 
   static const std::map<PropertyDataType,std::string> &dataTypes2Strings() {return data_types_2_strings_; }
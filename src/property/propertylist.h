@@ -215,6 +215,17 @@ public:
     {
         return properties_.size();
     }
+
+    /// @brief Returns estimated size of a row with all properties in bytes
+    unsigned int rowSizeInBytes () const
+    {
+        unsigned int row_size=0;
+
+        for (auto& it : properties_)
+            row_size += Property::sizeInBytes(it.dataType());
+
+        return row_size;
+    }
 };
 
 
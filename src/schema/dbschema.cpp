@@ -15,6 +15,8 @@
  * along with ATSDB.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
 #include "dbtablecolumn.h"
 #include "dbtable.h"
 #include "metadbtable.h"
@@ -127,6 +129,43 @@ void DBSchema::populateTable (const std::string& name)
     emit changedSignal();
 }
 
+std::vector <const DBTableColumn*> DBSchema::indexedColumns (const DBTable& table) const
+{
+    std::vector <const DBTableColumn*> columns;
+
+    for (auto& col_it : table.columns())
+        if (col_it.second->isIndexed() && !col_it.second->isKey()) // key is indexed by primary key
+            columns.push_back(col_it.second);
+
+    for (auto& meta_it : meta_tables_)
+    {
+        for (auto& sub_it : meta_it.second->subTableDefinitions())
+        {
+            std::string key_name;
+
+            if (meta_it.second->mainTableName() == table.name())
+                key_name = sub_it.second->mainTableKey();
+            else if (sub_it.second->subTableName() == table.name())
+                key_name = sub_it.second->subTableKey();
+            else
+                continue;
+
+            if (!table.hasColumn(key_name))
+            {
+                logwrn << "DBSchema: indexedColumns: table " << table.name() << " has no join key column " << key_name;
+                continue;
+            }
+
+            const DBTableColumn* column = &table.column(key_name);
+
+            if (!column->isKey() && std::find(columns.begin(), columns.end(), column) == columns.end())
+                columns.push_back(column);
+        }
+    }
+
+    return columns;
+}
+
 bool DBSchema::hasMetaTable (const std::string& name) const
 {
     return meta_tables_.find(name) != meta_tables_.end();
@@ -22,8 +22,10 @@
 
 #include <qobject.h>
 #include <cassert>
+#include <vector>
 
 class DBTable;
+class DBTableColumn;
 class MetaDBTable;
 class DBSchemaWidget;
 class DBInterface;
@@ -78,6 +80,9 @@ public:
 
     void populateTable (const std::string& name);
 
+    /// @brief Returns columns of table which need a secondary index: indexed columns and meta-table join keys
+    std::vector <const DBTableColumn*> indexedColumns (const DBTable& table) const;
+
     DBSchemaWidget* widget ();
 
     void lock ();
@@ -44,6 +44,8 @@ std::map<std::string, PropertyDataType> DBTableColumn::db_types_2_data_types_ {
         {"varchar", PropertyDataType::STRING}
 };
 
+std::set<std::string> DBTableColumn::default_indexed_names_ = {"ds_id", "tod", "rec_num"};
+
 DBTableColumn::DBTableColumn(const std::string &class_id, const std::string &instance_id, DBTable *table,
                              DBInterface& db_interface)
  : Configurable (class_id, instance_id, table), table_(*table), db_interface_(db_interface)
@@ -51,6 +53,7 @@ DBTableColumn::DBTableColumn(const std::string &class_id, const std::string &ins
   registerParameter ("name", &name_, "");
   registerParameter ("type", &type_, "");
   registerParameter ("is_key", &is_key_, false);
+  registerParameter ("is_indexed", &is_indexed_, default_indexed_names_.count(name_) > 0);
   registerParameter ("comment", &comment_, "");
   registerParameter ("dimension", &dimension_, "");
   registerParameter ("unit", &unit_, "");
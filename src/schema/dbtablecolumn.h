@@ -18,6 +18,7 @@
 #ifndef DBTABLECOLUMN_H_
 #define DBTABLECOLUMN_H_
 
+#include <set>
 #include <string>
 #include "configurable.h"
 #include "property.h"
@@ -61,6 +62,11 @@ public:
     /// @brief Returns key flag
     bool isKey () const { return is_key_; }
 
+    /// @brief Sets secondary index flag
+    void isIndexed (bool is_indexed) { is_indexed_=is_indexed; }
+    /// @brief Returns flag if a secondary index should exist for the column
+    bool isIndexed () const { return is_indexed_; }
+
     void comment (const std::string &comment) { comment_ = comment; }
     const std::string &comment () const { return comment_; }
 
@@ -98,6 +104,8 @@ protected:
     std::string type_;
     /// Key flag
     bool is_key_;
+    /// Secondary index flag
+    bool is_indexed_;
     /// Data type
     std::string comment_;
     /// Unit dimension
@@ -112,6 +120,8 @@ protected:
     UnitSelectionWidget* widget_ {nullptr};
 
     static std::map<std::string, PropertyDataType> db_types_2_data_types_;
+    /// Names of columns which are indexed by default, used in filters
+    static std::set<std::string> default_indexed_names_;
 
     bool exists_in_db_ {false};
 };
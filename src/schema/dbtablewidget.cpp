@@ -149,9 +149,13 @@ void DBTableWidget::updateColumnGrid ()
     key_label->setFont(font_bold);
     column_grid_->addWidget (key_label, 0,2);
 
+    QLabel* indexed_label = new QLabel ("Is indexed");
+    indexed_label->setFont(font_bold);
+    column_grid_->addWidget (indexed_label, 0,3);
+
     QLabel* unit_label = new QLabel ("Unit");
     unit_label->setFont(font_bold);
-    column_grid_->addWidget (unit_label, 0,3);
+    column_grid_->addWidget (unit_label, 0,4);
 
 //    QLabel *null_label = new QLabel ("Special null"); //TODO
 //    null_label->setFont(font_bold);
@@ -159,11 +163,11 @@ void DBTableWidget::updateColumnGrid ()
 
     QLabel* data_format_label = new QLabel ("Data Format");
     data_format_label->setFont(font_bold);
-    column_grid_->addWidget (data_format_label, 0,4);
+    column_grid_->addWidget (data_format_label, 0,5);
 
     QLabel* comment_label = new QLabel ("Comment");
     comment_label->setFont(font_bold);
-    column_grid_->addWidget (comment_label, 0,5);
+    column_grid_->addWidget (comment_label, 0,6);
 
 
     unsigned int row=1;
@@ -178,13 +182,16 @@ void DBTableWidget::updateColumnGrid ()
         QLabel* key = new QLabel (std::to_string((int)it.second->isKey()).c_str());
         column_grid_->addWidget (key, row, 2);
 
+        QLabel* indexed = new QLabel (std::to_string((int)it.second->isIndexed()).c_str());
+        column_grid_->addWidget (indexed, row, 3);
+
         UnitSelectionWidget* unit_widget = it.second->unitWidget();
-        column_grid_->addWidget (unit_widget, row, 3);
+        column_grid_->addWidget (unit_widget, row, 4);
         column_unit_selection_widgets_[unit_widget] = it.second;
 
         FormatSelectionWidget* data_format_widget = new FormatSelectionWidget (it.second->propertyType(),
                                                                                it.second->dataFormat());
-        column_grid_->addWidget (data_format_widget, row, 4);
+        column_grid_->addWidget (data_format_widget, row, 5);
 
 //        QLineEdit *edit = new QLineEdit (it.second->specialNull().c_str());
 //        connect (edit, SIGNAL(textChanged(const QString &)), this, SLOT (setSpecialNull(const QString &)));
@@ -193,7 +200,7 @@ void DBTableWidget::updateColumnGrid ()
 //        column_grid_special_nulls_ [edit] = it.second;
 
         QLabel *comment = new QLabel (it.second->comment().c_str());
-        column_grid_->addWidget (comment, row, 5);
+        column_grid_->addWidget (comment, row, 6);
 
         row++;
     }
@@ -28,11 +28,13 @@
 #include "metadbtable.h"
 #include "dbtable.h"
 #include "dbtablecolumn.h"
+#include "dbinterface.h"
 #include "propertylist.h"
 #include "buffer.h"
 #include "jobmanager.h"
 #include "jsonparsejob.h"
 #include "jsonmappingjob.h"
+#include "endbulkimportdbjob.h"
 
 #include <stdexcept>
 #include <fstream>
@@ -47,12 +49,18 @@
 using namespace Utils;
 using namespace nlohmann;
 
+/// Size of ranges of non-archive files read concurrently
+const size_t JSON_READ_RANGE_SIZE=1 << 25;
+/// Number of objects in the blocks passed to parse jobs
+const unsigned int JSON_PARSE_BLOCK_OBJECTS=10000;
+
 JSONImporterTask::JSONImporterTask(const std::string& class_id, const std::string& instance_id,
                                    TaskManager* task_manager)
     : Configurable (class_id, instance_id, task_manager)
 {
     registerParameter("current_filename", &current_filename_, "");
     registerParameter("current_schema", &current_schema_, "");
+    registerParameter("parse_backend", &parse_backend_, static_cast<unsigned int>(ParseBackend::DOM));
 
     createSubConfigurables();
 }
@@ -178,6 +186,17 @@ void JSONImporterTask::currentSchemaName(const std::string &current_schema)
     current_schema_ = current_schema;
 }
 
+JSONImporterTask::ParseBackend JSONImporterTask::parseBackend() const
+{
+    return static_cast<ParseBackend> (parse_backend_);
+}
+
+void JSONImporterTask::parseBackend(ParseBackend backend)
+{
+    loginf << "JSONImporterTask: parseBackend: " << static_cast<unsigned int> (backend);
+    parse_backend_ = static_cast<unsigned int> (backend);
+}
+
 bool JSONImporterTask::canImportFile (const std::string& filename)
 {
     if (!Files::fileExists(filename))
@@ -233,12 +252,34 @@ void JSONImporterTask::importFile(const std::string& filename, bool test)
 
     start_time_ = boost::posix_time::microsec_clock::local_time();
 
-    read_json_job_ = std::shared_ptr<ReadJSONFilePartJob> (new ReadJSONFilePartJob (filename, false, 10000));
-    connect (read_json_job_.get(), SIGNAL(obsoleteSignal()), this, SLOT(readJSONFilePartObsoleteSlot()),
-             Qt::QueuedConnection);
-    connect (read_json_job_.get(), SIGNAL(doneSignal()), this, SLOT(readJSONFilePartDoneSlot()), Qt::QueuedConnection);
+    bytes_read_ = 0;
+    read_status_percent_ = 0.0;
 
-    JobManager::instance().addNonBlockingJob(read_json_job_);
+    // throws if file can not be read, so before bulk import is started
+    read_range_offsets_ = ReadJSONFileRangeJob::rangeOffsets(filename, JSON_READ_RANGE_SIZE);
+    next_read_range_ = 0;
+
+    if (!test_)
+        ATSDB::instance().interface().startBulkImport();
+
+    if (read_range_offsets_.size() > 2) // several ranges, split concurrently
+    {
+        loginf << "JSONImporterTask: importFile: reading " << read_range_offsets_.size()-1 << " ranges";
+
+        bytes_to_read_ = read_range_offsets_.back();
+        startReadJSONFileRangeJobs();
+    }
+    else
+    {
+        read_json_job_ = std::shared_ptr<ReadJSONFilePartJob> (
+                    new ReadJSONFilePartJob (filename, false, JSON_PARSE_BLOCK_OBJECTS));
+        connect (read_json_job_.get(), SIGNAL(obsoleteSignal()), this, SLOT(readJSONFilePartObsoleteSlot()),
+                 Qt::QueuedConnection);
+        connect (read_json_job_.get(), SIGNAL(doneSignal()), this, SLOT(readJSONFilePartDoneSlot()),
+                 Qt::QueuedConnection);
+
+        JobManager::instance().addNonBlockingJob(read_json_job_, JobPriority::LOAD);
+    }
 
     updateMsgBox();
 
@@ -276,12 +317,16 @@ void JSONImporterTask::importFileArchive (const std::string& filename, bool test
 
     start_time_ = boost::posix_time::microsec_clock::local_time();
 
-    read_json_job_ = std::shared_ptr<ReadJSONFilePartJob> (new ReadJSONFilePartJob (filename, true, 10000));
+    if (!test_)
+        ATSDB::instance().interface().startBulkImport();
+
+    read_json_job_ = std::shared_ptr<ReadJSONFilePartJob> (new ReadJSONFilePartJob (filename, true,
+                                                                                          JSON_PARSE_BLOCK_OBJECTS));
     connect (read_json_job_.get(), SIGNAL(obsoleteSignal()), this, SLOT(readJSONFilePartObsoleteSlot()),
              Qt::QueuedConnection);
     connect (read_json_job_.get(), SIGNAL(doneSignal()), this, SLOT(readJSONFilePartDoneSlot()), Qt::QueuedConnection);
 
-    JobManager::instance().addNonBlockingJob(read_json_job_);
+    JobManager::instance().addNonBlockingJob(read_json_job_, JobPriority::LOAD);
 
     updateMsgBox();
 
@@ -297,13 +342,13 @@ void JSONImporterTask::readJSONFilePartDoneSlot ()
     assert (read_json_job_);
 
     loginf << "JSONImporterTask: readJSONFilePartDoneSlot: moving objects";
-    std::vector <std::string> objects = read_json_job_->objects();
-    //assert (!read_json_job_->objects().size());
+    std::shared_ptr<JSONObjectBlock> objects = read_json_job_->objects();
+    assert (objects);
 
     bytes_read_ = read_json_job_->bytesRead();
     bytes_to_read_ = read_json_job_->bytesToRead();
     read_status_percent_ = read_json_job_->getStatusPercent();
-    objects_read_ += objects.size();
+    objects_read_ += objects->size();
     loginf << "JSONImporterTask: readJSONFilePartDoneSlot: bytes " << bytes_read_ << " to read " << bytes_to_read_
            << " percent " << read_status_percent_;
 
@@ -314,66 +359,182 @@ void JSONImporterTask::readJSONFilePartDoneSlot ()
     {
         loginf << "JSONImporterTask: readJSONFilePartDoneSlot: read continue";
         read_json_job_->resetDone();
-        JobManager::instance().addNonBlockingJob(read_json_job_);
+        JobManager::instance().addNonBlockingJob(read_json_job_, JobPriority::LOAD);
     }
     else
         read_json_job_ = nullptr;
 
     // start parse job
     loginf << "JSONImporterTask: readJSONFilePartDoneSlot: starting parse job";
+    startParseJob(std::move(objects));
+
+    loginf << "JSONImporterTask: readJSONFilePartDoneSlot: updating message box";
+    updateMsgBox();
+
+    logdbg << "JSONImporterTask: readJSONFilePartDoneSlot: done";
+}
+
+void JSONImporterTask::readJSONFilePartObsoleteSlot ()
+{
+    logdbg << "JSONImporterTask: readJSONFilePartObsoleteSlot";
+}
+
+void JSONImporterTask::readJSONFileRangeDoneSlot ()
+{
+    logdbg << "JSONImporterTask: readJSONFileRangeDoneSlot";
+
+    // take ranges in file order, so that blocks are parsed and keys assigned as by a sequential read
+    while (read_json_range_jobs_.size() && read_json_range_jobs_.front()->done())
+    {
+        std::shared_ptr<ReadJSONFileRangeJob> range_job = read_json_range_jobs_.front();
+        read_json_range_jobs_.pop_front();
+
+        for (auto& block_it : range_job->blocks())
+        {
+            objects_read_ += block_it->size();
+            startParseJob(std::move(block_it));
+        }
+
+        range_job->blocks().clear();
+
+        bytes_read_ = range_job->fromOffset()+range_job->bytesRead();
+        read_status_percent_ = 100.0*static_cast<double>(bytes_read_)/static_cast<double>(bytes_to_read_);
+
+        if (!range_job->endsAtTopLevel())
+        {
+            // next range does not start at an object, discard following ones and continue sequentially
+            loginf << "JSONImporterTask: readJSONFileRangeDoneSlot: range ending at " << range_job->toOffset()
+                   << " ends inside of object, reading rest of file sequentially";
+
+            for (auto& job_it : read_json_range_jobs_)
+            {
+                disconnect (job_it.get(), 0, this, 0);
+                job_it->setObsolete();
+            }
+
+            read_json_range_jobs_.clear();
+            next_read_range_ = read_range_offsets_.size()-1;
+
+            read_json_job_ = std::shared_ptr<ReadJSONFilePartJob> (
+                        new ReadJSONFilePartJob (filename_, false, JSON_PARSE_BLOCK_OBJECTS));
+            read_json_job_->continueAt(range_job->toOffset(), std::move(range_job->splitter()));
+
+            connect (read_json_job_.get(), SIGNAL(obsoleteSignal()), this, SLOT(readJSONFilePartObsoleteSlot()),
+                     Qt::QueuedConnection);
+            connect (read_json_job_.get(), SIGNAL(doneSignal()), this, SLOT(readJSONFilePartDoneSlot()),
+                     Qt::QueuedConnection);
+
+            JobManager::instance().addNonBlockingJob(read_json_job_, JobPriority::LOAD);
+            break;
+        }
+    }
+
+    startReadJSONFileRangeJobs();
+
+    updateMsgBox();
+
+    logdbg << "JSONImporterTask: readJSONFileRangeDoneSlot: done";
+}
+
+void JSONImporterTask::startReadJSONFileRangeJobs ()
+{
+    // limits memory of read but not parsed text to number of threads times range size
+    size_t max_pending = std::max (QThread::idealThreadCount(), 1);
+
+    while (next_read_range_+1 < read_range_offsets_.size() && read_json_range_jobs_.size() < max_pending)
+    {
+        std::shared_ptr<ReadJSONFileRangeJob> range_job = std::shared_ptr<ReadJSONFileRangeJob> (
+                    new ReadJSONFileRangeJob (filename_, read_range_offsets_.at(next_read_range_),
+                                              read_range_offsets_.at(next_read_range_+1), JSON_PARSE_BLOCK_OBJECTS));
+        connect (range_job.get(), SIGNAL(doneSignal()), this, SLOT(readJSONFileRangeDoneSlot()),
+                 Qt::QueuedConnection);
+
+        JobManager::instance().addJob(range_job, JobPriority::LOAD);
+
+        read_json_range_jobs_.push_back(range_job);
+        ++next_read_range_;
+    }
+}
+
+void JSONImporterTask::startParseJob (std::shared_ptr<JSONObjectBlock> objects)
+{
+    assert (objects);
+
+    if (parseBackend() == ParseBackend::EXTRACTION) // parsed while mapping
+    {
+        assert (schemas_.count(current_schema_));
+
+        size_t count = objects->size();
+
+        std::shared_ptr<JSONMappingJob> json_map_job = std::shared_ptr<JSONMappingJob> (
+                    new JSONMappingJob (objects, schemas_.at(current_schema_).parsers(), key_count_));
+        connect (json_map_job.get(), SIGNAL(obsoleteSignal()), this, SLOT(mapJSONObsoleteSlot()),
+                 Qt::QueuedConnection);
+        connect (json_map_job.get(), SIGNAL(doneSignal()), this, SLOT(mapJSONDoneSlot()), Qt::QueuedConnection);
+
+        json_map_jobs_.push_back(json_map_job);
+
+        JobManager::instance().addJob(json_map_job, JobPriority::LOAD);
+
+        key_count_ += count; // including objects with parse errors
+        return;
+    }
+
     std::shared_ptr<JSONParseJob> json_parse_job = std::shared_ptr<JSONParseJob> (
-                new JSONParseJob (std::move(objects)));
+                new JSONParseJob (objects, parseBackend() == ParseBackend::TAPE));
     connect (json_parse_job.get(), SIGNAL(obsoleteSignal()), this, SLOT(parseJSONObsoleteSlot()),
              Qt::QueuedConnection);
     connect (json_parse_job.get(), SIGNAL(doneSignal()), this, SLOT(parseJSONDoneSlot()),
              Qt::QueuedConnection);
 
-    JobManager::instance().addJob(json_parse_job);
+    JobManager::instance().addJob(json_parse_job, JobPriority::LOAD);
 
     json_parse_jobs_.push_back(json_parse_job);
-
-    loginf << "JSONImporterTask: readJSONFilePartDoneSlot: updating message box";
-    updateMsgBox();
-
-    logdbg << "JSONImporterTask: readJSONFilePartDoneSlot: done";
 }
 
-void JSONImporterTask::readJSONFilePartObsoleteSlot ()
+bool JSONImporterTask::readJSONFileDone ()
 {
-    logdbg << "JSONImporterTask: readJSONFilePartObsoleteSlot";
+    return read_json_job_ == nullptr && read_json_range_jobs_.empty();
 }
 
 void JSONImporterTask::parseJSONDoneSlot ()
 {
     logdbg << "JSONImporterTask: parseJSONDoneSlot";
 
-    JSONParseJob* parse_job = dynamic_cast<JSONParseJob*>(QObject::sender());
-    assert (parse_job);
-
-    objects_parsed_ += parse_job->objectsParsed();
-    objects_parse_errors_ += parse_job->parseErrors();
-    std::vector<json> json_objects = std::move(parse_job->jsonObjects());
+    assert (schemas_.count(current_schema_));
 
-    json_parse_jobs_.erase(json_parse_jobs_.begin());
+    // take results in order of start, so that keys are assigned deterministically
+    while (json_parse_jobs_.size() && json_parse_jobs_.front()->done())
+    {
+        std::shared_ptr<JSONParseJob> parse_job = json_parse_jobs_.front();
+        json_parse_jobs_.erase(json_parse_jobs_.begin());
 
-    logdbg << "JSONImporterTask: parseJSONDoneSlot: " << json_objects.size() << " parsed objects";
+        objects_parsed_ += parse_job->objectsParsed();
+        objects_parse_errors_ += parse_job->parseErrors();
 
-    size_t count = json_objects.size();
+        size_t count = parse_job->objectsParsed();
+        std::shared_ptr<JSONMappingJob> json_map_job;
 
-    assert (schemas_.count(current_schema_));
+        logdbg << "JSONImporterTask: parseJSONDoneSlot: " << count << " parsed objects";
 
-    std::shared_ptr<JSONMappingJob> json_map_job =
-            std::shared_ptr<JSONMappingJob> (new JSONMappingJob (std::move(json_objects),
-                                                                 schemas_.at(current_schema_).parsers(), key_count_));
-    connect (json_map_job.get(), SIGNAL(obsoleteSignal()), this, SLOT(mapJSONObsoleteSlot()),
-             Qt::QueuedConnection);
-    connect (json_map_job.get(), SIGNAL(doneSignal()), this, SLOT(mapJSONDoneSlot()), Qt::QueuedConnection);
+        if (parse_job->useTape())
+            json_map_job = std::shared_ptr<JSONMappingJob> (
+                        new JSONMappingJob (parse_job->objects(), std::move(parse_job->tape()),
+                                            schemas_.at(current_schema_).parsers(), key_count_));
+        else
+            json_map_job = std::shared_ptr<JSONMappingJob> (
+                        new JSONMappingJob (std::move(parse_job->jsonObjects()),
+                                            schemas_.at(current_schema_).parsers(), key_count_));
+        connect (json_map_job.get(), SIGNAL(obsoleteSignal()), this, SLOT(mapJSONObsoleteSlot()),
+                 Qt::QueuedConnection);
+        connect (json_map_job.get(), SIGNAL(doneSignal()), this, SLOT(mapJSONDoneSlot()), Qt::QueuedConnection);
 
-    json_map_jobs_.push_back(json_map_job);
+        json_map_jobs_.push_back(json_map_job);
 
-    JobManager::instance().addJob(json_map_job);
+        JobManager::instance().addJob(json_map_job, JobPriority::LOAD);
 
-    key_count_ += count;
+        key_count_ += count;
+    }
 
     updateMsgBox();
 
@@ -395,6 +556,9 @@ void JSONImporterTask::mapJSONDoneSlot ()
     loginf << "JSONImporterTask: mapJSONDoneSlot: skipped " << map_job->numNotMapped()
            << " all skipped " << objects_not_mapped_;
 
+    objects_parsed_ += map_job->numParsed();
+    objects_parse_errors_ += map_job->numParseErrors();
+
     objects_mapped_ += map_job->numMapped();
     objects_not_mapped_ += map_job->numNotMapped();
 
@@ -434,7 +598,9 @@ void JSONImporterTask::mapJSONDoneSlot ()
     {
         for (auto& buf_it : buffers_)
         {
-            if (buf_it.second->size() > 10000)
+            // insert in batches of bulk commit size
+            if (buf_it.second->size()*buf_it.second->properties().rowSizeInBytes()
+                    >= ATSDB::instance().interface().bulkCommitBytes())
             {
                 loginf << "JSONImporterTask: mapJSONDoneSlot: inserting part of parsed objects";
                 insertData ();
@@ -443,7 +609,7 @@ void JSONImporterTask::mapJSONDoneSlot ()
         }
     }
 
-    if (read_json_job_ == nullptr && json_parse_jobs_.size() == 0 && json_map_jobs_.size() == 0)
+    if (readJSONFileDone() && json_parse_jobs_.size() == 0 && json_map_jobs_.size() == 0)
     {
         loginf << "JSONImporterTask: mapJSONDoneSlot: inserting parsed objects at end";
         insertData ();
@@ -468,7 +634,7 @@ void JSONImporterTask::insertData ()
     }
 
     bool has_sac_sic = false;
-    bool emit_change = (read_json_job_ == nullptr && json_parse_jobs_.size() == 0 && json_map_jobs_.size() == 0);
+    bool emit_change = (readJSONFileDone() && json_parse_jobs_.size() == 0 && json_map_jobs_.size() == 0);
 
     assert (schemas_.count(current_schema_));
 
@@ -593,25 +759,57 @@ void JSONImporterTask::checkAllDone ()
 {
     logdbg << "JSONImporterTask: checkAllDone";
 
-    if (!all_done_ && read_json_job_ == nullptr && json_parse_jobs_.size() == 0 && json_map_jobs_.size() == 0
-            && insert_active_ == 0)
+    if (!all_done_ && !end_bulk_import_job_ && readJSONFileDone() && json_parse_jobs_.size() == 0
+            && json_map_jobs_.size() == 0 && insert_active_ == 0)
     {
-        stop_time_ = boost::posix_time::microsec_clock::local_time();
+        if (test_)
+            importDone();
+        else
+        {
+            loginf << "JSONImporterTask: checkAllDone: inserts done, ending bulk import";
+
+            // index rebuild takes long, not done in the GUI thread
+            end_bulk_import_job_ = std::make_shared<EndBulkImportDBJob> (ATSDB::instance().interface());
+            connect (end_bulk_import_job_.get(), SIGNAL(doneSignal()), this, SLOT(endBulkImportDoneSlot()),
+                     Qt::QueuedConnection);
 
-        boost::posix_time::time_duration diff = stop_time_ - start_time_;
+            JobManager::instance().addDBJob(end_bulk_import_job_, JobPriority::LOAD);
+        }
+    }
 
-        std::string time_str = std::to_string(diff.hours())+"h "+std::to_string(diff.minutes())
-                +"m "+std::to_string(diff.seconds())+"s";
+    logdbg << "JSONImporterTask: checkAllDone: done";
+}
 
-        loginf << "JSONImporterTask: checkAllDone: read done after " << time_str;
+void JSONImporterTask::endBulkImportDoneSlot ()
+{
+    loginf << "JSONImporterTask: endBulkImportDoneSlot";
 
-        all_done_ = true;
+    assert (end_bulk_import_job_);
 
-        if (widget_)
-            widget_->importDoneSlot(test_);
-    }
+    if (end_bulk_import_job_->failed())
+        logerr << "JSONImporterTask: endBulkImportDoneSlot: rebuilding indexes failed";
 
-    logdbg << "JSONImporterTask: checkAllDone: done";
+    end_bulk_import_job_ = nullptr;
+
+    importDone();
+    updateMsgBox();
+}
+
+void JSONImporterTask::importDone ()
+{
+    stop_time_ = boost::posix_time::microsec_clock::local_time();
+
+    boost::posix_time::time_duration diff = stop_time_ - start_time_;
+
+    std::string time_str = std::to_string(diff.hours())+"h "+std::to_string(diff.minutes())
+            +"m "+std::to_string(diff.seconds())+"s";
+
+    loginf << "JSONImporterTask: importDone: done after " << time_str;
+
+    all_done_ = true;
+
+    if (widget_)
+        widget_->importDoneSlot(test_);
 }
 
 void JSONImporterTask::updateMsgBox ()
@@ -713,6 +911,9 @@ void JSONImporterTask::updateMsgBox ()
     if (!all_done_ && remaining_time_str_.size())
         msg += "\nEstimated remaining time: "+remaining_time_str_;
 
+    if (end_bulk_import_job_)
+        msg += "\n\nCreating indexes and statistics";
+
     msg_box_->setText(msg.c_str());
 
     if (all_done_)
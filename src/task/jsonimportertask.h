@@ -22,9 +22,11 @@
 #include "json.hpp"
 #include "jsonparsingschema.h"
 #include "readjsonfilepartjob.h"
+#include "readjsonfilerangejob.h"
 
 #include <QObject>
 
+#include <deque>
 #include <memory>
 
 #include "boost/date_time/posix_time/posix_time.hpp"
@@ -35,6 +37,7 @@ class SavedFile;
 class QMessageBox;
 class JSONParseJob;
 class JSONMappingJob;
+class EndBulkImportDBJob;
 
 class JSONImporterTask : public QObject, public Configurable
 {
@@ -42,6 +45,9 @@ class JSONImporterTask : public QObject, public Configurable
 
     using JSONParsingSchemaIterator = std::map<std::string, JSONParsingSchema>::iterator;
 
+public:
+    enum class ParseBackend { DOM=0, TAPE, EXTRACTION };
+
 public slots:
     void insertProgressSlot (float percent);
     void insertDoneSlot (DBObject& object);
@@ -49,12 +55,16 @@ public slots:
     void readJSONFilePartDoneSlot ();
     void readJSONFilePartObsoleteSlot ();
 
+    void readJSONFileRangeDoneSlot ();
+
     void parseJSONDoneSlot ();
     void parseJSONObsoleteSlot ();
 
     void mapJSONDoneSlot ();
     void mapJSONObsoleteSlot ();
 
+    void endBulkImportDoneSlot ();
+
 public:
     JSONImporterTask(const std::string& class_id, const std::string& instance_id,
                      TaskManager* task_manager);
@@ -85,6 +95,10 @@ public:
     std::string currentSchemaName() const;
     void currentSchemaName(const std::string &currentSchema);
 
+    /// @brief Returns how objects are parsed: into nlohmann::json, into a JSONTape, or by JSONExtractionPlan
+    ParseBackend parseBackend() const;
+    void parseBackend(ParseBackend backend);
+
 protected:
     std::map <std::string, SavedFile*> file_list_;
     std::string current_filename_;
@@ -95,13 +109,24 @@ protected:
     std::map <std::string, JSONParsingSchema> schemas_;
     size_t key_count_ {0};
 
+    /// ParseBackend as number
+    unsigned int parse_backend_ {0};
+
     size_t insert_active_ {0};
 
     std::set <int> added_data_sources_;
 
     std::shared_ptr <ReadJSONFilePartJob> read_json_job_;
+    /// Start offsets of ranges of non-archive file read concurrently, followed by file size
+    std::vector<size_t> read_range_offsets_;
+    /// Index of next range to be read
+    size_t next_read_range_ {0};
+    /// Started range read jobs, in file order
+    std::deque<std::shared_ptr <ReadJSONFileRangeJob>> read_json_range_jobs_;
     std::vector<std::shared_ptr <JSONParseJob>> json_parse_jobs_;
     std::vector<std::shared_ptr <JSONMappingJob>> json_map_jobs_;
+    /// Job rebuilding indexes after all inserts, import is done when it is finished
+    std::shared_ptr <EndBulkImportDBJob> end_bulk_import_job_;
 
     std::string filename_;
     bool test_ {false};
@@ -135,7 +160,17 @@ protected:
 
     void insertData ();
 
+    /// @brief Starts range read jobs until the maximum number of pending ones is reached
+    void startReadJSONFileRangeJobs ();
+    /// @brief Starts parse job for block, results are taken in order of start
+    void startParseJob (std::shared_ptr<JSONObjectBlock> objects);
+    /// @brief Returns flag indicating if all file reading jobs are finished
+    bool readJSONFileDone ();
+
+    /// @brief Ends bulk import in a DB job or finishes import, if all jobs are done
     void checkAllDone ();
+    /// @brief Sets import done and notifies widget
+    void importDone ();
 
     void updateMsgBox ();
 
@@ -183,6 +183,20 @@ JSONImporterTaskWidget::JSONImporterTaskWidget(JSONImporterTask& task, QWidget*
     //    main_layout->addLayout(stuff_layout);
 
 
+    QHBoxLayout* parse_backend_layout = new QHBoxLayout();
+    parse_backend_layout->addWidget(new QLabel ("Parser"));
+
+    // in order of JSONImporterTask::ParseBackend
+    parse_backend_box_ = new QComboBox ();
+    parse_backend_box_->addItem("nlohmann::json");
+    parse_backend_box_->addItem("Tape");
+    parse_backend_box_->addItem("Extraction Plan");
+    parse_backend_box_->setCurrentIndex(static_cast<int> (task_.parseBackend()));
+    connect (parse_backend_box_, SIGNAL(currentIndexChanged(int)), this, SLOT(parseBackendChangedSlot(int)));
+    parse_backend_layout->addWidget(parse_backend_box_);
+
+    left_layout->addLayout(parse_backend_layout);
+
     test_button_ = new QPushButton ("Test Import");
     connect(test_button_, &QPushButton::clicked, this, &JSONImporterTaskWidget::testImportSlot);
     left_layout->addWidget(test_button_);
@@ -470,6 +484,12 @@ void JSONImporterTaskWidget::update ()
     loginf << "JSONImporterTaskWidget: update";
 }
 
+void JSONImporterTaskWidget::parseBackendChangedSlot (int index)
+{
+    assert (index >= 0);
+    task_.parseBackend(static_cast<JSONImporterTask::ParseBackend> (index));
+}
+
 void JSONImporterTaskWidget::testImportSlot ()
 {
     loginf << "JSONImporterTaskWidget: testImportSlot";
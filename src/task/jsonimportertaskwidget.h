@@ -55,6 +55,8 @@ public slots:
     void removeObjectParserSlot ();
     void selectedObjectParserSlot ();
 
+    void parseBackendChangedSlot (int index);
+
 public:
     JSONImporterTaskWidget(JSONImporterTask& task, QWidget* parent=0, Qt::WindowFlags f=0);
     virtual ~JSONImporterTaskWidget();
@@ -81,6 +83,8 @@ protected:
     QStackedWidget* object_parser_widget_ {nullptr};
     //QHBoxLayout* object_parser_layout_ {nullptr};
 
+    QComboBox* parse_backend_box_ {nullptr};
+
     QPushButton* test_button_ {nullptr};
     QPushButton* import_button_ {nullptr};
 
@@ -368,7 +368,7 @@ void RadarPlotPositionCalculatorTask::calculate ()
     read_set.add(*latitude_var_);
     read_set.add(*longitude_var_);
 
-    connect (db_object_, &DBObject::newDataSignal, this, &RadarPlotPositionCalculatorTask::newDataSlot);
+    connect (db_object_, &DBObject::loadingProgressSignal, this, &RadarPlotPositionCalculatorTask::newDataSlot);
     connect (db_object_, &DBObject::loadingDoneSignal, this, &RadarPlotPositionCalculatorTask::loadingDoneSlot);
 
     db_object_->load (read_set, false, false, nullptr, false); //"0,100000"
@@ -396,7 +396,7 @@ void RadarPlotPositionCalculatorTask::loadingDoneSlot (DBObject& object)
     if (calculated_) // TODO: done signal comes twice?
         return;
 
-    disconnect (db_object_, &DBObject::newDataSignal, this, &RadarPlotPositionCalculatorTask::newDataSlot);
+    disconnect (db_object_, &DBObject::loadingProgressSignal, this, &RadarPlotPositionCalculatorTask::newDataSlot);
     disconnect (db_object_, &DBObject::loadingDoneSignal, this, &RadarPlotPositionCalculatorTask::loadingDoneSlot);
 
     //
@@ -483,6 +483,16 @@ void RadarPlotPositionCalculatorTask::loadingDoneSlot (DBObject& object)
 
     size_t transformation_errors = 0;
 
+    NullableVector<int>& key_vec = read_buffer->get<int>(key_var_str_);
+    NullableVector<int>& datasource_vec = read_buffer->get<int>(datasource_var_str_);
+    NullableVector<double>& azimuth_vec = read_buffer->get<double>(azimuth_var_str_);
+    NullableVector<double>& range_vec = read_buffer->get<double>(range_var_str_);
+    NullableVector<int>& altitude_vec = read_buffer->get<int>(altitude_var_str_);
+
+    NullableVector<double>& update_latitude_vec = update_buffer->get<double>(latitude_var_str_);
+    NullableVector<double>& update_longitude_vec = update_buffer->get<double>(longitude_var_str_);
+    NullableVector<int>& update_key_vec = update_buffer->get<int>(key_var_str_);
+
     for (unsigned int cnt=0; cnt < read_size; cnt++)
     {
         if (cnt % 50000 == 0 && target_report_count_ != 0)
@@ -494,36 +504,35 @@ void RadarPlotPositionCalculatorTask::loadingDoneSlot (DBObject& object)
             QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
         }
 
-        if (read_buffer->get<int>(key_var_str_).isNull(cnt))
+        if (key_vec.isNull(cnt))
         {
             logerr << "RadarPlotPositionCalculatorTask: loadingDoneSlot: key null";
             continue;
         }
-        rec_num = read_buffer->get<int>(key_var_str_).get(cnt);
+        rec_num = key_vec.get(cnt);
 
-        if (read_buffer->get<int>(datasource_var_str_).isNull(cnt))
+        if (datasource_vec.isNull(cnt))
         {
             logerr << "RadarPlotPositionCalculatorTask: loadingDoneSlot: data source null";
             continue;
         }
-        sensor_id = read_buffer->get<int>(datasource_var_str_).get(cnt);
+        sensor_id = datasource_vec.get(cnt);
 
         //sac = *((unsigned char*)adresses->at(1));
         //sic = *((unsigned char*)adresses->at(2));
 
-        if (read_buffer->get<double>(azimuth_var_str_).isNull(cnt)
-                || read_buffer->get<double>(range_var_str_).isNull(cnt))
+        if (azimuth_vec.isNull(cnt) || range_vec.isNull(cnt))
         {
             logdbg << "RadarPlotPositionCalculatorTask: loadingDoneSlot: position null";
             continue;
         }
 
-        pos_azm_deg =  read_buffer->get<double>(azimuth_var_str_).get(cnt);
-        pos_range_nm =  read_buffer->get<double>(range_var_str_).get(cnt);
+        pos_azm_deg = azimuth_vec.get(cnt);
+        pos_range_nm = range_vec.get(cnt);
 
-        has_altitude = !read_buffer->get<int>(altitude_var_str_).isNull(cnt);
+        has_altitude = !altitude_vec.isNull(cnt);
         if (has_altitude)
-            altitude_ft = read_buffer->get<int>(altitude_var_str_).get(cnt);
+            altitude_ft = altitude_vec.get(cnt);
         else
             altitude_ft = 0.0; // has to assumed in projection later on
 
@@ -612,9 +621,9 @@ void RadarPlotPositionCalculatorTask::loadingDoneSlot (DBObject& object)
             continue;
         }
 
-        update_buffer->get<double>(latitude_var_str_).set(update_cnt, lat);
-        update_buffer->get<double>(longitude_var_str_).set(update_cnt, lon);
-        update_buffer->get<int>(key_var_str_).set(update_cnt, rec_num);
+        update_latitude_vec.set(update_cnt, lat);
+        update_longitude_vec.set(update_cnt, lon);
+        update_key_vec.set(update_cnt, rec_num);
         update_cnt++;
 
         //loginf << "uga cnt " << update_cnt << " rec_num " << rec_num << " lat " << lat << " long " << lon;
@@ -32,15 +32,14 @@ BufferTableModel::BufferTableModel(QObject *parent, DBObject &object, ListBoxVie
 
 BufferTableModel::~BufferTableModel()
 {
-    buffer_ = nullptr;
 }
 
 int BufferTableModel::rowCount(const QModelIndex & /*parent*/) const
 {
-    if (buffer_)
+    if (buffer_.buffer())
     {
-        logdbg << "BufferTableModel: rowCount: " << buffer_->size();
-        return buffer_->size();
+        logdbg << "BufferTableModel: rowCount: " << buffer_.size();
+        return buffer_.size();
     }
     else
     {
@@ -91,7 +90,7 @@ QVariant BufferTableModel::data(const QModelIndex &index, int role) const
     logdbg << "BufferTableModel: data: row " << index.row()-1 << " col " << index.column()-1;
     if (role == Qt::DisplayRole)
     {
-        assert (buffer_);
+        assert (buffer_.buffer());
 
         bool null=false;
         std::string value_str;
@@ -99,154 +98,32 @@ QVariant BufferTableModel::data(const QModelIndex &index, int role) const
         unsigned int row = index.row(); // indexes start at 0 in this family
         unsigned int col = index.column();
 
-        const PropertyList &properties = buffer_->properties();
-
-        assert (row < buffer_->size());
+        assert (row < buffer_.size());
+        row += buffer_.fromIndex();
         assert (col < read_set_.getSize());
+        assert (col < columns_.size());
 
         DBOVariable& variable = read_set_.getVariable(col);
-        PropertyDataType data_type = variable.dataType();
+        const ColumnHandle& column = columns_.at(col);
 
         value_str = NULL_STRING;
 
-        //const DBTableColumn &column = variable.currentDBColumn ();
-
-        if (!properties.hasProperty(variable.name()))
+        if (!column.valid())
         {
             logdbg << "BufferTableModel: data: variable " << variable.name() << " not present in buffer";
         }
         else
         {
-            std::string property_name = variable.name();
+            assert (column.dataType() == variable.dataType());
 
-            if (data_type == PropertyDataType::BOOL)
-            {
-                assert (buffer_->has<bool>(property_name));
-                null = buffer_->get<bool>(property_name).isNull(row);
-                if (!null)
-                {
-                    if (use_presentation_)
-                        value_str = variable.getRepresentationStringFromValue(
-                                    buffer_->get<bool>(property_name).getAsString(row));
-                    else
-                        value_str = buffer_->get<bool>(property_name).getAsString(row);
-                }
-            }
-            else if (data_type == PropertyDataType::CHAR)
-            {
-                assert (buffer_->has<char>(property_name));
-                null = buffer_->get<char>(property_name).isNull(row);
-                if (!null)
-                {
-                    if (use_presentation_)
-                        value_str = variable.getRepresentationStringFromValue(
-                                    buffer_->get<char>(property_name).getAsString(row));
-                    else
-                        value_str = buffer_->get<char>(property_name).getAsString(row);
-                }
-            }
-            else if (data_type == PropertyDataType::UCHAR)
-            {
-                assert (buffer_->has<unsigned char>(property_name));
-                null = buffer_->get<unsigned char>(property_name).isNull(row);
-                if (!null)
-                {
-                    if (use_presentation_)
-                        value_str = variable.getRepresentationStringFromValue(
-                                    buffer_->get<unsigned char>(property_name).getAsString(row));
-                    else
-                        value_str = buffer_->get<unsigned char>(property_name).getAsString(row);
-                }
-            }
-            else if (data_type == PropertyDataType::INT)
-            {
-                assert (buffer_->has<int>(property_name));
-                null = buffer_->get<int>(property_name).isNull(row);
-                if (!null)
-                {
-                    if (use_presentation_)
-                        value_str = variable.getRepresentationStringFromValue(
-                                    buffer_->get<int>(property_name).getAsString(row));
-                    else
-                        value_str = buffer_->get<int>(property_name).getAsString(row);
-                }
-            }
-            else if (data_type == PropertyDataType::UINT)
-            {
-                assert (buffer_->has<unsigned int>(property_name));
-                null = buffer_->get<unsigned int>(properties.at(col).name()).isNull(row);
-                if (!null)
-                {
-                    if (use_presentation_)
-                        value_str = variable.getRepresentationStringFromValue(
-                                    buffer_->get<unsigned int>(property_name).getAsString(row));
-                    else
-                        value_str = buffer_->get<unsigned int>(property_name).getAsString(row);
-                }
-            }
-            else if (data_type == PropertyDataType::LONGINT)
-            {
-                assert (buffer_->has<long int>(property_name));
-                null = buffer_->get<long int>(property_name).isNull(row);
-                if (!null)
-                {
-                    if (use_presentation_)
-                        value_str = variable.getRepresentationStringFromValue(
-                                    buffer_->get<long int>(property_name).getAsString(row));
-                    else
-                        value_str = buffer_->get<long int>(property_name).getAsString(row);
-                }
-            }
-            else if (data_type == PropertyDataType::ULONGINT)
+            null = column.isNull(row);
+            if (!null)
             {
-                assert (buffer_->has<unsigned long int>(property_name));
-                null = buffer_->get<unsigned long int>(property_name).isNull(row);
-                if (!null)
-                {
-                    if (use_presentation_)
-                        value_str = variable.getRepresentationStringFromValue(
-                                    buffer_->get<unsigned long int>(property_name).getAsString(row));
-                    else
-                        value_str = buffer_->get<unsigned long int>(property_name).getAsString(row);
-                }
+                if (use_presentation_ && column.dataType() != PropertyDataType::STRING)
+                    value_str = variable.getRepresentationStringFromValue(column.getAsString(row));
+                else
+                    value_str = column.getAsString(row);
             }
-            else if (data_type == PropertyDataType::FLOAT)
-            {
-                assert (buffer_->has<float>(property_name));
-                null = buffer_->get<float>(property_name).isNull(row);
-                if (!null)
-                {
-                    if (use_presentation_)
-                        value_str = variable.getRepresentationStringFromValue(
-                                    buffer_->get<float>(property_name).getAsString(row));
-                    else
-                        value_str = buffer_->get<float>(property_name).getAsString(row);
-                }
-            }
-            else if (data_type == PropertyDataType::DOUBLE)
-            {
-                assert (buffer_->has<double>(property_name));
-                null = buffer_->get<double>(property_name).isNull(row);
-                if (!null)
-                {
-                    if (use_presentation_)
-                        value_str = variable.getRepresentationStringFromValue(
-                                    buffer_->get<double>(property_name).getAsString(row));
-                    else
-                        value_str = buffer_->get<double>(property_name).getAsString(row);
-                }
-            }
-            else if (data_type == PropertyDataType::STRING)
-            {
-                assert (buffer_->has<std::string>(property_name));
-                null = buffer_->get<std::string>(property_name).isNull(row);
-                if (!null)
-                {
-                    value_str = buffer_->get<std::string>(property_name).getAsString(row);
-                }
-            }
-            else
-                throw std::domain_error ("BufferTableWidget: show: unknown property data type");
 
             if (null)
                 return QVariant();
@@ -261,7 +138,8 @@ void BufferTableModel::clearData ()
 {
     beginResetModel();
 
-    buffer_=nullptr;
+    buffer_ = BufferView();
+    columns_.clear();
 
     endResetModel();
 
@@ -272,9 +150,21 @@ void BufferTableModel::setData (std::shared_ptr <Buffer> buffer)
     assert (buffer);
     beginResetModel();
 
-    buffer_=buffer;
+    buffer_ = BufferView(buffer);
     read_set_ = data_source_.getSet()->getFor(object_.name());
 
+    columns_.clear();
+
+    for (unsigned int cnt=0; cnt < read_set_.getSize(); ++cnt)
+    {
+        DBOVariable& variable = read_set_.getVariable(cnt);
+
+        if (buffer_.hasProperty(variable.name()))
+            columns_.push_back(buffer_.column(variable.name()));
+        else
+            columns_.push_back(ColumnHandle());
+    }
+
     endResetModel();
 }
 
@@ -282,7 +172,7 @@ void BufferTableModel::saveAsCSV (const std::string &file_name, bool overwrite)
 {
     loginf << "BufferTableModel: saveAsCSV: into filename " << file_name << " overwrite " << overwrite;
 
-    assert (buffer_);
+    assert (buffer_.buffer());
     BufferCSVExportJob *export_job = new BufferCSVExportJob (buffer_, read_set_, file_name, overwrite,
                                                              use_presentation_);
 
@@ -290,7 +180,7 @@ void BufferTableModel::saveAsCSV (const std::string &file_name, bool overwrite)
     connect (export_job, SIGNAL(obsoleteSignal()), this, SLOT(exportJobObsoleteSlot()), Qt::QueuedConnection);
     connect (export_job, SIGNAL(doneSignal()), this, SLOT(exportJobDoneSlot()), Qt::QueuedConnection);
 
-    JobManager::instance().addJob(export_job_);
+    JobManager::instance().addJob(export_job_, JobPriority::EXPORT);
 }
 
 void BufferTableModel::exportJobObsoleteSlot ()
@@ -19,12 +19,12 @@
 #define BUFFERTABLEMODEL_H
 
 #include "dbovariableset.h"
+#include "bufferview.h"
 
 #include <memory>
 
 #include <QAbstractTableModel>
 
-class Buffer;
 class DBObject;
 class BufferCSVExportJob;
 class ListBoxViewDataSource;
@@ -60,8 +60,10 @@ protected:
     DBObject& object_;
     ListBoxViewDataSource& data_source_;
 
-    std::shared_ptr <Buffer> buffer_;
+    BufferView buffer_;
     DBOVariableSet read_set_;
+    /// Column handles for the variables in read_set_, invalid if not present in buffer_
+    std::vector<ColumnHandle> columns_;
 
     std::shared_ptr <BufferCSVExportJob> export_job_;
 